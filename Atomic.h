@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Atomic.h
+ *
+ *  @brief      Lock-free primitives for the Cortex-M3 core of the CC1310.
+ *
+ *  The Cortex-M3 has no atomic read-modify-write instructions, but it does
+ *  implement the LDREX/STREX exclusive monitor. Every exception entry and
+ *  return clears the local monitor, so an interrupted LDREX/STREX sequence
+ *  simply fails its STREX and is retried. This makes the helpers below safe
+ *  to use from Task, Swi and Hwi context without disabling interrupts.
+ *
+ *  @code
+ *  #include "Atomic.h"
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __ATOMIC_H__
+#define __ATOMIC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__IAR_SYSTEMS_ICC__)
+#include <intrinsics.h>
+#endif
+
+/*!
+ *  @brief  Data memory barrier
+ *
+ *  Orders all explicit memory accesses before the barrier ahead of those
+ *  after it. Also acts as a compiler barrier.
+ */
+static inline void Atomic_dmb(void)
+{
+#if defined(__TI_COMPILER_VERSION__)
+    __asm("    dmb");
+#elif defined(__IAR_SYSTEMS_ICC__)
+    __DMB();
+#elif defined(__GNUC__)
+    __asm volatile ("dmb" ::: "memory");
+#endif
+}
+
+/*!
+ *  @brief  Load-exclusive of a 32-bit word
+ */
+static inline uint32_t Atomic_ldrex(volatile uint32_t *addr)
+{
+#if defined(__TI_COMPILER_VERSION__)
+    return ((uint32_t)__ldrex((void *)addr));
+#elif defined(__IAR_SYSTEMS_ICC__)
+    return (__LDREX((unsigned long *)addr));
+#elif defined(__GNUC__)
+    uint32_t value;
+
+    __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (addr) : "memory");
+
+    return (value);
+#endif
+}
+
+/*!
+ *  @brief  Store-exclusive of a 32-bit word
+ *
+ *  @return 0 if the store succeeded, 1 if the reservation was lost.
+ */
+static inline uint32_t Atomic_strex(volatile uint32_t *addr, uint32_t value)
+{
+#if defined(__TI_COMPILER_VERSION__)
+    return ((uint32_t)__strex(value, (void *)addr));
+#elif defined(__IAR_SYSTEMS_ICC__)
+    return (__STREX(value, (unsigned long *)addr));
+#elif defined(__GNUC__)
+    uint32_t result;
+
+    __asm volatile ("strex %0, %2, [%1]"
+                    : "=&r" (result) : "r" (addr), "r" (value) : "memory");
+
+    return (result);
+#endif
+}
+
+/*!
+ *  @brief  Drop an outstanding exclusive reservation
+ */
+static inline void Atomic_clrex(void)
+{
+#if defined(__TI_COMPILER_VERSION__)
+    __clrex();
+#elif defined(__IAR_SYSTEMS_ICC__)
+    __CLREX();
+#elif defined(__GNUC__)
+    __asm volatile ("clrex" ::: "memory");
+#endif
+}
+
+/*!
+ *  @brief  Compare-and-swap a 32-bit word
+ *
+ *  Stores @p desired at @p addr only if it currently holds @p expected.
+ *
+ *  @return true if the swap took place.
+ */
+static inline bool Atomic_cas32(volatile uint32_t *addr, uint32_t expected,
+                                uint32_t desired)
+{
+    do {
+        if (Atomic_ldrex(addr) != expected) {
+            Atomic_clrex();
+            return (false);
+        }
+    } while (Atomic_strex(addr, desired) != 0);
+
+    Atomic_dmb();
+
+    return (true);
+}
+
+/*!
+ *  @brief  Atomically add to a 32-bit word
+ *
+ *  @return The new value.
+ */
+static inline uint32_t Atomic_add32(volatile uint32_t *addr, uint32_t delta)
+{
+    uint32_t value;
+
+    do {
+        value = Atomic_ldrex(addr) + delta;
+    } while (Atomic_strex(addr, value) != 0);
+
+    return (value);
+}
+
+/*!
+ *  @brief  Atomically raise a 32-bit word to at least @p value
+ *
+ *  Used for high-water marks that are updated from several contexts.
+ */
+static inline void Atomic_max32(volatile uint32_t *addr, uint32_t value)
+{
+    do {
+        if (Atomic_ldrex(addr) >= value) {
+            Atomic_clrex();
+            return;
+        }
+    } while (Atomic_strex(addr, value) != 0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ATOMIC_H__ */
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== BlockPool.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "BlockPool.h"
+
+/*
+ *  ======== BlockPool_construct ========
+ */
+bool BlockPool_construct(BlockPool_Object *pool,
+                         BlockPool_Class const *classes,
+                         uint_least8_t classCount)
+{
+    BlockPool_ClassState *state;
+    uint8_t              *block;
+    unsigned int          i;
+    unsigned int          j;
+
+    if ((classCount == 0) || (classCount > BlockPool_MAX_CLASSES)) {
+        return (false);
+    }
+    for (i = 0; i < classCount; i++) {
+        if ((classes[i].blockSize == 0) || (classes[i].blockSize % 8 != 0) ||
+            ((i > 0) && (classes[i].blockSize <= classes[i - 1].blockSize))) {
+            return (false);
+        }
+    }
+
+    memset(pool, 0, sizeof(BlockPool_Object));
+    pool->classCount = classCount;
+
+    for (i = 0; i < classCount; i++) {
+        state = &pool->classes[i];
+        state->start = (uint8_t *)classes[i].storage;
+        state->end   = state->start +
+            (size_t)classes[i].blockSize * classes[i].blockCount;
+
+        /* Chain the blocks in address order */
+        state->head = NULL;
+        for (j = classes[i].blockCount; j-- > 0;) {
+            block = state->start + (size_t)j * classes[i].blockSize;
+            *(void **)block = state->head;
+            state->head = block;
+        }
+
+        state->stats.blockSize  = classes[i].blockSize;
+        state->stats.blockCount = classes[i].blockCount;
+        state->stats.free       = classes[i].blockCount;
+        state->stats.minFree    = classes[i].blockCount;
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== BlockPool_alloc ========
+ */
+void *BlockPool_alloc(BlockPool_Object *pool, size_t size)
+{
+    BlockPool_ClassState *state;
+    void                 *block = NULL;
+    uintptr_t             key;
+    unsigned int          i;
+    bool                  fallback = false;
+
+    key = HwiP_disable();
+
+    for (i = 0; i < pool->classCount; i++) {
+        state = &pool->classes[i];
+        if (state->stats.blockSize < size) {
+            continue;
+        }
+        if (state->head == NULL) {
+            fallback = true;
+            continue;
+        }
+
+        block = state->head;
+        state->head = *(void **)block;
+
+        state->stats.free--;
+        if (state->stats.free < state->stats.minFree) {
+            state->stats.minFree = state->stats.free;
+        }
+        state->stats.allocs++;
+        if (fallback) {
+            state->stats.fallbacks++;
+        }
+        break;
+    }
+
+    if (block == NULL) {
+        pool->failures++;
+    }
+
+    HwiP_restore(key);
+
+    return (block);
+}
+
+/*
+ *  ======== BlockPool_free ========
+ */
+void BlockPool_free(BlockPool_Object *pool, void *block)
+{
+    BlockPool_ClassState *state;
+    uintptr_t             key;
+    unsigned int          i;
+
+    if (block == NULL) {
+        return;
+    }
+
+    for (i = 0; i < pool->classCount; i++) {
+        state = &pool->classes[i];
+        if (((uint8_t *)block >= state->start) &&
+            ((uint8_t *)block < state->end)) {
+            key = HwiP_disable();
+
+            *(void **)block = state->head;
+            state->head = block;
+            state->stats.free++;
+
+            HwiP_restore(key);
+            return;
+        }
+    }
+}
+
+/*
+ *  ======== BlockPool_getStats ========
+ */
+void BlockPool_getStats(BlockPool_Object *pool, BlockPool_Stats *stats)
+{
+    uintptr_t    key;
+    unsigned int i;
+
+    memset(stats, 0, sizeof(BlockPool_Stats));
+
+    key = HwiP_disable();
+
+    stats->failures   = pool->failures;
+    stats->classCount = pool->classCount;
+    for (i = 0; i < pool->classCount; i++) {
+        stats->classes[i] = pool->classes[i].stats;
+    }
+
+    HwiP_restore(key);
+}
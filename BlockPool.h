@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       BlockPool.h
+ *
+ *  @brief      Fixed-size block allocator with several size classes.
+ *
+ *  Each size class is an array of equal blocks in static storage. Free
+ *  blocks are chained through their first word, so allocation and release
+ *  take a few instructions with interrupts disabled, whatever the number
+ *  of blocks, and the pool cannot fragment: any free block of a class fits
+ *  any request for that class.
+ *
+ *  BlockPool_alloc() takes a block from the smallest class that fits the
+ *  request and has one free; a request that falls through to a larger
+ *  class is counted as a fallback. BlockPool_free() finds the class from
+ *  the address of the block.
+ *
+ *  All functions may be called from Task, Swi and Hwi context.
+ *
+ *  ============================================================================
+ */
+#ifndef __BLOCKPOOL_H__
+#define __BLOCKPOOL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*! Largest number of size classes of a pool */
+#define BlockPool_MAX_CLASSES   6
+
+/*!
+ *  @brief  Define the storage of a size class, 8 byte aligned
+ *
+ *  @p size must be a multiple of 8.
+ */
+#define BlockPool_STORAGE(name, size, count) \
+    uint64_t name[((size) * (count)) / 8]
+
+/*!
+ *  @brief  A size class, in the pool configuration
+ */
+typedef struct BlockPool_Class {
+    uint16_t  blockSize;   /*!< Bytes, a multiple of 8 */
+    uint16_t  blockCount;
+    void     *storage;     /*!< See BlockPool_STORAGE() */
+} BlockPool_Class;
+
+/*!
+ *  @brief  Counters of one size class
+ */
+typedef struct BlockPool_ClassStats {
+    uint16_t blockSize;
+    uint16_t blockCount;
+    uint16_t free;        /*!< Blocks free now */
+    uint16_t minFree;     /*!< Fewest blocks ever free */
+    uint32_t allocs;      /*!< Blocks handed out */
+    uint32_t fallbacks;   /*!< Requests served by this class because the
+                               smaller fitting ones were empty */
+} BlockPool_ClassStats;
+
+/*!
+ *  @brief  Counters of a pool
+ */
+typedef struct BlockPool_Stats {
+    uint32_t             failures;    /*!< Requests that got NULL */
+    uint8_t              classCount;  /*!< Valid entries of @p classes */
+    BlockPool_ClassStats classes[BlockPool_MAX_CLASSES];
+} BlockPool_Stats;
+
+/*!
+ *  @brief  State of one size class
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct BlockPool_ClassState {
+    uint8_t              *start;
+    uint8_t              *end;
+    void                 *head;
+    BlockPool_ClassStats  stats;
+} BlockPool_ClassState;
+
+/*!
+ *  @brief  BlockPool object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct BlockPool_Object {
+    uint8_t               classCount;
+    uint32_t              failures;
+    BlockPool_ClassState  classes[BlockPool_MAX_CLASSES];
+} BlockPool_Object;
+
+/*!
+ *  @brief  Build the free lists
+ *
+ *  @param  classes  Size classes in increasing block size
+ *
+ *  @return false if the classes are invalid.
+ */
+extern bool BlockPool_construct(BlockPool_Object *pool,
+                                BlockPool_Class const *classes,
+                                uint_least8_t classCount);
+
+/*!
+ *  @brief  Allocate a block of at least @p size bytes
+ *
+ *  @return The block, 8 byte aligned, or NULL if no class can serve it.
+ */
+extern void *BlockPool_alloc(BlockPool_Object *pool, size_t size);
+
+/*!
+ *  @brief  Release a block returned by BlockPool_alloc()
+ */
+extern void BlockPool_free(BlockPool_Object *pool, void *block);
+
+/*!
+ *  @brief  Read the counters
+ */
+extern void BlockPool_getStats(BlockPool_Object *pool, BlockPool_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLOCKPOOL_H__ */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== ButtonEvents.c ========
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/drivers/PIN.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Board.h"
+#include "ButtonEvents.h"
+#include "Dwt.h"
+#include "SpscRing.h"
+
+static const PIN_Config ButtonEvents_pinTable[] = {
+    Board_PIN_BUTTON0 | PIN_INPUT_EN | PIN_PULLUP | PIN_IRQ_BOTHEDGES |
+        PIN_HYSTERESIS,
+    Board_PIN_BUTTON1 | PIN_INPUT_EN | PIN_PULLUP | PIN_IRQ_BOTHEDGES |
+        PIN_HYSTERESIS,
+    PIN_TERMINATE
+};
+
+static PIN_State          ButtonEvents_pinState;
+static SemaphoreP_Struct  ButtonEvents_sem;
+static SpscRing_Struct    ButtonEvents_ring;
+static ButtonEvents_Event ButtonEvents_buf[ButtonEvents_QUEUE_SIZE];
+
+/* Written by the PIN callback only */
+static volatile uint32_t  ButtonEvents_events;
+static volatile uint32_t  ButtonEvents_dropped;
+static volatile uint32_t  ButtonEvents_callbackMax;
+static volatile uint32_t  ButtonEvents_callbackTotal;
+
+/* Written by the waiting task only */
+static uint32_t           ButtonEvents_wakeMax;
+static uint32_t           ButtonEvents_wakeTotal;
+static uint32_t           ButtonEvents_received;
+
+static void ButtonEvents_pinFxn(PIN_Handle handle, PIN_Id pinId);
+
+/*
+ *  ======== ButtonEvents_open ========
+ */
+bool ButtonEvents_open(void)
+{
+    PIN_Handle pinHandle;
+
+    Dwt_enable();
+
+    SpscRing_construct(&ButtonEvents_ring, ButtonEvents_buf,
+            sizeof(ButtonEvents_Event), ButtonEvents_QUEUE_SIZE);
+    SemaphoreP_constructBinary(&ButtonEvents_sem, 0);
+
+    pinHandle = PIN_open(&ButtonEvents_pinState, ButtonEvents_pinTable);
+    if (pinHandle == NULL) {
+        SemaphoreP_destruct(&ButtonEvents_sem);
+        return (false);
+    }
+    PIN_registerIntCb(pinHandle, ButtonEvents_pinFxn);
+
+    return (true);
+}
+
+/*
+ *  ======== ButtonEvents_wait ========
+ */
+uint32_t ButtonEvents_wait(ButtonEvents_Event *events, uint32_t max,
+                           uint32_t timeout)
+{
+    uint32_t count;
+    uint32_t now;
+    uint32_t wake;
+    uint32_t i;
+
+    /* A post for edges taken by the previous call only costs a retry */
+    while ((count = SpscRing_popBatch(&ButtonEvents_ring, events, max)) ==
+            0) {
+        if (SemaphoreP_pend(&ButtonEvents_sem, timeout) != SemaphoreP_OK) {
+            return (0);
+        }
+    }
+
+    now = Dwt_cycles();
+    for (i = 0; i < count; i++) {
+        wake = now - events[i].timestamp;
+        if (wake > ButtonEvents_wakeMax) {
+            ButtonEvents_wakeMax = wake;
+        }
+        ButtonEvents_wakeTotal += wake;
+    }
+    ButtonEvents_received += count;
+
+    return (count);
+}
+
+/*
+ *  ======== ButtonEvents_getStats ========
+ */
+void ButtonEvents_getStats(ButtonEvents_Stats *stats)
+{
+    stats->events        = ButtonEvents_events;
+    stats->dropped       = ButtonEvents_dropped;
+    stats->callbackMax   = ButtonEvents_callbackMax;
+    stats->callbackTotal = ButtonEvents_callbackTotal;
+    stats->wakeMax       = ButtonEvents_wakeMax;
+    stats->wakeTotal     = ButtonEvents_wakeTotal;
+    stats->received      = ButtonEvents_received;
+}
+
+/*
+ *  ======== ButtonEvents_pinFxn ========
+ *  Called from the PIN driver's Swi.
+ */
+static void ButtonEvents_pinFxn(PIN_Handle handle, PIN_Id pinId)
+{
+    ButtonEvents_Event event;
+    uint32_t           cycles;
+
+    event.timestamp = Dwt_cycles();
+    event.pin       = pinId;
+    event.pressed   = (PIN_getInputValue(pinId) == 0);
+
+    if (SpscRing_push(&ButtonEvents_ring, &event)) {
+        ButtonEvents_events++;
+    }
+    else {
+        ButtonEvents_dropped++;
+    }
+    SemaphoreP_post(&ButtonEvents_sem);
+
+    cycles = Dwt_cycles() - event.timestamp;
+    if (cycles > ButtonEvents_callbackMax) {
+        ButtonEvents_callbackMax = cycles;
+    }
+    ButtonEvents_callbackTotal += cycles;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       ButtonEvents.h
+ *
+ *  @brief      Edges of the LaunchPad buttons, delivered to a task.
+ *
+ *  The PIN callback only timestamps the edge, appends it to an SpscRing and
+ *  posts a semaphore; it takes no lock. ButtonEvents_wait() drains all
+ *  queued edges at once. Edges are not debounced.
+ *
+ *  The PIN driver runs the callback in its Swi, which its Hwi posts, not
+ *  in the Hwi itself. Timestamps are DWT cycle counts, which
+ *  ButtonEvents_open() enables, taken at the start of the callback. The
+ *  statistics give the cycles spent in the callback and the wake latency
+ *  from the start of the callback to the task having the event; neither
+ *  includes the PIN Hwi or its dispatch of the Swi.
+ *
+ *  ============================================================================
+ */
+#ifndef __BUTTONEVENTS_H__
+#define __BUTTONEVENTS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*! Edges queued before further ones are dropped, a power of two */
+#define ButtonEvents_QUEUE_SIZE     16
+
+/*!
+ *  @brief  One edge
+ */
+typedef struct ButtonEvents_Event {
+    uint32_t timestamp;  /*!< DWT cycle count in the PIN callback */
+    uint8_t  pin;        /*!< Board_PIN_BUTTON0 or Board_PIN_BUTTON1 */
+    bool     pressed;    /*!< The buttons are active low */
+} ButtonEvents_Event;
+
+/*!
+ *  @brief  Counters
+ */
+typedef struct ButtonEvents_Stats {
+    uint32_t events;        /*!< Edges queued */
+    uint32_t dropped;       /*!< Edges lost to a full queue */
+    uint32_t callbackMax;   /*!< Cycles, longest PIN callback */
+    uint32_t callbackTotal; /*!< Cycles, all PIN callbacks */
+    uint32_t wakeMax;       /*!< Cycles, longest wake latency */
+    uint32_t wakeTotal;     /*!< Cycles, all edges received */
+    uint32_t received;      /*!< Edges returned by ButtonEvents_wait() */
+} ButtonEvents_Stats;
+
+/*!
+ *  @brief  Enable the button interrupts
+ *
+ *  @return false if the pins are not available.
+ */
+extern bool ButtonEvents_open(void);
+
+/*!
+ *  @brief  Wait for edges, from a single task
+ *
+ *  @param  events   Room for @p max edges
+ *  @param  timeout  In ClockP ticks, or SemaphoreP_WAIT_FOREVER
+ *
+ *  @return Edges stored in @p events, 0 on timeout.
+ */
+extern uint32_t ButtonEvents_wait(ButtonEvents_Event *events, uint32_t max,
+                                  uint32_t timeout);
+
+/*!
+ *  @brief  Read the counters
+ */
+extern void ButtonEvents_getStats(ButtonEvents_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BUTTONEVENTS_H__ */
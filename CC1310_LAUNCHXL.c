@@ -253,6 +253,9 @@ const CryptoCC26XX_Config CryptoCC26XX_config[CC1310_LAUNCHXL_CRYPTOCOUNT] = {
 #include <ti/display/DisplayUart.h>
 #include <ti/display/DisplaySharp.h>
 
+#include "DisplaySharpDma.h"
+#include "DisplayUartDma.h"
+
 #ifndef BOARD_DISPLAY_UART_STRBUF_SIZE
 #define BOARD_DISPLAY_UART_STRBUF_SIZE    128
 #endif
@@ -261,11 +264,33 @@ const CryptoCC26XX_Config CryptoCC26XX_config[CC1310_LAUNCHXL_CRYPTOCOUNT] = {
 #define BOARD_DISPLAY_SHARP_SIZE    96
 #endif
 
+#ifndef BOARD_DISPLAY_USE_UART
+#define BOARD_DISPLAY_USE_UART 1
+#endif
+#ifndef BOARD_DISPLAY_USE_UART_DMA
+#define BOARD_DISPLAY_USE_UART_DMA 1
+#endif
+#ifndef BOARD_DISPLAY_USE_UART_ANSI
+#define BOARD_DISPLAY_USE_UART_ANSI 0
+#endif
+#ifndef BOARD_DISPLAY_USE_LCD
+#define BOARD_DISPLAY_USE_LCD 0
+#endif
+#ifndef BOARD_DISPLAY_USE_LCD_DMA
+#define BOARD_DISPLAY_USE_LCD_DMA 1
+#endif
+#ifndef BOARD_DISPLAY_USE_MUX
+#define BOARD_DISPLAY_USE_MUX (BOARD_DISPLAY_USE_UART && BOARD_DISPLAY_USE_LCD)
+#endif
+
+/*
+ * Only the objects and buffers of the selected UART and LCD drivers are
+ * allocated, and none for a display that is not used.
+ */
+#if (BOARD_DISPLAY_USE_UART) && !(BOARD_DISPLAY_USE_UART_DMA)
 DisplayUart_Object     displayUartObject;
-DisplaySharp_Object    displaySharpObject;
 
 static char uartStringBuf[BOARD_DISPLAY_UART_STRBUF_SIZE];
-static uint_least8_t sharpDisplayBuf[BOARD_DISPLAY_SHARP_SIZE * BOARD_DISPLAY_SHARP_SIZE / 8];
 
 const DisplayUart_HWAttrs displayUartHWAttrs = {
     .uartIdx      = CC1310_LAUNCHXL_UART0,
@@ -274,6 +299,27 @@ const DisplayUart_HWAttrs displayUartHWAttrs = {
     .strBuf       = uartStringBuf,
     .strBufLen    = BOARD_DISPLAY_UART_STRBUF_SIZE,
 };
+#endif
+
+#if (BOARD_DISPLAY_USE_UART) && (BOARD_DISPLAY_USE_UART_DMA)
+DisplayUartDma_Object  displayUartDmaObject;
+
+/*
+ * Messages are formatted into the UART0 transmit slots, see the
+ * UART DMA section below for their number and size.
+ */
+const DisplayUartDma_HWAttrs displayUartDmaHWAttrs = {
+    .uartIdx        = CC1310_LAUNCHXL_UART0,
+    .baudRate       = 115200,
+    .overflowPolicy = UartDmaCC26XX_OVERFLOW_DROP,
+    .blockTimeout   = 0,
+};
+#endif
+
+#if (BOARD_DISPLAY_USE_LCD) && !(BOARD_DISPLAY_USE_LCD_DMA)
+DisplaySharp_Object    displaySharpObject;
+
+static uint_least8_t sharpDisplayBuf[BOARD_DISPLAY_SHARP_SIZE * BOARD_DISPLAY_SHARP_SIZE / 8];
 
 const DisplaySharp_HWAttrsV1 displaySharpHWattrs = {
     .spiIndex    = CC1310_LAUNCHXL_SPI0,
@@ -284,16 +330,94 @@ const DisplaySharp_HWAttrsV1 displaySharpHWattrs = {
     .pixelHeight = BOARD_DISPLAY_SHARP_SIZE,
     .displayBuf  = sharpDisplayBuf,
 };
+#endif
 
-#ifndef BOARD_DISPLAY_USE_UART
-#define BOARD_DISPLAY_USE_UART 1
+#if (BOARD_DISPLAY_USE_LCD) && (BOARD_DISPLAY_USE_LCD_DMA)
+DisplaySharpDma_Object displaySharpDmaObject;
+
+static uint8_t sharpDmaDisplayBuf[DisplaySharpDma_BUF_SIZE(BOARD_DISPLAY_SHARP_SIZE, BOARD_DISPLAY_SHARP_SIZE)];
+
+/*
+ * Only rows that changed are sent. The framebuffer is kept in the panel's
+ * wire format and is 2 bytes per row plus 2 larger than the stock driver's.
+ */
+const DisplaySharpDma_HWAttrs displaySharpDmaHWAttrs = {
+    .spiIndex    = CC1310_LAUNCHXL_SPI0,
+    .bitRate     = 1000000,
+    .csPin       = CC1310_LAUNCHXL_GPIO_LCD_CS,
+    .powerPin    = CC1310_LAUNCHXL_GPIO_LCD_POWER,
+    .enablePin   = CC1310_LAUNCHXL_GPIO_LCD_ENABLE,
+    .pixelWidth  = BOARD_DISPLAY_SHARP_SIZE,
+    .pixelHeight = BOARD_DISPLAY_SHARP_SIZE,
+    .displayBuf  = sharpDmaDisplayBuf,
+};
 #endif
-#ifndef BOARD_DISPLAY_USE_UART_ANSI
-#define BOARD_DISPLAY_USE_UART_ANSI 0
+
+/*
+ * Display_config entries. The mux comes first, so that Display_open()
+ * finds it before its sinks, and refers to the sinks by these names.
+ */
+typedef enum CC1310_LAUNCHXL_DisplayName {
+#if (BOARD_DISPLAY_USE_MUX)
+    CC1310_LAUNCHXL_DISPLAY_MUX,
 #endif
-#ifndef BOARD_DISPLAY_USE_LCD
-#define BOARD_DISPLAY_USE_LCD 0
+#if (BOARD_DISPLAY_USE_UART)
+    CC1310_LAUNCHXL_DISPLAY_UART,
 #endif
+#if (BOARD_DISPLAY_USE_LCD)
+    CC1310_LAUNCHXL_DISPLAY_LCD,
+#endif
+
+    CC1310_LAUNCHXL_DISPLAYCOUNT
+} CC1310_LAUNCHXL_DisplayName;
+
+#if (BOARD_DISPLAY_USE_MUX)
+#include "DisplayMux.h"
+
+/*
+ * With both displays enabled, Display_open() returns a mux that formats
+ * each message once for the UART and the LCD. The LCD is refreshed by the
+ * mux worker at most every BOARD_DISPLAY_MUX_LCD_INTERVAL ms.
+ */
+#ifndef BOARD_DISPLAY_MUX_LCD_INTERVAL
+#define BOARD_DISPLAY_MUX_LCD_INTERVAL    200
+#endif
+
+#define BOARD_DISPLAY_MUX_LCD_LINES       (BOARD_DISPLAY_SHARP_SIZE / 8)
+#define BOARD_DISPLAY_MUX_LCD_COLUMNS     (BOARD_DISPLAY_SHARP_SIZE / 6)
+#define BOARD_DISPLAY_MUX_STACK_SIZE      768
+
+DisplayMux_Object displayMuxObject;
+
+static char muxStringBuf[BOARD_DISPLAY_UART_STRBUF_SIZE];
+static char muxLcdLineCache[DisplayMux_LINE_CACHE_SIZE(
+    BOARD_DISPLAY_MUX_LCD_LINES, BOARD_DISPLAY_MUX_LCD_COLUMNS)];
+static StaticThread_STACK(muxWorkerStack, BOARD_DISPLAY_MUX_STACK_SIZE);
+
+static const DisplayMux_Sink displayMuxSinks[] = {
+    {
+        .index       = CC1310_LAUNCHXL_DISPLAY_UART,    /* Written directly */
+        .minInterval = 0,
+    },
+    {
+        .index       = CC1310_LAUNCHXL_DISPLAY_LCD,     /* Rate limited */
+        .minInterval = BOARD_DISPLAY_MUX_LCD_INTERVAL,
+        .lineCache   = muxLcdLineCache,
+        .lines       = BOARD_DISPLAY_MUX_LCD_LINES,
+        .columns     = BOARD_DISPLAY_MUX_LCD_COLUMNS,
+    },
+};
+
+const DisplayMux_HWAttrs displayMuxHWAttrs = {
+    .sinks           = displayMuxSinks,
+    .sinkCount       = sizeof(displayMuxSinks) / sizeof(DisplayMux_Sink),
+    .strBuf          = muxStringBuf,
+    .strBufLen       = sizeof(muxStringBuf),
+    .workerStack     = muxWorkerStack,
+    .workerStackSize = sizeof(muxWorkerStack),
+    .workerPriority  = 1,
+};
+#endif /* BOARD_DISPLAY_USE_MUX */
 
 /*
  * This #if/#else is needed to workaround a problem with the
@@ -303,27 +427,48 @@ const DisplaySharp_HWAttrsV1 displaySharpHWattrs = {
 #if (BOARD_DISPLAY_USE_UART || BOARD_DISPLAY_USE_LCD)
 
 const Display_Config Display_config[] = {
+#if (BOARD_DISPLAY_USE_MUX)
+    [CC1310_LAUNCHXL_DISPLAY_MUX] = {
+        .fxnTablePtr = &DisplayMux_fxnTable,
+        .object      = &displayMuxObject,
+        .hwAttrs     = &displayMuxHWAttrs
+    },
+#endif
 #if (BOARD_DISPLAY_USE_UART)
-    {
-#  if (BOARD_DISPLAY_USE_UART_ANSI)
+    [CC1310_LAUNCHXL_DISPLAY_UART] = {
+#  if (BOARD_DISPLAY_USE_UART_DMA)
+        /* Non-blocking minimal UART, written by the uDMA */
+        .fxnTablePtr = &DisplayUartDma_fxnTable,
+        .object      = &displayUartDmaObject,
+        .hwAttrs     = &displayUartDmaHWAttrs,
+#  else
+#    if (BOARD_DISPLAY_USE_UART_ANSI)
         .fxnTablePtr = &DisplayUartAnsi_fxnTable,
-#  else /* Default to minimal UART with no cursor placement */
+#    else /* Default to minimal UART with no cursor placement */
         .fxnTablePtr = &DisplayUartMin_fxnTable,
-#  endif
+#    endif
         .object      = &displayUartObject,
         .hwAttrs     = &displayUartHWAttrs,
+#  endif
     },
 #endif
 #if (BOARD_DISPLAY_USE_LCD)
-    {
+    [CC1310_LAUNCHXL_DISPLAY_LCD] = {
+#  if (BOARD_DISPLAY_USE_LCD_DMA)
+        /* Sharp LCD, sends modified rows only */
+        .fxnTablePtr = &DisplaySharpDma_fxnTable,
+        .object      = &displaySharpDmaObject,
+        .hwAttrs     = &displaySharpDmaHWAttrs
+#  else
         .fxnTablePtr = &DisplaySharp_fxnTable,
         .object      = &displaySharpObject,
         .hwAttrs     = &displaySharpHWattrs
+#  endif
     },
 #endif
 };
 
-const uint_least8_t Display_count = sizeof(Display_config) / sizeof(Display_Config);
+const uint_least8_t Display_count = CC1310_LAUNCHXL_DISPLAYCOUNT;
 
 #else
 
@@ -581,9 +726,12 @@ const PINCC26XX_HWAttrs PINCC26XX_hwAttrs = {
 #include <ti/drivers/Power.h>
 #include <ti/drivers/power/PowerCC26XX.h>
 
+#include "FlashPolicy.h"
+
+/* The standby policy, batching deferred flash work before standby */
 const PowerCC26XX_Config PowerCC26XX_config = {
     .policyInitFxn      = NULL,
-    .policyFxn          = &PowerCC26XX_standbyPolicy,
+    .policyFxn          = &FlashPolicy_policy,
     .calibrateFxn       = &PowerCC26XX_calibrate,
     .enablePolicy       = true,
     .calibrateRCOSC_LF  = true,
@@ -631,7 +779,7 @@ const uint_least8_t PWM_count = CC1310_LAUNCHXL_PWMCOUNT;
 const RFCC26XX_HWAttrsV2 RFCC26XX_hwAttrs = {
     .hwiPriority        = ~0,       /* Lowest HWI priority */
     .swiPriority        = 0,        /* Lowest SWI priority */
-    .xoscHfAlwaysNeeded = true,     /* Keep XOSC dependency while in stanby */
+    .xoscHfAlwaysNeeded = false,    /* Started ahead of commands, XoscHf.h */
     .globalCallback     = NULL,     /* No board specific callback */
     .globalEventMask    = 0         /* No events subscribed to */
 };
@@ -728,6 +876,23 @@ const uint_least8_t SPI_count = CC1310_LAUNCHXL_SPICOUNT;
 #include <ti/drivers/UART.h>
 #include <ti/drivers/uart/UARTCC26XX.h>
 
+/*
+ * The debugger back channel on the LaunchPad only carries RX and TX. Set to 1
+ * when CTS and RTS are wired to the host, e.g. through an external USB
+ * serial adapter, to use hardware flow control with both UART drivers.
+ */
+#ifndef BOARD_UART_FLOW_CONTROL
+#define BOARD_UART_FLOW_CONTROL 0
+#endif
+
+#if (BOARD_UART_FLOW_CONTROL)
+#define BOARD_UART_CTS_PIN  CC1310_LAUNCHXL_UART_CTS
+#define BOARD_UART_RTS_PIN  CC1310_LAUNCHXL_UART_RTS
+#else
+#define BOARD_UART_CTS_PIN  PIN_UNASSIGNED
+#define BOARD_UART_RTS_PIN  PIN_UNASSIGNED
+#endif
+
 UARTCC26XX_Object uartCC26XXObjects[CC1310_LAUNCHXL_UARTCOUNT];
 
 uint8_t uartCC26XXRingBuffer[CC1310_LAUNCHXL_UARTCOUNT][32];
@@ -741,8 +906,8 @@ const UARTCC26XX_HWAttrsV2 uartCC26XXHWAttrs[CC1310_LAUNCHXL_UARTCOUNT] = {
         .swiPriority    = 0,
         .txPin          = CC1310_LAUNCHXL_UART_TX,
         .rxPin          = CC1310_LAUNCHXL_UART_RX,
-        .ctsPin         = PIN_UNASSIGNED,
-        .rtsPin         = PIN_UNASSIGNED,
+        .ctsPin         = BOARD_UART_CTS_PIN,
+        .rtsPin         = BOARD_UART_RTS_PIN,
         .ringBufPtr     = uartCC26XXRingBuffer[CC1310_LAUNCHXL_UART0],
         .ringBufSize    = sizeof(uartCC26XXRingBuffer[CC1310_LAUNCHXL_UART0]),
         .txIntFifoThr   = UARTCC26XX_FIFO_THRESHOLD_1_8,
@@ -761,6 +926,72 @@ const UART_Config UART_config[CC1310_LAUNCHXL_UARTCOUNT] = {
 
 const uint_least8_t UART_count = CC1310_LAUNCHXL_UARTCOUNT;
 
+/*
+ *  =============================== UART DMA ===============================
+ *  Used by the DisplayUartDma display and for bulk reception. Owns the same
+ *  peripheral as the UART driver above, so only one of them can be open at
+ *  a time.
+ */
+#include <ti/drivers/dma/UDMACC26XX.h>
+#include "UartDmaCC26XX.h"
+
+#ifndef BOARD_UART_TX_SLOT_COUNT
+#define BOARD_UART_TX_SLOT_COUNT    8   /* Must be a power of two */
+#endif
+
+#ifndef BOARD_UART_TX_SLOT_SIZE
+#define BOARD_UART_TX_SLOT_SIZE     BOARD_DISPLAY_UART_STRBUF_SIZE
+#endif
+
+/* Pass a changed size to the --rx-buffer option of tools/remotecmd.py */
+#ifndef BOARD_UART_RX_BUF_SIZE
+#define BOARD_UART_RX_BUF_SIZE      1024 /* Power of two, two DMA halves */
+#endif
+
+ALLOCATE_CONTROL_TABLE_ENTRY(dmaUart0TxControlTableEntry, UDMA_CHAN_UART0_TX);
+ALLOCATE_CONTROL_TABLE_ENTRY(dmaUart0RxControlTableEntry, UDMA_CHAN_UART0_RX);
+ALLOCATE_CONTROL_TABLE_ENTRY(dmaUart0RxAltControlTableEntry,
+                             (UDMA_CHAN_UART0_RX | UDMA_ALT_SELECT));
+
+UartDmaCC26XX_Object uartDmaCC26XXObjects[CC1310_LAUNCHXL_UARTCOUNT];
+
+static UartDmaCC26XX_TxSlot uartDmaTxSlots[CC1310_LAUNCHXL_UARTCOUNT][BOARD_UART_TX_SLOT_COUNT];
+static uint8_t uartDmaTxSlotBuf[CC1310_LAUNCHXL_UARTCOUNT][BOARD_UART_TX_SLOT_COUNT * BOARD_UART_TX_SLOT_SIZE];
+static uint8_t uartDmaRxBuf[CC1310_LAUNCHXL_UARTCOUNT][BOARD_UART_RX_BUF_SIZE];
+
+const UartDmaCC26XX_HWAttrs uartDmaCC26XXHWAttrs[CC1310_LAUNCHXL_UARTCOUNT] = {
+    {
+        .baseAddr               = UART0_BASE,
+        .powerMngrId            = PowerCC26XX_PERIPH_UART0,
+        .intNum                 = INT_UART0_COMB,
+        .intPriority            = ~0,
+        .txPin                  = CC1310_LAUNCHXL_UART_TX,
+        .rxPin                  = CC1310_LAUNCHXL_UART_RX,
+        .ctsPin                 = BOARD_UART_CTS_PIN,
+        .rtsPin                 = BOARD_UART_RTS_PIN,
+        .txChannelBitMask       = 1 << UDMA_CHAN_UART0_TX,
+        .dmaTxControlTableEntry = &dmaUart0TxControlTableEntry,
+        .txSlots                = uartDmaTxSlots[CC1310_LAUNCHXL_UART0],
+        .txSlotBuf              = uartDmaTxSlotBuf[CC1310_LAUNCHXL_UART0],
+        .txSlotCount            = BOARD_UART_TX_SLOT_COUNT,
+        .txSlotSize             = BOARD_UART_TX_SLOT_SIZE,
+        .rxChannelBitMask       = 1 << UDMA_CHAN_UART0_RX,
+        .dmaRxControlTableEntry = &dmaUart0RxControlTableEntry,
+        .dmaRxAltControlTableEntry = &dmaUart0RxAltControlTableEntry,
+        .rxBuf                  = uartDmaRxBuf[CC1310_LAUNCHXL_UART0],
+        .rxBufSize              = BOARD_UART_RX_BUF_SIZE,
+    }
+};
+
+const UartDmaCC26XX_Config UartDmaCC26XX_config[CC1310_LAUNCHXL_UARTCOUNT] = {
+    {
+        .object  = &uartDmaCC26XXObjects[CC1310_LAUNCHXL_UART0],
+        .hwAttrs = &uartDmaCC26XXHWAttrs[CC1310_LAUNCHXL_UART0]
+    },
+};
+
+const uint_least8_t UartDmaCC26XX_count = CC1310_LAUNCHXL_UARTCOUNT;
+
 /*
  *  =============================== UDMA ===============================
  */
@@ -34,9 +34,22 @@
  *  ======== CC1310_LAUNCHXL.cmd ========
  */
 
---stack_size=1024   /* C stack is also used for ISR stack */
+/*
+ * C stack is also used for ISR stack. Its peak is listed as "ISR" by
+ * StackCheck_print().
+ */
+--stack_size=1024
 
-HEAPSIZE = 0x1000;  /* Size of heap buffer used by HeapMem */
+/*
+ * Size of heap buffer used by HeapMem. Threads, stacks and queues of the
+ * application are static (see StaticThread.h); the heap only holds kernel
+ * objects created by drivers. The peak use has not been measured yet, so
+ * this keeps what the drivers had before: the former 0x1000 less the 1 KB
+ * stack and task object of mainThread, which are now static. mainThread
+ * logs the use once every driver is open; lower this only to that figure
+ * plus a margin, and check the RAM totals of the map file when doing so.
+ */
+HEAPSIZE = 0xC00;
 
 /* Override default entry point.                                             */
 --entry_point ResetISR
@@ -63,6 +76,9 @@ MEMORY
     FLASH (RX) : origin = FLASH_BASE, length = FLASH_SIZE
     /* Application uses internal RAM for data */
     SRAM (RWX) : origin = RAM_BASE, length = RAM_SIZE
+    /* Log format strings, kept in the ELF file only (see Log.h). Log tokens */
+    /* are the low 16 bits of the address, so this must not exceed 64 KB.   */
+    LOG_DATA (R) : origin = 0x90000000, length = 0x10000
 }
 
 /* Section allocation in memory */
@@ -79,6 +95,7 @@ SECTIONS
     .init_array     :   > FLASH
     .emb_text       :   >> FLASH
     .ccfg           :   > FLASH (HIGH)
+    .log_fmt        :   > LOG_DATA, type = COPY
 
     .data           :   > SRAM
     .bss            :   > SRAM
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Cobs.c ========
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Cobs.h"
+
+/*
+ *  ======== Cobs_encode ========
+ */
+size_t Cobs_encode(const uint8_t *src, size_t len, uint8_t *dst)
+{
+    size_t  codeIdx = 0;
+    size_t  out = 1;
+    uint8_t code = 1;
+    size_t  i;
+
+    for (i = 0; i < len; i++) {
+        if (src[i] == 0) {
+            dst[codeIdx] = code;
+            codeIdx = out++;
+            code = 1;
+        }
+        else {
+            dst[out++] = src[i];
+            if (++code == 0xFF) {
+                dst[codeIdx] = code;
+                codeIdx = out++;
+                code = 1;
+            }
+        }
+    }
+
+    dst[codeIdx] = code;
+
+    return (out);
+}
+
+/*
+ *  ======== Cobs_decode ========
+ */
+size_t Cobs_decode(uint8_t *buf, size_t len)
+{
+    size_t  in = 0;
+    size_t  out = 0;
+    uint8_t code;
+    uint8_t i;
+
+    while (in < len) {
+        code = buf[in++];
+        if (code == 0 || in + code - 1 > len) {
+            return (0);
+        }
+
+        for (i = 1; i < code; i++) {
+            if (buf[in] == 0) {
+                return (0);
+            }
+            buf[out++] = buf[in++];
+        }
+
+        /* A block shorter than 254 data bytes stands for a trailing zero */
+        if (code != 0xFF && in < len) {
+            buf[out++] = 0;
+        }
+    }
+
+    return (out);
+}
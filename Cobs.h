@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Cobs.h
+ *
+ *  @brief      Consistent Overhead Byte Stuffing.
+ *
+ *  COBS removes every 0x00 from a packet at a cost of one byte per started
+ *  254 bytes, so 0x00 can delimit packets on a byte stream. Binary packets
+ *  on the UART are sent as 0x00, COBS(packet), 0x00 so that a receiver
+ *  resynchronizes on the next delimiter after any text or line noise.
+ *
+ *  Decoding never makes a packet longer, so it is done in place.
+ *
+ *  ============================================================================
+ */
+#ifndef __COBS_H__
+#define __COBS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*! Packet delimiter on the wire */
+#define Cobs_DELIMITER  0x00
+
+/*! Worst case encoded size of an @p len byte packet, without delimiters */
+#define Cobs_MAX_ENCODED_LEN(len)   ((len) + ((len) / 254) + 1)
+
+/*!
+ *  @brief  Encode @p len bytes from @p src into @p dst
+ *
+ *  @p dst must hold Cobs_MAX_ENCODED_LEN(@p len) bytes and must not overlap
+ *  @p src. No delimiter is written.
+ *
+ *  @return Number of bytes written to @p dst.
+ */
+extern size_t Cobs_encode(const uint8_t *src, size_t len, uint8_t *dst);
+
+/*!
+ *  @brief  Decode an encoded packet in place
+ *
+ *  @param  buf  Encoded packet without delimiters
+ *  @param  len  Number of encoded bytes
+ *
+ *  @return Length of the decoded packet, or 0 if @p buf is not valid COBS.
+ */
+extern size_t Cobs_decode(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __COBS_H__ */
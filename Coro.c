@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Coro.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Coro.h"
+
+/* Coro_Struct.state */
+#define Coro_STATE_READY        0
+#define Coro_STATE_RUNNING      1
+#define Coro_STATE_WAITING      2
+#define Coro_STATE_WAITING_TIMED 3
+#define Coro_STATE_DONE         4
+
+/* Coro_Struct.result, see Coro_timedOut() */
+#define Coro_RESULT_OK          0
+#define Coro_RESULT_TIMEOUT     1
+#define Coro_RESULT_PENDING     2
+
+/*
+ *  ======== Coro_enqueue ========
+ *  Called with interrupts disabled. Returns true if the queue was empty,
+ *  and the scheduler may be asleep.
+ */
+static bool Coro_enqueue(Coro_Sched *sched, Coro_Struct *coro)
+{
+    coro->next = NULL;
+    if (sched->readyTail == NULL) {
+        sched->readyHead = coro;
+        sched->readyTail = coro;
+        return (true);
+    }
+    sched->readyTail->next = coro;
+    sched->readyTail = coro;
+
+    return (false);
+}
+
+/*
+ *  ======== Coro_wake ========
+ *  Ends the wait of @p coro. Called with interrupts disabled. A coroutine
+ *  woken while it is still running is queued by Coro_run() once it
+ *  returns.
+ */
+static bool Coro_wake(Coro_Struct *coro, uint8_t result)
+{
+    coro->result = result;
+    coro->state  = Coro_STATE_READY;
+
+    if (coro->sched->current == coro) {
+        return (false);
+    }
+
+    return (Coro_enqueue(coro->sched, coro));
+}
+
+/*
+ *  ======== Coro_expire ========
+ *  Wakes the coroutines whose timeout has passed. Called with interrupts
+ *  disabled. Returns the ticks until the next timeout.
+ */
+static uint32_t Coro_expire(Coro_Sched *sched, uint32_t now)
+{
+    Coro_Struct  *coro;
+    Coro_Struct **link;
+    uint32_t      timeout = SemaphoreP_WAIT_FOREVER;
+    int32_t       left;
+
+    for (coro = sched->all; coro != NULL; coro = coro->nextAll) {
+        if (coro->state != Coro_STATE_WAITING_TIMED) {
+            continue;
+        }
+
+        left = (int32_t)(coro->wake - now);
+        if (left > 0) {
+            if ((uint32_t)left < timeout) {
+                timeout = left;
+            }
+            continue;
+        }
+
+        if (coro->sem != NULL) {
+            for (link = &(coro->sem->waiters); *link != coro;
+                    link = &((*link)->next)) {
+            }
+            *link = coro->next;
+        }
+        Coro_wake(coro, Coro_RESULT_TIMEOUT);
+    }
+
+    return (timeout);
+}
+
+/*
+ *  ======== Coro_Sched_construct ========
+ */
+void Coro_Sched_construct(Coro_Sched *sched)
+{
+    sched->readyHead = NULL;
+    sched->readyTail = NULL;
+    sched->all       = NULL;
+    sched->current   = NULL;
+    sched->lastScan  = ClockP_getSystemTicks();
+    sched->live      = 0;
+    SemaphoreP_constructBinary(&(sched->wake), 0);
+}
+
+/*
+ *  ======== Coro_construct ========
+ */
+void Coro_construct(Coro_Struct *coro, Coro_Sched *sched, Coro_Fxn fxn,
+                    void *arg)
+{
+    uintptr_t key;
+    bool      wake;
+
+    coro->sched  = sched;
+    coro->sem    = NULL;
+    coro->fxn    = fxn;
+    coro->arg    = arg;
+    coro->lc     = 0;
+    coro->state  = Coro_STATE_READY;
+    coro->result = Coro_RESULT_OK;
+
+    key = HwiP_disable();
+    coro->nextAll = sched->all;
+    sched->all    = coro;
+    sched->live++;
+    wake = Coro_enqueue(sched, coro);
+    HwiP_restore(key);
+
+    if (wake) {
+        SemaphoreP_post(&(sched->wake));
+    }
+}
+
+/*
+ *  ======== Coro_run ========
+ */
+void Coro_run(Coro_Sched *sched)
+{
+    Coro_Struct *coro;
+    uintptr_t    key;
+    uint32_t     timeout = SemaphoreP_WAIT_FOREVER;
+    uint32_t     now;
+    int          status;
+
+    for (;;) {
+        key = HwiP_disable();
+
+        /* Timeouts are checked once per tick, or when going to sleep */
+        now = ClockP_getSystemTicks();
+        if ((sched->readyHead == NULL) || (now != sched->lastScan)) {
+            timeout = Coro_expire(sched, now);
+            sched->lastScan = now;
+        }
+
+        coro = sched->readyHead;
+        if (coro == NULL) {
+            if (sched->live == 0) {
+                HwiP_restore(key);
+                break;
+            }
+            HwiP_restore(key);
+            SemaphoreP_pend(&(sched->wake), timeout);
+            continue;
+        }
+
+        sched->readyHead = coro->next;
+        if (sched->readyHead == NULL) {
+            sched->readyTail = NULL;
+        }
+        sched->current = coro;
+        coro->state    = Coro_STATE_RUNNING;
+        HwiP_restore(key);
+
+        status = coro->fxn(coro, coro->arg);
+
+        key = HwiP_disable();
+        sched->current = NULL;
+        if (status == Coro_DONE) {
+            coro->state = Coro_STATE_DONE;
+            sched->live--;
+        }
+        else if ((status == Coro_YIELDED) ||
+                 (coro->state == Coro_STATE_READY)) {
+            /* Yielded, or woken before it returned */
+            coro->state = Coro_STATE_READY;
+            Coro_enqueue(sched, coro);
+        }
+        HwiP_restore(key);
+    }
+}
+
+/*
+ *  ======== Coro_Sem_construct ========
+ */
+void Coro_Sem_construct(Coro_Sem *sem, uint16_t count)
+{
+    sem->waiters = NULL;
+    sem->count   = count;
+}
+
+/*
+ *  ======== Coro_Sem_post ========
+ */
+void Coro_Sem_post(Coro_Sem *sem)
+{
+    Coro_Struct *coro;
+    uintptr_t    key;
+    bool         wake = false;
+
+    key = HwiP_disable();
+    coro = sem->waiters;
+    if (coro == NULL) {
+        sem->count++;
+    }
+    else {
+        /* The count goes straight to the waiter */
+        sem->waiters = coro->next;
+        wake = Coro_wake(coro, Coro_RESULT_OK);
+    }
+    HwiP_restore(key);
+
+    if (wake) {
+        SemaphoreP_post(&(coro->sched->wake));
+    }
+}
+
+/*
+ *  ======== Coro_sleep ========
+ */
+int Coro_sleep(Coro_Struct *coro, uint32_t ticks)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    coro->sem    = NULL;
+    coro->wake   = ClockP_getSystemTicks() + ticks;
+    coro->result = Coro_RESULT_PENDING;
+    coro->state  = Coro_STATE_WAITING_TIMED;
+    HwiP_restore(key);
+
+    return (Coro_BLOCKED);
+}
+
+/*
+ *  ======== Coro_tryPend ========
+ *  Called on reaching Coro_PEND() and again once the wait is over.
+ */
+bool Coro_tryPend(Coro_Struct *coro, Coro_Sem *sem, uint32_t timeout)
+{
+    Coro_Struct **link;
+    uintptr_t     key;
+
+    key = HwiP_disable();
+
+    if (coro->sem == sem) {
+        /* Woken by Coro_Sem_post() or the timeout, result is set */
+        coro->sem = NULL;
+        HwiP_restore(key);
+        return (true);
+    }
+
+    if (sem->count > 0) {
+        sem->count--;
+        coro->result = Coro_RESULT_OK;
+        HwiP_restore(key);
+        return (true);
+    }
+
+    if (timeout == 0) {
+        coro->result = Coro_RESULT_TIMEOUT;
+        HwiP_restore(key);
+        return (true);
+    }
+
+    coro->sem    = sem;
+    coro->result = Coro_RESULT_PENDING;
+    coro->next   = NULL;
+    for (link = &(sem->waiters); *link != NULL; link = &((*link)->next)) {
+    }
+    *link = coro;
+
+    if (timeout == SemaphoreP_WAIT_FOREVER) {
+        coro->state = Coro_STATE_WAITING;
+    }
+    else {
+        coro->wake  = ClockP_getSystemTicks() + timeout;
+        coro->state = Coro_STATE_WAITING_TIMED;
+    }
+
+    HwiP_restore(key);
+
+    return (false);
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Coro.h
+ *
+ *  @brief      Stackless coroutines sharing one thread.
+ *
+ *  Protocol state machines spend most of their time waiting. Giving each
+ *  its own thread costs a stack sized for its deepest call; a coroutine
+ *  instead keeps only its resume point and runs on the stack of the thread
+ *  that calls Coro_run(), so any number of them fit in one thread.
+ *
+ *  A coroutine function starts with Coro_BEGIN() and ends with Coro_END().
+ *  In between it may wait with:
+ *  - Coro_YIELD(), to let the other ready coroutines run,
+ *  - Coro_SLEEP(), for a number of ClockP ticks,
+ *  - Coro_PEND(), on a Coro_Sem, with a timeout. Coro_Sem_post() may be
+ *    called from any context, so a driver callback can signal an I/O
+ *    completion to a coroutine through it.
+ *
+ *  The function returns at every wait and is called again from the top
+ *  when the wait is over; Coro_BEGIN() jumps back to where it left off.
+ *  This has two consequences, as for protothreads:
+ *  - Local variables do not keep their value across a wait. State that
+ *    must survive belongs in the structure passed as @p arg.
+ *  - The wait macros expand to case labels, so they cannot be used inside
+ *    a switch statement of the function, and only one may be used per
+ *    source line.
+ *
+ *  Coroutines run in the order they became ready, each until it waits or
+ *  ends. They never preempt each other, so state shared between the
+ *  coroutines of one scheduler needs no lock.
+ *
+ *  @code
+ *  #include "Coro.h"
+ *
+ *  typedef struct Link {
+ *      Coro_Sem  rxDone;
+ *      uint8_t   retries;
+ *  } Link;
+ *
+ *  static int linkFxn(Coro_Struct *coro, void *arg)
+ *  {
+ *      Link *link = arg;
+ *
+ *      Coro_BEGIN(coro);
+ *      for (link->retries = 0; link->retries < 3; link->retries++) {
+ *          sendRequest();
+ *          Coro_PEND(coro, &link->rxDone, 100);
+ *          if (!Coro_timedOut(coro)) {
+ *              break;
+ *          }
+ *      }
+ *      Coro_END(coro);
+ *  }
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __CORO_H__
+#define __CORO_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+/*! Coroutine function return values, produced by the macros below */
+#define Coro_YIELDED    0
+#define Coro_BLOCKED    1
+#define Coro_DONE       2
+
+/*!
+ *  @brief  Start of a coroutine function body
+ */
+#define Coro_BEGIN(coro)    switch ((coro)->lc) { case 0:
+
+/*!
+ *  @brief  End of a coroutine function body, the coroutine is done
+ */
+#define Coro_END(coro)      } return (Coro_DONE)
+
+/*!
+ *  @brief  Let the other ready coroutines run first
+ */
+#define Coro_YIELD(coro)                                                    \
+    do {                                                                    \
+        (coro)->lc = __LINE__;                                              \
+        return (Coro_YIELDED);                                              \
+        case __LINE__:;                                                     \
+    } while (0)
+
+/*!
+ *  @brief  Wait for @p ticks ClockP ticks
+ */
+#define Coro_SLEEP(coro, ticks)                                             \
+    do {                                                                    \
+        (coro)->lc = __LINE__;                                              \
+        return (Coro_sleep((coro), (ticks)));                               \
+        case __LINE__:;                                                     \
+    } while (0)
+
+/*!
+ *  @brief  Take a count of @p sem, waiting up to @p timeout ticks
+ *
+ *  @p timeout may be 0 or SemaphoreP_WAIT_FOREVER. Coro_timedOut() tells
+ *  afterwards whether the count was taken.
+ */
+#define Coro_PEND(coro, sem, timeout)                                       \
+    do {                                                                    \
+        (coro)->lc = __LINE__;                                              \
+        case __LINE__:                                                      \
+        if (!Coro_tryPend((coro), (sem), (timeout))) {                      \
+            return (Coro_BLOCKED);                                          \
+        }                                                                   \
+    } while (0)
+
+struct Coro_Sched;
+struct Coro_Sem;
+struct Coro_Struct;
+
+/*!
+ *  @brief  Coroutine function
+ *
+ *  @return One of Coro_YIELDED, Coro_BLOCKED and Coro_DONE; use the macros
+ *          rather than returning directly.
+ */
+typedef int (*Coro_Fxn)(struct Coro_Struct *coro, void *arg);
+
+/*!
+ *  @brief  Coroutine object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Coro_Struct {
+    struct Coro_Struct *next;      /* Ready queue or waiters of a Coro_Sem */
+    struct Coro_Struct *nextAll;   /* All coroutines of the scheduler */
+    struct Coro_Sched  *sched;
+    struct Coro_Sem    *sem;       /* Waited on, or NULL */
+    Coro_Fxn            fxn;
+    void               *arg;
+    uint32_t            wake;      /* ClockP tick of the timeout */
+    uint16_t            lc;        /* Resume point, a line number */
+    uint8_t             state;
+    uint8_t             result;
+} Coro_Struct;
+
+/*!
+ *  @brief  Counting semaphore for coroutines
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Coro_Sem {
+    Coro_Struct *waiters;
+    uint16_t     count;
+} Coro_Sem;
+
+/*!
+ *  @brief  Scheduler object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Coro_Sched {
+    Coro_Struct       *readyHead;
+    Coro_Struct       *readyTail;
+    Coro_Struct       *all;
+    Coro_Struct       *current;
+    SemaphoreP_Struct  wake;
+    uint32_t           lastScan;
+    uint16_t           live;
+} Coro_Sched;
+
+/*!
+ *  @brief  Construct a scheduler without coroutines
+ */
+extern void Coro_Sched_construct(Coro_Sched *sched);
+
+/*!
+ *  @brief  Construct a coroutine and make it ready
+ *
+ *  May be called from a coroutine of the same scheduler or from the task
+ *  that will run it, also while Coro_run() is running.
+ */
+extern void Coro_construct(Coro_Struct *coro, Coro_Sched *sched,
+                           Coro_Fxn fxn, void *arg);
+
+/*!
+ *  @brief  Run the coroutines of @p sched in the calling task
+ *
+ *  The task sleeps while no coroutine is ready.
+ *
+ *  @return Once every coroutine has ended.
+ */
+extern void Coro_run(Coro_Sched *sched);
+
+/*!
+ *  @brief  Construct a semaphore with an initial @p count
+ */
+extern void Coro_Sem_construct(Coro_Sem *sem, uint16_t count);
+
+/*!
+ *  @brief  Give a count, or wake the coroutine that waited longest
+ *
+ *  May be called from any context.
+ */
+extern void Coro_Sem_post(Coro_Sem *sem);
+
+/*!
+ *  @brief  Whether the last Coro_PEND() of @p coro timed out
+ */
+static inline bool Coro_timedOut(const Coro_Struct *coro)
+{
+    return (coro->result != 0);
+}
+
+/* Used by the macros */
+extern int Coro_sleep(Coro_Struct *coro, uint32_t ticks);
+extern bool Coro_tryPend(Coro_Struct *coro, Coro_Sem *sem, uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CORO_H__ */
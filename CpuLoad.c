@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== CpuLoad.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Swi.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "CpuLoad.h"
+#include "Dwt.h"
+#include "Log.h"
+
+/* Swi priorities and Hwi levels that can be preempted at once */
+#define MAX_NESTING         32
+
+CpuLoad_Entry CpuLoad_usage[CpuLoad_MAX_ENTRIES] = {
+    {"Other", 0, CpuLoad_KIND_OTHER}
+};
+uint_least8_t CpuLoad_count = 1;
+uint16_t      CpuLoad_total;
+
+static Int            CpuLoad_taskId;
+static Int            CpuLoad_swiId;
+static Int            CpuLoad_hwiId;
+
+/* Thread running now, and the ones it preempted */
+static CpuLoad_Entry *CpuLoad_current = &CpuLoad_usage[0];
+static CpuLoad_Entry *CpuLoad_preempted[MAX_NESTING];
+static uint_least8_t  CpuLoad_depth;
+static uint32_t       CpuLoad_last;
+
+static uint32_t       CpuLoad_windowStart;
+static bool           CpuLoad_log;
+static ClockP_Struct  CpuLoad_clock;
+
+static void CpuLoad_clockFxn(uintptr_t arg);
+
+/*
+ *  ======== CpuLoad_charge ========
+ *  Charges the cycles since the last change to the thread that ran and
+ *  makes @p next the running one. Called with interrupts disabled.
+ */
+static inline void CpuLoad_charge(CpuLoad_Entry *next)
+{
+    uint32_t now = Dwt_cycles();
+
+    CpuLoad_current->cycles += now - CpuLoad_last;
+    CpuLoad_last    = now;
+    CpuLoad_current = next;
+}
+
+/*
+ *  ======== CpuLoad_add ========
+ *  Called with interrupts disabled, on the first run of a thread.
+ */
+static CpuLoad_Entry *CpuLoad_add(const char *name, uintptr_t fxn,
+                                  uint8_t kind)
+{
+    CpuLoad_Entry *entry;
+
+    if (CpuLoad_count == CpuLoad_MAX_ENTRIES) {
+        return (&CpuLoad_usage[0]);
+    }
+
+    entry = &CpuLoad_usage[CpuLoad_count];
+    entry->name        = name;
+    entry->fxn         = fxn;
+    entry->kind        = kind;
+    entry->load        = 0;
+    entry->peak        = 0;
+    entry->cycles      = 0;
+    entry->windowStart = 0;
+    CpuLoad_count++;
+
+    return (entry);
+}
+
+/*
+ *  ======== CpuLoad_start ========
+ */
+void CpuLoad_start(uint32_t periodMs, bool log)
+{
+    ClockP_Params clockParams;
+    uint32_t      period = periodMs * 1000 / ClockP_tickPeriod;
+
+    Dwt_enable();
+
+    CpuLoad_log         = log;
+    CpuLoad_windowStart = Dwt_cycles();
+    CpuLoad_last        = CpuLoad_windowStart;
+
+    ClockP_Params_init(&clockParams);
+    clockParams.period    = period;
+    clockParams.startFlag = true;
+    ClockP_construct(&CpuLoad_clock, CpuLoad_clockFxn, period,
+            &clockParams);
+}
+
+/*
+ *  ======== CpuLoad_print ========
+ */
+void CpuLoad_print(Display_Handle handle)
+{
+    CpuLoad_Entry *entry;
+    unsigned int   i;
+
+    if (CpuLoad_count == 1) {
+        Display_printf(handle, 0, 0, "CPU load: no kernel hooks");
+        return;
+    }
+
+    Display_printf(handle, 0, 0, "CPU load: %u.%u%%", CpuLoad_total / 10,
+            CpuLoad_total % 10);
+    for (i = 0; i < CpuLoad_count; i++) {
+        entry = &CpuLoad_usage[i];
+        if (entry->name != NULL) {
+            Display_printf(handle, 0, 0, "  %s: %u.%u%%, peak %u.%u%%",
+                    entry->name, entry->load / 10, entry->load % 10,
+                    entry->peak / 10, entry->peak % 10);
+        }
+        else {
+            Display_printf(handle, 0, 0, "  %s 0x%x: %u.%u%%, peak %u.%u%%",
+                    (entry->kind == CpuLoad_KIND_SWI) ? "Swi" : "Hwi",
+                    entry->fxn, entry->load / 10, entry->load % 10,
+                    entry->peak / 10, entry->peak % 10);
+        }
+    }
+}
+
+/*
+ *  ======== CpuLoad_taskRegister ========
+ */
+void CpuLoad_taskRegister(Int id)
+{
+    CpuLoad_taskId = id;
+}
+
+/*
+ *  ======== CpuLoad_taskSwitch ========
+ */
+void CpuLoad_taskSwitch(Task_Handle prev, Task_Handle next)
+{
+    CpuLoad_Entry *entry;
+    UInt           key;
+
+    key = Hwi_disable();
+
+    entry = (CpuLoad_Entry *)Task_getHookContext(next, CpuLoad_taskId);
+    if (entry == NULL) {
+        if (next == Task_getIdleTask()) {
+            entry = CpuLoad_add("Idle", 0, CpuLoad_KIND_IDLE);
+        }
+        else {
+            entry = CpuLoad_add(Task_Handle_name(next), 0,
+                    CpuLoad_KIND_TASK);
+        }
+        Task_setHookContext(next, CpuLoad_taskId, entry);
+    }
+    CpuLoad_charge(entry);
+
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== CpuLoad_swiRegister ========
+ */
+void CpuLoad_swiRegister(Int id)
+{
+    CpuLoad_swiId = id;
+}
+
+/*
+ *  ======== CpuLoad_swiBegin ========
+ */
+void CpuLoad_swiBegin(Swi_Handle swi)
+{
+    CpuLoad_Entry *entry;
+    UArg           arg0;
+    UArg           arg1;
+    UInt           key;
+
+    key = Hwi_disable();
+
+    entry = (CpuLoad_Entry *)Swi_getHookContext(swi, CpuLoad_swiId);
+    if (entry == NULL) {
+        entry = CpuLoad_add(NULL,
+                (uintptr_t)Swi_getFunc(swi, &arg0, &arg1), CpuLoad_KIND_SWI);
+        Swi_setHookContext(swi, CpuLoad_swiId, entry);
+    }
+    CpuLoad_preempted[CpuLoad_depth++] = CpuLoad_current;
+    CpuLoad_charge(entry);
+
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== CpuLoad_swiEnd ========
+ */
+void CpuLoad_swiEnd(Swi_Handle swi)
+{
+    UInt key;
+
+    key = Hwi_disable();
+    CpuLoad_charge(CpuLoad_preempted[--CpuLoad_depth]);
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== CpuLoad_hwiRegister ========
+ */
+void CpuLoad_hwiRegister(Int id)
+{
+    CpuLoad_hwiId = id;
+}
+
+/*
+ *  ======== CpuLoad_hwiBegin ========
+ */
+void CpuLoad_hwiBegin(Hwi_Handle hwi)
+{
+    CpuLoad_Entry *entry;
+    UArg           arg;
+    UInt           key;
+
+    key = Hwi_disable();
+
+    entry = (CpuLoad_Entry *)Hwi_getHookContext(hwi, CpuLoad_hwiId);
+    if (entry == NULL) {
+        entry = CpuLoad_add(NULL, (uintptr_t)Hwi_getFunc(hwi, &arg),
+                CpuLoad_KIND_HWI);
+        Hwi_setHookContext(hwi, CpuLoad_hwiId, entry);
+    }
+    CpuLoad_preempted[CpuLoad_depth++] = CpuLoad_current;
+    CpuLoad_charge(entry);
+
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== CpuLoad_hwiEnd ========
+ */
+void CpuLoad_hwiEnd(Hwi_Handle hwi)
+{
+    UInt key;
+
+    key = Hwi_disable();
+    CpuLoad_charge(CpuLoad_preempted[--CpuLoad_depth]);
+    Hwi_restore(key);
+}
+
+/*
+ *  ======== CpuLoad_clockFxn ========
+ *  Closes the window. Only the snapshot is taken with interrupts disabled,
+ *  the divisions are done after.
+ */
+static void CpuLoad_clockFxn(uintptr_t arg)
+{
+    CpuLoad_Entry *entry;
+    uint32_t       cycles[CpuLoad_MAX_ENTRIES];
+    uint32_t       window;
+    uint32_t       idle = 0;
+    uint32_t       load;
+    unsigned int   count;
+    unsigned int   i;
+    UInt           key;
+
+    key = Hwi_disable();
+
+    /* Bring the running thread, this Swi, up to date */
+    CpuLoad_charge(CpuLoad_current);
+    window = CpuLoad_last - CpuLoad_windowStart;
+    CpuLoad_windowStart = CpuLoad_last;
+
+    count = CpuLoad_count;
+    for (i = 0; i < count; i++) {
+        cycles[i] = CpuLoad_usage[i].cycles - CpuLoad_usage[i].windowStart;
+        CpuLoad_usage[i].windowStart = CpuLoad_usage[i].cycles;
+    }
+
+    Hwi_restore(key);
+
+    if (window == 0) {
+        return;
+    }
+
+    for (i = 0; i < count; i++) {
+        entry = &CpuLoad_usage[i];
+        load  = (uint32_t)(((uint64_t)cycles[i] * 1000) / window);
+
+        entry->load = (uint16_t)load;
+        if (load > entry->peak) {
+            entry->peak = (uint16_t)load;
+        }
+        if (entry->kind == CpuLoad_KIND_IDLE) {
+            idle += load;
+        }
+    }
+    CpuLoad_total = (idle < 1000) ? (uint16_t)(1000 - idle) : 0;
+
+    if (!CpuLoad_log || (count == 1)) {
+        return;
+    }
+
+    Log_info2(LogMod_APP, "CPU load: %u.%u%%", CpuLoad_total / 10,
+            CpuLoad_total % 10);
+    for (i = 0; i < count; i++) {
+        entry = &CpuLoad_usage[i];
+        if (entry->name != NULL) {
+            Log_info3(LogMod_APP, "  %s: %u.%u%%", entry->name,
+                    entry->load / 10, entry->load % 10);
+        }
+        else {
+            Log_info4(LogMod_APP, "  %s 0x%x: %u.%u%%",
+                    (entry->kind == CpuLoad_KIND_SWI) ? "Swi" : "Hwi",
+                    entry->fxn, entry->load / 10, entry->load % 10);
+        }
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       CpuLoad.h
+ *
+ *  @brief      CPU time of every task, Swi and Hwi.
+ *
+ *  Kernel hooks read the DWT cycle counter whenever the CPU changes from
+ *  one thread to another and charge the cycles since the previous change
+ *  to the thread that ran. A hook adds a counter read, two stores and a
+ *  hook context lookup to each switch, Swi and interrupt. Interrupts are
+ *  charged to the Hwi that took them, so the time of the interrupted
+ *  thread is not inflated by its interrupts. Time in the Idle task is idle
+ *  time; the CPU load is everything else.
+ *
+ *  The hooks only run if they are added to the kernel configuration, the
+ *  .cfg file of the tirtos_builds project:
+ *
+ *  @code
+ *  var Task = xdc.useModule('ti.sysbios.knl.Task');
+ *  Task.addHookSet({
+ *      registerFxn: '&CpuLoad_taskRegister',
+ *      switchFxn: '&CpuLoad_taskSwitch'
+ *  });
+ *  var Swi = xdc.useModule('ti.sysbios.knl.Swi');
+ *  Swi.addHookSet({
+ *      registerFxn: '&CpuLoad_swiRegister',
+ *      beginFxn: '&CpuLoad_swiBegin',
+ *      endFxn: '&CpuLoad_swiEnd'
+ *  });
+ *  var Hwi = xdc.useModule('ti.sysbios.hal.Hwi');
+ *  Hwi.addHookSet({
+ *      registerFxn: '&CpuLoad_hwiRegister',
+ *      beginFxn: '&CpuLoad_hwiBegin',
+ *      endFxn: '&CpuLoad_hwiEnd'
+ *  });
+ *  @endcode
+ *
+ *  CpuLoad_start() turns the running totals into the load of each thread
+ *  over a fixed window, kept in CpuLoad_usage for the debugger's expression
+ *  view or ROV, and can log them every window. Tasks are listed by name,
+ *  Swis and Hwis by the address of their function, which the map file
+ *  resolves. The first entry takes the time before the first switch and
+ *  the threads beyond CpuLoad_MAX_ENTRIES.
+ *
+ *  The totals are 32-bit cycle counts, so the window must be shorter than
+ *  2^32 CPU cycles, 89 s at 48 MHz.
+ *
+ *  ============================================================================
+ */
+#ifndef __CPULOAD_H__
+#define __CPULOAD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/hal/Hwi.h>
+#include <ti/sysbios/knl/Swi.h>
+#include <ti/sysbios/knl/Task.h>
+
+/*! Largest number of entries, including the first one for the rest */
+#define CpuLoad_MAX_ENTRIES     16
+
+/*! CpuLoad_Entry.kind */
+#define CpuLoad_KIND_OTHER      0
+#define CpuLoad_KIND_TASK       1
+#define CpuLoad_KIND_IDLE       2
+#define CpuLoad_KIND_SWI        3
+#define CpuLoad_KIND_HWI        4
+
+/*!
+ *  @brief  CPU time of one thread
+ */
+typedef struct CpuLoad_Entry {
+    const char *name;        /*!< Task name, NULL for Swis and Hwis */
+    uintptr_t   fxn;         /*!< Swi or Hwi function */
+    uint8_t     kind;        /*!< CpuLoad_KIND_xxx */
+    uint16_t    load;        /*!< Tenths of a percent, last window */
+    uint16_t    peak;        /*!< Highest @p load so far */
+    uint32_t    cycles;      /*!< Running total, wraps around */
+    uint32_t    windowStart; /*!< @p cycles at the start of the window */
+} CpuLoad_Entry;
+
+/*! Accounted threads */
+extern CpuLoad_Entry CpuLoad_usage[CpuLoad_MAX_ENTRIES];
+
+/*! Valid entries of CpuLoad_usage */
+extern uint_least8_t CpuLoad_count;
+
+/*! Tenths of a percent not spent in the Idle task, last window */
+extern uint16_t CpuLoad_total;
+
+/*!
+ *  @brief  Update the loads every @p periodMs milliseconds from a clock
+ *
+ *  Enables the DWT cycle counter. With @p log set, every window is also
+ *  written as log records.
+ */
+extern void CpuLoad_start(uint32_t periodMs, bool log);
+
+/*!
+ *  @brief  Print the loads of the last window
+ */
+extern void CpuLoad_print(Display_Handle handle);
+
+/* Kernel hooks, see the configuration above */
+extern void CpuLoad_taskRegister(Int id);
+extern void CpuLoad_taskSwitch(Task_Handle prev, Task_Handle next);
+extern void CpuLoad_swiRegister(Int id);
+extern void CpuLoad_swiBegin(Swi_Handle swi);
+extern void CpuLoad_swiEnd(Swi_Handle swi);
+extern void CpuLoad_hwiRegister(Int id);
+extern void CpuLoad_hwiBegin(Hwi_Handle hwi);
+extern void CpuLoad_hwiEnd(Hwi_Handle hwi);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CPULOAD_H__ */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Crc16.h
+ *
+ *  @brief      CRC-16/CCITT-FALSE.
+ *
+ *  Polynomial 0x1021, initial value 0xFFFF, no reflection and no final XOR.
+ *  The check value of "123456789" is 0x29B1. The host side is
+ *  tools/remotecmd.py.
+ *
+ *  ============================================================================
+ */
+#ifndef __CRC16_H__
+#define __CRC16_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*! Initial value of a CRC computation */
+#define Crc16_INIT  0xFFFF
+
+/*!
+ *  @brief  Continue a CRC over @p len more bytes
+ *
+ *  @param  crc   Crc16_INIT, or the result of a previous call
+ *  @param  data  Data to add
+ *  @param  len   Number of bytes at @p data
+ *
+ *  @return The updated CRC.
+ */
+extern uint16_t Crc16_update(uint16_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRC16_H__ */
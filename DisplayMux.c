@@ -0,0 +1,571 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== DisplayMux.c ========
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+#include <ti/drivers/dpl/SystemP.h>
+
+#include "DisplayMux.h"
+#include "Fmt.h"
+
+extern const Display_Config Display_config[];
+
+void DisplayMux_init(Display_Handle handle);
+Display_Handle DisplayMux_open(Display_Handle handle, Display_Params *params);
+void DisplayMux_clear(Display_Handle handle);
+void DisplayMux_clearLines(Display_Handle handle, uint8_t fromLine,
+                           uint8_t toLine);
+void DisplayMux_vprintf(Display_Handle handle, uint8_t line, uint8_t column,
+                        char *fmt, va_list va);
+void DisplayMux_close(Display_Handle handle);
+int DisplayMux_control(Display_Handle handle, unsigned int cmd, void *arg);
+unsigned int DisplayMux_getType(void);
+
+static void DisplayMux_emit(Display_Handle sink, uint8_t line,
+                            uint8_t column, ...);
+static void DisplayMux_refresh(Display_Handle handle, unsigned int i);
+static void DisplayMux_store(Display_Handle handle, unsigned int i,
+                             uint8_t line, uint8_t column, const char *text);
+static void *DisplayMux_workerFxn(void *arg);
+
+const Display_FxnTable DisplayMux_fxnTable = {
+    DisplayMux_init,
+    DisplayMux_open,
+    DisplayMux_clear,
+    DisplayMux_clearLines,
+    DisplayMux_vprintf,
+    DisplayMux_close,
+    DisplayMux_control,
+    DisplayMux_getType,
+};
+
+/*
+ *  ======== ENTRY ========
+ *  Line cache entry of @p line: the column, then the text and a NUL.
+ */
+#define ENTRY(sink, line)   (&(sink)->lineCache[(line) * ((sink)->columns + 2)])
+
+/*
+ *  ======== DisplayMux_init ========
+ *  The sinks are initialized by Display_init() through their own entries.
+ */
+void DisplayMux_init(Display_Handle handle)
+{
+}
+
+/*
+ *  ======== DisplayMux_open ========
+ */
+Display_Handle DisplayMux_open(Display_Handle handle, Display_Params *params)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_Sink const    *sink;
+    DisplayMux_SinkState     *state;
+    Display_Handle            sinkHandle;
+    StaticThread_Config       worker;
+    bool                      deferred = false;
+    unsigned int              i;
+
+    if (object->isOpen) {
+        return (NULL);
+    }
+
+    memset(object, 0, sizeof(DisplayMux_Object));
+
+    for (i = 0; (i < hwAttrs->sinkCount) && (i < DisplayMux_MAX_SINKS); i++) {
+        sink  = &hwAttrs->sinks[i];
+        state = &object->sinks[i];
+
+        sinkHandle = &Display_config[sink->index];
+        state->handle = sinkHandle->fxnTablePtr->openFxn(sinkHandle, params);
+        if (state->handle == NULL) {
+            continue;
+        }
+
+        object->active |= 1U << i;
+
+        if (sink->minInterval != 0) {
+            state->interval =
+                (sink->minInterval * 1000 + ClockP_tickPeriod - 1) /
+                ClockP_tickPeriod;
+            state->lastRefresh = ClockP_getSystemTicks() - state->interval;
+            memset(sink->lineCache, 0,
+                    DisplayMux_LINE_CACHE_SIZE(sink->lines, sink->columns));
+            deferred = true;
+        }
+    }
+
+    if (object->active == 0) {
+        return (NULL);
+    }
+
+    SemaphoreP_constructBinary(&object->mutex, 1);
+    SemaphoreP_constructBinary(&object->workSem, 0);
+    object->isOpen = true;
+
+    if (deferred) {
+        worker.name      = "DisplayMux";
+        worker.fxn       = DisplayMux_workerFxn;
+        worker.arg       = (void *)handle;
+        worker.priority  = hwAttrs->workerPriority;
+        worker.stack     = hwAttrs->workerStack;
+        worker.stackSize = hwAttrs->workerStackSize;
+
+        if (!StaticThread_construct(&object->worker, &worker)) {
+            /* Direct sinks still work, deferred ones stay blank */
+            for (i = 0; i < hwAttrs->sinkCount; i++) {
+                if (hwAttrs->sinks[i].minInterval != 0) {
+                    object->active &= ~(1U << i);
+                }
+            }
+        }
+    }
+
+    return (handle);
+}
+
+/*
+ *  ======== DisplayMux_clear ========
+ */
+void DisplayMux_clear(Display_Handle handle)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_SinkState     *state;
+    bool                      post = false;
+    unsigned int              i;
+    unsigned int              line;
+
+    SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+
+    for (i = 0; i < hwAttrs->sinkCount; i++) {
+        state = &object->sinks[i];
+        if ((object->active & (1U << i)) == 0) {
+            continue;
+        }
+
+        if (hwAttrs->sinks[i].minInterval == 0) {
+            state->handle->fxnTablePtr->clearFxn(state->handle);
+            continue;
+        }
+
+        for (line = 0; line < hwAttrs->sinks[i].lines; line++) {
+            ENTRY(&hwAttrs->sinks[i], line)[1] = '\0';
+        }
+        state->clearPending = true;
+        state->dirty   = 0;
+        state->cleared = 0;
+        post = true;
+    }
+
+    SemaphoreP_post(&object->mutex);
+
+    if (post) {
+        SemaphoreP_post(&object->workSem);
+    }
+}
+
+/*
+ *  ======== DisplayMux_clearLines ========
+ */
+void DisplayMux_clearLines(Display_Handle handle, uint8_t fromLine,
+                           uint8_t toLine)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_Sink const    *sink;
+    DisplayMux_SinkState     *state;
+    bool                      post = false;
+    unsigned int              i;
+    unsigned int              line;
+
+    SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+
+    for (i = 0; i < hwAttrs->sinkCount; i++) {
+        sink  = &hwAttrs->sinks[i];
+        state = &object->sinks[i];
+        if ((object->active & (1U << i)) == 0) {
+            continue;
+        }
+
+        if (sink->minInterval == 0) {
+            state->handle->fxnTablePtr->clearLinesFxn(state->handle,
+                    fromLine, toLine);
+            continue;
+        }
+
+        for (line = fromLine; (line <= toLine) && (line < sink->lines);
+                line++) {
+            ENTRY(sink, line)[1] = '\0';
+            state->dirty   &= ~(1U << line);
+            state->cleared |= 1U << line;
+            post = true;
+        }
+    }
+
+    SemaphoreP_post(&object->mutex);
+
+    if (post) {
+        SemaphoreP_post(&object->workSem);
+    }
+}
+
+/*
+ *  ======== DisplayMux_vprintf ========
+ */
+void DisplayMux_vprintf(Display_Handle handle, uint8_t line, uint8_t column,
+                        char *fmt, va_list va)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_SinkState     *state;
+    bool                      post = false;
+    unsigned int              i;
+    int                       len;
+
+    SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+
+    len = Fmt_vsnprintf(hwAttrs->strBuf, hwAttrs->strBufLen, fmt, va);
+    if (len < 0) {
+        len = SystemP_vsnprintf(hwAttrs->strBuf, hwAttrs->strBufLen, fmt, va);
+    }
+    if (len >= hwAttrs->strBufLen) {
+        object->truncated++;
+    }
+    object->messages++;
+
+    for (i = 0; i < hwAttrs->sinkCount; i++) {
+        state = &object->sinks[i];
+        if ((object->active & (1U << i)) == 0) {
+            continue;
+        }
+
+        if (hwAttrs->sinks[i].minInterval == 0) {
+            DisplayMux_emit(state->handle, line, column, hwAttrs->strBuf);
+            state->stats.written++;
+        }
+        else {
+            DisplayMux_store(handle, i, line, column, hwAttrs->strBuf);
+            post = true;
+        }
+    }
+
+    SemaphoreP_post(&object->mutex);
+
+    if (post) {
+        SemaphoreP_post(&object->workSem);
+    }
+}
+
+/*
+ *  ======== DisplayMux_close ========
+ */
+void DisplayMux_close(Display_Handle handle)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    Display_Handle            sink;
+    unsigned int              i;
+
+    /* The worker's stack and struct are reused by the next open */
+    object->quit = true;
+    SemaphoreP_post(&object->workSem);
+    StaticThread_join(&object->worker);
+
+    SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+
+    for (i = 0; i < hwAttrs->sinkCount; i++) {
+        sink = object->sinks[i].handle;
+        if (sink != NULL) {
+            sink->fxnTablePtr->closeFxn(sink);
+            object->sinks[i].handle = NULL;
+        }
+    }
+    object->active = 0;
+
+    SemaphoreP_post(&object->mutex);
+
+    SemaphoreP_destruct(&object->workSem);
+    SemaphoreP_destruct(&object->mutex);
+    object->isOpen = false;
+}
+
+/*
+ *  ======== DisplayMux_control ========
+ */
+int DisplayMux_control(Display_Handle handle, unsigned int cmd, void *arg)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_Stats         *stats;
+    Display_Handle            sink;
+    int                       status = DISPLAY_STATUS_SUCCESS;
+    unsigned int              i;
+
+    SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+
+    switch (cmd) {
+        case DisplayMux_CMD_GET_STATS:
+            stats = (DisplayMux_Stats *)arg;
+            stats->messages  = object->messages;
+            stats->truncated = object->truncated;
+            stats->sinkCount = hwAttrs->sinkCount;
+            for (i = 0; i < hwAttrs->sinkCount; i++) {
+                stats->sinks[i] = object->sinks[i].stats;
+            }
+            break;
+
+        case DisplayMux_CMD_SET_ACTIVE:
+            for (i = 0; i < hwAttrs->sinkCount; i++) {
+                object->active &= ~(1U << i);
+                if ((*(uint32_t *)arg & (1U << i)) &&
+                        (object->sinks[i].handle != NULL)) {
+                    object->active |= 1U << i;
+                }
+            }
+            break;
+
+        case DISPLAY_CMD_TRANSPORT_CLOSE:
+        case DISPLAY_CMD_TRANSPORT_OPEN:
+            for (i = 0; i < hwAttrs->sinkCount; i++) {
+                sink = object->sinks[i].handle;
+                if ((sink != NULL) &&
+                        (sink->fxnTablePtr->controlFxn(sink, cmd, arg) ==
+                         DISPLAY_STATUS_ERROR)) {
+                    status = DISPLAY_STATUS_ERROR;
+                }
+            }
+            break;
+
+        default:
+            status = DISPLAY_STATUS_UNDEFINEDCMD;
+            break;
+    }
+
+    SemaphoreP_post(&object->mutex);
+
+    return (status);
+}
+
+/*
+ *  ======== DisplayMux_getType ========
+ */
+unsigned int DisplayMux_getType(void)
+{
+    return (Display_Type_UART | Display_Type_LCD);
+}
+
+/*
+ *  ======== DisplayMux_getSink ========
+ */
+Display_Handle DisplayMux_getSink(Display_Handle handle, uint32_t type)
+{
+    DisplayMux_Object        *object;
+    DisplayMux_HWAttrs const *hwAttrs;
+    Display_Handle            sink;
+    unsigned int              i;
+
+    if ((handle == NULL) || (handle->fxnTablePtr != &DisplayMux_fxnTable)) {
+        if ((handle != NULL) && (handle->fxnTablePtr->getTypeFxn() & type)) {
+            return (handle);
+        }
+        return (NULL);
+    }
+
+    object  = (DisplayMux_Object *)handle->object;
+    hwAttrs = (DisplayMux_HWAttrs const *)handle->hwAttrs;
+
+    for (i = 0; i < hwAttrs->sinkCount; i++) {
+        sink = object->sinks[i].handle;
+        if ((sink != NULL) && (sink->fxnTablePtr->getTypeFxn() & type)) {
+            return (sink);
+        }
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== DisplayMux_emit ========
+ *  Hand already formatted text, the only variable argument, to a sink.
+ */
+static void DisplayMux_emit(Display_Handle sink, uint8_t line,
+                            uint8_t column, ...)
+{
+    va_list va;
+
+    va_start(va, column);
+    sink->fxnTablePtr->vprintfFxn(sink, line, column, "%s", va);
+    va_end(va);
+}
+
+/*
+ *  ======== DisplayMux_store ========
+ *  Make @p text the latest content of @p line of deferred sink @p i.
+ *  Called with the mutex held.
+ */
+static void DisplayMux_store(Display_Handle handle, unsigned int i,
+                             uint8_t line, uint8_t column, const char *text)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_Sink const    *sink = &hwAttrs->sinks[i];
+    DisplayMux_SinkState     *state = &object->sinks[i];
+    char                     *entry;
+    size_t                    len;
+
+    if ((line >= sink->lines) || (line >= DisplayMux_MAX_LINES)) {
+        state->stats.dropped++;
+        return;
+    }
+
+    if (state->dirty & (1U << line)) {
+        state->stats.coalesced++;
+    }
+
+    len = strlen(text);
+    if (len > sink->columns) {
+        len = sink->columns;
+    }
+
+    entry = ENTRY(sink, line);
+    entry[0] = (char)column;
+    memcpy(&entry[1], text, len);
+    entry[1 + len] = '\0';
+
+    state->dirty |= 1U << line;
+    state->stats.written++;
+}
+
+/*
+ *  ======== DisplayMux_refresh ========
+ *  Render the pending clears and lines of deferred sink @p i. Each line is
+ *  copied out under the mutex and rendered without it, so that callers of
+ *  the mux never wait for the sink.
+ */
+static void DisplayMux_refresh(Display_Handle handle, unsigned int i)
+{
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_Sink const    *sink = &hwAttrs->sinks[i];
+    DisplayMux_SinkState     *state = &object->sinks[i];
+    Display_FxnTable const   *fxns = state->handle->fxnTablePtr;
+    char                      text[DisplayMux_MAX_COLUMNS + 1];
+    uint8_t                   column;
+    uint32_t                  cleared;
+    bool                      clear;
+    unsigned int              line;
+
+    SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+    clear   = state->clearPending;
+    cleared = state->cleared;
+    state->clearPending = false;
+    state->cleared      = 0;
+    SemaphoreP_post(&object->mutex);
+
+    if (clear) {
+        fxns->clearFxn(state->handle);
+    }
+
+    for (line = 0; cleared != 0; line++, cleared >>= 1) {
+        if (cleared & 1) {
+            fxns->clearLinesFxn(state->handle, line, line);
+        }
+    }
+
+    for (line = 0; (line < sink->lines) && (line < DisplayMux_MAX_LINES);
+            line++) {
+        SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+        if ((state->dirty & (1U << line)) == 0) {
+            SemaphoreP_post(&object->mutex);
+            continue;
+        }
+        state->dirty &= ~(1U << line);
+        column = (uint8_t)ENTRY(sink, line)[0];
+        strncpy(text, &ENTRY(sink, line)[1], DisplayMux_MAX_COLUMNS);
+        text[DisplayMux_MAX_COLUMNS] = '\0';
+        SemaphoreP_post(&object->mutex);
+
+        DisplayMux_emit(state->handle, line, column, text);
+    }
+
+    SemaphoreP_pend(&object->mutex, SemaphoreP_WAIT_FOREVER);
+    state->stats.refreshes++;
+    SemaphoreP_post(&object->mutex);
+}
+
+/*
+ *  ======== DisplayMux_workerFxn ========
+ *  Refresh every deferred sink with pending output once its interval since
+ *  the last refresh has passed.
+ */
+static void *DisplayMux_workerFxn(void *arg)
+{
+    Display_Handle            handle = (Display_Handle)arg;
+    DisplayMux_Object        *object = (DisplayMux_Object *)handle->object;
+    DisplayMux_HWAttrs const *hwAttrs =
+        (DisplayMux_HWAttrs const *)handle->hwAttrs;
+    DisplayMux_SinkState     *state;
+    uint32_t                  timeout = SemaphoreP_WAIT_FOREVER;
+    uint32_t                  elapsed;
+    uint32_t                  now;
+    unsigned int              i;
+
+    for (;;) {
+        SemaphoreP_pend(&object->workSem, timeout);
+        if (object->quit) {
+            break;
+        }
+
+        timeout = SemaphoreP_WAIT_FOREVER;
+        for (i = 0; i < hwAttrs->sinkCount; i++) {
+            state = &object->sinks[i];
+            if ((hwAttrs->sinks[i].minInterval == 0) ||
+                    ((object->active & (1U << i)) == 0) ||
+                    ((state->dirty == 0) && (state->cleared == 0) &&
+                     !state->clearPending)) {
+                continue;
+            }
+
+            now = ClockP_getSystemTicks();
+            elapsed = now - state->lastRefresh;
+            if (elapsed < state->interval) {
+                if (state->interval - elapsed < timeout) {
+                    timeout = state->interval - elapsed;
+                }
+                continue;
+            }
+
+            state->lastRefresh = now;
+            DisplayMux_refresh(handle, i);
+        }
+    }
+
+    return (NULL);
+}
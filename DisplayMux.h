@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       DisplayMux.h
+ *
+ *  @brief      Display implementation that formats a message once and
+ *              hands the text to several other displays.
+ *
+ *  The sinks are other entries of Display_config, listed by index in the
+ *  hardware attributes. DisplayMux opens them itself, so only the mux is
+ *  opened by the application; the board file lists it first so that
+ *  Display_open() with any sink type finds it.
+ *
+ *  Display_printf() formats into one buffer shared by all sinks and passes
+ *  the result to each sink as a "%s" argument, which the sinks copy
+ *  without parsing it again (see Fmt.h).
+ *
+ *  # Rate limiting #
+ *  A sink with a @p minInterval of 0 is written directly by the caller;
+ *  use that for sinks that do not block, such as DisplayUartDma. Any other
+ *  sink is deferred: the caller only stores the text as the latest content
+ *  of its line and returns. A worker thread renders all changed lines of
+ *  the sink at most once per @p minInterval, so a slow panel coalesces
+ *  fast updates of a line instead of delaying the caller or the UART.
+ *
+ *  The worker thread is only created when a deferred sink is listed; its
+ *  stack is provided by the board file. Display_close() stops it, dropping
+ *  output that a deferred sink has not rendered yet.
+ *
+ *  Display_control() passes DISPLAY_CMD_TRANSPORT_CLOSE and
+ *  DISPLAY_CMD_TRANSPORT_OPEN to every sink. Other sink specific commands
+ *  must be sent to the sink returned by DisplayMux_getSink().
+ *
+ *  DisplayMux must be called from Task context only.
+ *
+ *  ============================================================================
+ */
+#ifndef __DISPLAYMUX_H__
+#define __DISPLAYMUX_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "StaticThread.h"
+
+/*! Largest number of sinks of a DisplayMux instance */
+#define DisplayMux_MAX_SINKS        4
+
+/*! Largest number of lines of a deferred sink */
+#define DisplayMux_MAX_LINES        32
+
+/*! Largest number of characters per line of a deferred sink */
+#define DisplayMux_MAX_COLUMNS      32
+
+/*! Size of the line cache of a deferred sink */
+#define DisplayMux_LINE_CACHE_SIZE(lines, columns)  ((lines) * ((columns) + 2))
+
+/*!
+ *  @brief  Read the counters
+ *
+ *  @p arg of Display_control() must point to a DisplayMux_Stats.
+ */
+#define DisplayMux_CMD_GET_STATS    (DISPLAY_CMD_RESERVED + 16)
+
+/*!
+ *  @brief  Select the sinks that receive output
+ *
+ *  @p arg points to a uint32_t with bit n set for sink n. All sinks are
+ *  active after Display_open().
+ */
+#define DisplayMux_CMD_SET_ACTIVE   (DISPLAY_CMD_RESERVED + 17)
+
+/*!
+ *  @brief  A sink, in the DisplayMux hardware attributes
+ */
+typedef struct DisplayMux_Sink {
+    uint_least8_t  index;        /*!< Index in Display_config */
+    uint32_t       minInterval;  /*!< Milliseconds between refreshes, 0 to
+                                      write directly */
+    char          *lineCache;    /*!< DisplayMux_LINE_CACHE_SIZE() bytes,
+                                      deferred sinks only */
+    uint8_t        lines;        /*!< Lines kept in @p lineCache, at most
+                                      DisplayMux_MAX_LINES */
+    uint8_t        columns;      /*!< Characters kept per line, at most
+                                      DisplayMux_MAX_COLUMNS */
+} DisplayMux_Sink;
+
+/*!
+ *  @brief  Counters of one sink
+ */
+typedef struct DisplayMux_SinkStats {
+    uint32_t written;    /*!< Messages handed to the sink */
+    uint32_t coalesced;  /*!< Messages replaced by a newer one of the same
+                              line before they were rendered */
+    uint32_t dropped;    /*!< Messages for lines outside the line cache */
+    uint32_t refreshes;  /*!< Worker refreshes of a deferred sink */
+} DisplayMux_SinkStats;
+
+/*!
+ *  @brief  Counters of a DisplayMux instance
+ */
+typedef struct DisplayMux_Stats {
+    uint32_t             messages;   /*!< Messages formatted */
+    uint32_t             truncated;  /*!< Messages cut at the buffer size */
+    uint8_t              sinkCount;  /*!< Valid entries of @p sinks */
+    DisplayMux_SinkStats sinks[DisplayMux_MAX_SINKS];
+} DisplayMux_Stats;
+
+/*!
+ *  @brief  DisplayMux hardware attributes
+ */
+typedef struct DisplayMux_HWAttrs {
+    DisplayMux_Sink const *sinks;         /*!< Sinks, in output order */
+    uint8_t                sinkCount;     /*!< Entries of @p sinks */
+    char                  *strBuf;        /*!< Shared format buffer */
+    uint16_t               strBufLen;     /*!< Size of @p strBuf */
+    void                  *workerStack;   /*!< Worker stack, if a sink is
+                                               deferred */
+    size_t                 workerStackSize;
+    int                    workerPriority;
+} DisplayMux_HWAttrs;
+
+/*!
+ *  @brief  State of one sink
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct DisplayMux_SinkState {
+    Display_Handle         handle;
+    uint32_t               interval;
+    uint32_t               lastRefresh;
+    uint32_t               dirty;
+    uint32_t               cleared;
+    bool                   clearPending;
+    DisplayMux_SinkStats   stats;
+} DisplayMux_SinkState;
+
+/*!
+ *  @brief  DisplayMux object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct DisplayMux_Object {
+    SemaphoreP_Struct      mutex;
+    SemaphoreP_Struct      workSem;
+    StaticThread_Struct    worker;
+    bool                   isOpen;
+    volatile bool          quit;
+    uint32_t               active;
+    uint32_t               messages;
+    uint32_t               truncated;
+    DisplayMux_SinkState   sinks[DisplayMux_MAX_SINKS];
+} DisplayMux_Object;
+
+extern const Display_FxnTable DisplayMux_fxnTable;
+
+/*!
+ *  @brief  Get the sink of type @p type behind a display handle
+ *
+ *  Lets sink specific Display_control() commands reach the right sink.
+ *
+ *  @return The first sink of type @p type, or @p handle itself if it is
+ *          not a DisplayMux but of that type. NULL if there is none.
+ */
+extern Display_Handle DisplayMux_getSink(Display_Handle handle, uint32_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DISPLAYMUX_H__ */
@@ -0,0 +1,821 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== DisplaySharpDma.c ========
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/GPIO.h>
+#include <ti/drivers/SPI.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+#include <ti/drivers/dpl/SystemP.h>
+#include <ti/grlib/grlib.h>
+
+#include "DisplaySharpDma.h"
+#include "Fmt.h"
+
+/* Command bits, the first byte of every transfer */
+#define CMD_WRITE_LINE      0x80
+#define CMD_VCOM            0x40
+#define CMD_CLEAR_ALL       0x20
+
+/* Offsets within a framebuffer row, see DisplaySharpDma.h */
+#define ROW_PREFIX          0
+#define ROW_ADDRESS         1
+#define ROW_PIXELS          2
+
+/* Largest transfer the SPI driver moves with one uDMA transaction */
+#define MAX_SPI_TRANSFER    1024
+
+/* Fixed font, also used by DisplaySharp */
+#define FONT_WIDTH          6
+#define FONT_HEIGHT         8
+
+void DisplaySharpDma_init(Display_Handle handle);
+Display_Handle DisplaySharpDma_open(Display_Handle handle,
+                                    Display_Params *params);
+void DisplaySharpDma_clear(Display_Handle handle);
+void DisplaySharpDma_clearLines(Display_Handle handle, uint8_t fromLine,
+                                uint8_t toLine);
+void DisplaySharpDma_vprintf(Display_Handle handle, uint8_t line,
+                             uint8_t column, char *fmt, va_list va);
+void DisplaySharpDma_close(Display_Handle handle);
+int DisplaySharpDma_control(Display_Handle handle, unsigned int cmd,
+                            void *arg);
+unsigned int DisplaySharpDma_getType(void);
+
+static void DisplaySharpDma_pixelDraw(const Graphics_Display *pDisplay,
+                                      int16_t x, int16_t y, uint16_t value);
+static void DisplaySharpDma_pixelDrawMultiple(const Graphics_Display *pDisplay,
+                                              int16_t x, int16_t y, int16_t x0,
+                                              int16_t count, int16_t bPP,
+                                              const uint8_t *data,
+                                              const uint32_t *palette);
+static void DisplaySharpDma_lineDrawH(const Graphics_Display *pDisplay,
+                                      int16_t x1, int16_t x2, int16_t y,
+                                      uint16_t value);
+static void DisplaySharpDma_lineDrawV(const Graphics_Display *pDisplay,
+                                      int16_t x, int16_t y1, int16_t y2,
+                                      uint16_t value);
+static void DisplaySharpDma_rectFill(const Graphics_Display *pDisplay,
+                                     const Graphics_Rectangle *rect,
+                                     uint16_t value);
+static uint32_t DisplaySharpDma_colorTranslate(const Graphics_Display *pDisplay,
+                                               uint32_t value);
+static void DisplaySharpDma_flush(const Graphics_Display *pDisplay);
+static void DisplaySharpDma_clearDisplay(const Graphics_Display *pDisplay,
+                                         uint16_t value);
+static void DisplaySharpDma_busBegin(DisplaySharpDma_Object *object);
+static void DisplaySharpDma_busEnd(DisplaySharpDma_Object *object);
+static bool DisplaySharpDma_openSpi(Display_Handle handle);
+static void DisplaySharpDma_spiDoneFxn(SPI_Handle handle,
+                                       SPI_Transaction *transaction);
+static void DisplaySharpDma_vcomFxn(uintptr_t arg);
+static void DisplaySharpDma_send(DisplaySharpDma_Object *object,
+                                 uint8_t *buf, size_t len);
+static uint8_t DisplaySharpDma_setBits(uint8_t *p, uint8_t mask,
+                                       uint16_t value);
+
+const Display_FxnTable DisplaySharpDma_fxnTable = {
+    DisplaySharpDma_init,
+    DisplaySharpDma_open,
+    DisplaySharpDma_clear,
+    DisplaySharpDma_clearLines,
+    DisplaySharpDma_vprintf,
+    DisplaySharpDma_close,
+    DisplaySharpDma_control,
+    DisplaySharpDma_getType,
+};
+
+static const Graphics_Display_Functions DisplaySharpDma_grlibFxns = {
+    DisplaySharpDma_pixelDraw,
+    DisplaySharpDma_pixelDrawMultiple,
+    DisplaySharpDma_lineDrawH,
+    DisplaySharpDma_lineDrawV,
+    DisplaySharpDma_rectFill,
+    DisplaySharpDma_colorTranslate,
+    DisplaySharpDma_flush,
+    DisplaySharpDma_clearDisplay,
+};
+
+/*
+ *  ======== ROW ========
+ *  Start of framebuffer row @p y.
+ */
+#define ROW(object, y)  (&(object)->frame[(uint32_t)(y) * (object)->stride])
+
+/*
+ *  ======== MARK_DIRTY ========
+ */
+#define MARK_DIRTY(object, y)                   \
+    do {                                        \
+        if ((y) < (object)->dirtyFirst) {       \
+            (object)->dirtyFirst = (y);         \
+        }                                       \
+        if ((y) > (object)->dirtyLast) {        \
+            (object)->dirtyLast = (y);          \
+        }                                       \
+    } while (0)
+
+/*
+ *  ======== DisplaySharpDma_init ========
+ */
+void DisplaySharpDma_init(Display_Handle handle)
+{
+    GPIO_init();
+    SPI_init();
+}
+
+/*
+ *  ======== DisplaySharpDma_open ========
+ */
+Display_Handle DisplaySharpDma_open(Display_Handle handle,
+                                    Display_Params *params)
+{
+    DisplaySharpDma_Object        *object =
+        (DisplaySharpDma_Object *)handle->object;
+    DisplaySharpDma_HWAttrs const *hwAttrs =
+        (DisplaySharpDma_HWAttrs const *)handle->hwAttrs;
+    ClockP_Params                  clockParams;
+    uint32_t                       period;
+    uint8_t                       *row;
+    uint8_t                        address;
+    uint16_t                       y;
+    int                            bit;
+
+    object->frame         = hwAttrs->displayBuf;
+    object->stride        = DisplaySharpDma_STRIDE(hwAttrs->pixelWidth);
+    object->height        = hwAttrs->pixelHeight;
+    object->lineClearMode = params->lineClearMode;
+    object->csPin         = hwAttrs->csPin;
+    object->vcom          = 0;
+    object->busy          = false;
+    object->vcomActive    = false;
+    memset(&object->stats, 0, sizeof(object->stats));
+
+    SemaphoreP_constructBinary(&object->spiDone, 0);
+    if (!DisplaySharpDma_openSpi(handle)) {
+        SemaphoreP_destruct(&object->spiDone);
+        return (NULL);
+    }
+
+    /*
+     * Rows are white and the panel contents are unknown, so the first
+     * refresh clears the panel.
+     */
+    for (y = 0; y < object->height; y++) {
+        row = ROW(object, y);
+
+        /* Row addresses start at 1 and are sent LSB first */
+        address = 0;
+        for (bit = 0; bit < 8; bit++) {
+            if ((y + 1) & (1 << bit)) {
+                address |= 0x80 >> bit;
+            }
+        }
+
+        row[ROW_PREFIX]  = 0x00;
+        row[ROW_ADDRESS] = address;
+        memset(&row[ROW_PIXELS], 0xFF, object->stride - ROW_PIXELS);
+    }
+    ROW(object, object->height)[0] = 0x00;
+    ROW(object, object->height)[1] = 0x00;
+
+    object->dirtyFirst   = object->height;
+    object->dirtyLast    = 0;
+    object->clearPending = true;
+
+    SemaphoreP_constructBinary(&object->lcdMutex, 1);
+
+    GPIO_setConfig(hwAttrs->csPin, GPIO_CFG_OUTPUT | GPIO_CFG_OUT_LOW);
+    GPIO_setConfig(hwAttrs->powerPin, GPIO_CFG_OUTPUT | GPIO_CFG_OUT_HIGH);
+    GPIO_setConfig(hwAttrs->enablePin, GPIO_CFG_OUTPUT | GPIO_CFG_OUT_HIGH);
+
+    object->g_sDisplay.size        = sizeof(Graphics_Display);
+    object->g_sDisplay.displayData = object;
+    object->g_sDisplay.width       = hwAttrs->pixelWidth;
+    object->g_sDisplay.heigth      = hwAttrs->pixelHeight;
+
+    Graphics_initContext(&object->g_sContext, &object->g_sDisplay,
+            (Graphics_Display_Functions *)&DisplaySharpDma_grlibFxns);
+    Graphics_setFont(&object->g_sContext, &g_sFontFixed6x8);
+    Graphics_setForegroundColor(&object->g_sContext, GRAPHICS_COLOR_BLACK);
+    Graphics_setBackgroundColor(&object->g_sContext, GRAPHICS_COLOR_WHITE);
+    Graphics_flushBuffer(&object->g_sContext);
+
+    period = DisplaySharpDma_VCOM_PERIOD_MS * 1000 / ClockP_tickPeriod;
+    ClockP_Params_init(&clockParams);
+    clockParams.period = period;
+    clockParams.arg    = (uintptr_t)object;
+    ClockP_construct(&object->vcomClock, DisplaySharpDma_vcomFxn, period,
+                     &clockParams);
+    ClockP_start(&object->vcomClock);
+
+    return (handle);
+}
+
+/*
+ *  ======== DisplaySharpDma_clear ========
+ */
+void DisplaySharpDma_clear(Display_Handle handle)
+{
+    DisplaySharpDma_Object *object = (DisplaySharpDma_Object *)handle->object;
+
+    if (SemaphoreP_pend(&object->lcdMutex, SemaphoreP_WAIT_FOREVER) ==
+            SemaphoreP_OK) {
+        Graphics_clearDisplay(&object->g_sContext);
+        Graphics_flushBuffer(&object->g_sContext);
+        SemaphoreP_post(&object->lcdMutex);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_clearLines ========
+ */
+void DisplaySharpDma_clearLines(Display_Handle handle, uint8_t fromLine,
+                                uint8_t toLine)
+{
+    DisplaySharpDma_Object *object = (DisplaySharpDma_Object *)handle->object;
+    Graphics_Rectangle      rect;
+
+    if (toLine < fromLine) {
+        toLine = fromLine;
+    }
+
+    rect.xMin = 0;
+    rect.xMax = object->g_sDisplay.width - 1;
+    rect.yMin = fromLine * FONT_HEIGHT;
+    rect.yMax = ((toLine + 1) * FONT_HEIGHT) - 1;
+
+    if (SemaphoreP_pend(&object->lcdMutex, SemaphoreP_WAIT_FOREVER) ==
+            SemaphoreP_OK) {
+        Graphics_setForegroundColor(&object->g_sContext, GRAPHICS_COLOR_WHITE);
+        Graphics_fillRectangle(&object->g_sContext, &rect);
+        Graphics_setForegroundColor(&object->g_sContext, GRAPHICS_COLOR_BLACK);
+        Graphics_flushBuffer(&object->g_sContext);
+        SemaphoreP_post(&object->lcdMutex);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_vprintf ========
+ *  The text is drawn opaque, so only the parts of the line outside of it
+ *  are cleared. Clearing under the text first would make every row of the
+ *  line dirty even when the text did not change.
+ */
+void DisplaySharpDma_vprintf(Display_Handle handle, uint8_t line,
+                             uint8_t column, char *fmt, va_list va)
+{
+    DisplaySharpDma_Object *object = (DisplaySharpDma_Object *)handle->object;
+    Graphics_Rectangle      rect;
+    int16_t                 xp;
+    int16_t                 yp;
+    int16_t                 xEnd;
+    int16_t                 clearMin;
+    int16_t                 clearMax;
+    char                    str[24];
+
+    xp = (column * FONT_WIDTH) + 1;
+    yp = line * FONT_HEIGHT;
+
+    if (Fmt_vsnprintf(str, sizeof(str), fmt, va) < 0) {
+        SystemP_vsnprintf(str, sizeof(str), fmt, va);
+    }
+    xEnd = xp + ((int16_t)strlen(str) * FONT_WIDTH);
+
+    clearMin = xp;
+    clearMax = xEnd - 1;
+    switch (object->lineClearMode) {
+        case DISPLAY_CLEAR_LEFT:
+            clearMin = 0;
+            break;
+
+        case DISPLAY_CLEAR_RIGHT:
+            clearMax = object->g_sDisplay.width - 1;
+            break;
+
+        case DISPLAY_CLEAR_BOTH:
+            clearMin = 0;
+            clearMax = object->g_sDisplay.width - 1;
+            break;
+
+        default:
+            break;
+    }
+
+    rect.yMin = yp;
+    rect.yMax = yp + FONT_HEIGHT - 1;
+
+    if (SemaphoreP_pend(&object->lcdMutex, SemaphoreP_WAIT_FOREVER) ==
+            SemaphoreP_OK) {
+        Graphics_setForegroundColor(&object->g_sContext, GRAPHICS_COLOR_WHITE);
+        if (clearMin < xp) {
+            rect.xMin = clearMin;
+            rect.xMax = xp - 1;
+            Graphics_fillRectangle(&object->g_sContext, &rect);
+        }
+        if (clearMax >= xEnd) {
+            rect.xMin = xEnd;
+            rect.xMax = clearMax;
+            Graphics_fillRectangle(&object->g_sContext, &rect);
+        }
+        Graphics_setForegroundColor(&object->g_sContext, GRAPHICS_COLOR_BLACK);
+
+        Graphics_drawString(&object->g_sContext, (int8_t *)str,
+                GRAPHICS_AUTO_STRING_LENGTH, xp, yp, GRAPHICS_OPAQUE_TEXT);
+        Graphics_flushBuffer(&object->g_sContext);
+        SemaphoreP_post(&object->lcdMutex);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_close ========
+ */
+void DisplaySharpDma_close(Display_Handle handle)
+{
+    DisplaySharpDma_Object        *object =
+        (DisplaySharpDma_Object *)handle->object;
+    DisplaySharpDma_HWAttrs const *hwAttrs =
+        (DisplaySharpDma_HWAttrs const *)handle->hwAttrs;
+
+    ClockP_stop(&object->vcomClock);
+    ClockP_destruct(&object->vcomClock);
+
+    GPIO_write(hwAttrs->enablePin, 0);
+    GPIO_write(hwAttrs->powerPin, 0);
+
+    DisplaySharpDma_busBegin(object);
+    if (object->hSpi != NULL) {
+        SPI_close(object->hSpi);
+        object->hSpi = NULL;
+    }
+    DisplaySharpDma_busEnd(object);
+
+    SemaphoreP_destruct(&object->spiDone);
+    SemaphoreP_destruct(&object->lcdMutex);
+}
+
+/*
+ *  ======== DisplaySharpDma_control ========
+ */
+int DisplaySharpDma_control(Display_Handle handle, unsigned int cmd,
+                            void *arg)
+{
+    DisplaySharpDma_Object *object = (DisplaySharpDma_Object *)handle->object;
+    int                     status = DISPLAY_STATUS_SUCCESS;
+
+    if (SemaphoreP_pend(&object->lcdMutex, SemaphoreP_WAIT_FOREVER) !=
+            SemaphoreP_OK) {
+        return (DISPLAY_STATUS_ERROR);
+    }
+
+    switch (cmd) {
+        case DISPLAY_CMD_TRANSPORT_CLOSE:
+            DisplaySharpDma_busBegin(object);
+            if (object->hSpi != NULL) {
+                SPI_close(object->hSpi);
+                object->hSpi = NULL;
+            }
+            DisplaySharpDma_busEnd(object);
+            break;
+
+        case DISPLAY_CMD_TRANSPORT_OPEN:
+            if (object->hSpi == NULL) {
+                if (DisplaySharpDma_openSpi(handle)) {
+                    /* Send what was drawn while the bus was away */
+                    Graphics_flushBuffer(&object->g_sContext);
+                }
+                else {
+                    status = DISPLAY_STATUS_ERROR;
+                }
+            }
+            break;
+
+        case DisplaySharpDma_CMD_GET_STATS:
+            *(DisplaySharpDma_Stats *)arg = object->stats;
+            break;
+
+        case DisplaySharpDma_CMD_INVALIDATE:
+            object->dirtyFirst = 0;
+            object->dirtyLast  = object->height - 1;
+            break;
+
+        default:
+            status = DISPLAY_STATUS_UNDEFINEDCMD;
+            break;
+    }
+
+    SemaphoreP_post(&object->lcdMutex);
+
+    return (status);
+}
+
+/*
+ *  ======== DisplaySharpDma_getType ========
+ */
+unsigned int DisplaySharpDma_getType(void)
+{
+    return (Display_Type_LCD | Display_Type_GRLIB);
+}
+
+/*
+ *  ======== DisplaySharpDma_busBegin ========
+ *  Keep the VCOM clock off the bus, and wait for a command it is sending.
+ */
+static void DisplaySharpDma_busBegin(DisplaySharpDma_Object *object)
+{
+    uintptr_t key;
+    bool      wait;
+
+    key = HwiP_disable();
+    object->busy = true;
+    wait = object->vcomActive;
+    HwiP_restore(key);
+
+    if (wait) {
+        SemaphoreP_pend(&object->spiDone, SemaphoreP_WAIT_FOREVER);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_busEnd ========
+ */
+static void DisplaySharpDma_busEnd(DisplaySharpDma_Object *object)
+{
+    object->busy = false;
+}
+
+/*
+ *  ======== DisplaySharpDma_openSpi ========
+ *  Callback mode, so that the VCOM clock can send from its Swi.
+ */
+static bool DisplaySharpDma_openSpi(Display_Handle handle)
+{
+    DisplaySharpDma_Object        *object =
+        (DisplaySharpDma_Object *)handle->object;
+    DisplaySharpDma_HWAttrs const *hwAttrs =
+        (DisplaySharpDma_HWAttrs const *)handle->hwAttrs;
+    SPI_Params                     spiParams;
+
+    SPI_Params_init(&spiParams);
+    spiParams.bitRate     = hwAttrs->bitRate;
+    spiParams.frameFormat = SPI_POL0_PHA0;
+    spiParams.dataSize    = 8;
+    spiParams.transferMode        = SPI_MODE_CALLBACK;
+    spiParams.transferCallbackFxn = DisplaySharpDma_spiDoneFxn;
+
+    object->hSpi = SPI_open(hwAttrs->spiIndex, &spiParams);
+
+    return (object->hSpi != NULL);
+}
+
+/*
+ *  ======== DisplaySharpDma_spiDoneFxn ========
+ *  Wakes the refresh waiting for its transfer, or ends a VCOM command.
+ */
+static void DisplaySharpDma_spiDoneFxn(SPI_Handle handle,
+                                       SPI_Transaction *transaction)
+{
+    DisplaySharpDma_Object *object =
+        (DisplaySharpDma_Object *)transaction->arg;
+    uintptr_t               key;
+    bool                    post = true;
+
+    if (transaction == &object->vcomTransaction) {
+        GPIO_write(object->csPin, 0);
+
+        key = HwiP_disable();
+        object->vcomActive = false;
+        post = object->busy;
+        HwiP_restore(key);
+    }
+
+    if (post) {
+        SemaphoreP_post(&object->spiDone);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_vcomFxn ========
+ *  Inverts VCOM of a static screen, in the clock's Swi.
+ */
+static void DisplaySharpDma_vcomFxn(uintptr_t arg)
+{
+    DisplaySharpDma_Object *object = (DisplaySharpDma_Object *)arg;
+    uintptr_t               key;
+
+    key = HwiP_disable();
+    if (object->busy || object->vcomActive || object->hSpi == NULL) {
+        /* A refresh inverts it anyway */
+        HwiP_restore(key);
+        return;
+    }
+    object->vcomActive = true;
+    HwiP_restore(key);
+
+    object->vcomCmd[0] = object->vcom;
+    object->vcomCmd[1] = 0x00;
+    object->vcom ^= CMD_VCOM;
+
+    object->vcomTransaction.count = sizeof(object->vcomCmd);
+    object->vcomTransaction.txBuf = object->vcomCmd;
+    object->vcomTransaction.rxBuf = NULL;
+    object->vcomTransaction.arg   = object;
+
+    GPIO_write(object->csPin, 1);
+    if (SPI_transfer(object->hSpi, &object->vcomTransaction)) {
+        object->stats.vcoms++;
+        object->stats.bytes += sizeof(object->vcomCmd);
+    }
+    else {
+        GPIO_write(object->csPin, 0);
+        object->vcomActive = false;
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_send ========
+ *  Send @p len bytes in as few uDMA transactions as possible, with the chip
+ *  select (active high) held throughout. Called between
+ *  DisplaySharpDma_busBegin() and DisplaySharpDma_busEnd().
+ */
+static void DisplaySharpDma_send(DisplaySharpDma_Object *object,
+                                 uint8_t *buf, size_t len)
+{
+    SPI_Transaction transaction;
+
+    object->stats.bytes += len;
+
+    GPIO_write(object->csPin, 1);
+
+    while (len > 0) {
+        transaction.count = (len > MAX_SPI_TRANSFER) ? MAX_SPI_TRANSFER : len;
+        transaction.txBuf = buf;
+        transaction.rxBuf = NULL;
+        transaction.arg   = object;
+
+        if (!SPI_transfer(object->hSpi, &transaction)) {
+            break;
+        }
+        SemaphoreP_pend(&object->spiDone, SemaphoreP_WAIT_FOREVER);
+
+        buf += transaction.count;
+        len -= transaction.count;
+    }
+
+    GPIO_write(object->csPin, 0);
+
+    /* The panel wants VCOM inverted regularly to avoid a DC bias */
+    object->vcom ^= CMD_VCOM;
+}
+
+/*
+ *  ======== DisplaySharpDma_setBits ========
+ *  Set the bits in @p mask of @p *p to white (@p value 1) or black.
+ *
+ *  @return Non-zero if the byte changed.
+ */
+static uint8_t DisplaySharpDma_setBits(uint8_t *p, uint8_t mask,
+                                       uint16_t value)
+{
+    uint8_t old = *p;
+    uint8_t updated = (value != 0) ? (old | mask) : (old & ~mask);
+
+    *p = updated;
+
+    return (old ^ updated);
+}
+
+/*
+ *  ======== DisplaySharpDma_pixelDraw ========
+ */
+static void DisplaySharpDma_pixelDraw(const Graphics_Display *pDisplay,
+                                      int16_t x, int16_t y, uint16_t value)
+{
+    DisplaySharpDma_Object *object =
+        (DisplaySharpDma_Object *)pDisplay->displayData;
+    uint8_t                *p = &ROW(object, y)[ROW_PIXELS + (x >> 3)];
+
+    if (DisplaySharpDma_setBits(p, 0x80 >> (x & 7), value)) {
+        MARK_DIRTY(object, y);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_pixelDrawMultiple ========
+ *  Draw @p count pixels of a palettized image row. @p x0 is the index of
+ *  the first pixel within the first byte of @p data.
+ */
+static void DisplaySharpDma_pixelDrawMultiple(const Graphics_Display *pDisplay,
+                                              int16_t x, int16_t y, int16_t x0,
+                                              int16_t count, int16_t bPP,
+                                              const uint8_t *data,
+                                              const uint32_t *palette)
+{
+    DisplaySharpDma_Object *object =
+        (DisplaySharpDma_Object *)pDisplay->displayData;
+    uint8_t                *row = &ROW(object, y)[ROW_PIXELS];
+    uint8_t                 changed = 0;
+    uint32_t                index;
+    uint8_t                 byte;
+    int16_t                 perByte;
+    int16_t                 shift;
+
+    bPP &= 0xFF;
+    if ((bPP != 1) && (bPP != 4) && (bPP != 8)) {
+        return;
+    }
+    perByte = 8 / bPP;
+
+    while (count > 0) {
+        byte = *data++;
+
+        for (; (x0 < perByte) && (count > 0); x0++, count--, x++) {
+            shift = 8 - (bPP * (x0 + 1));
+            index = (byte >> shift) & ((1U << bPP) - 1);
+            changed |= DisplaySharpDma_setBits(&row[x >> 3], 0x80 >> (x & 7),
+                    palette[index]);
+        }
+        x0 = 0;
+    }
+
+    if (changed) {
+        MARK_DIRTY(object, y);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_lineDrawH ========
+ */
+static void DisplaySharpDma_lineDrawH(const Graphics_Display *pDisplay,
+                                      int16_t x1, int16_t x2, int16_t y,
+                                      uint16_t value)
+{
+    DisplaySharpDma_Object *object =
+        (DisplaySharpDma_Object *)pDisplay->displayData;
+    uint8_t                *row = &ROW(object, y)[ROW_PIXELS];
+    uint8_t                 changed = 0;
+    uint8_t                 firstMask = 0xFF >> (x1 & 7);
+    uint8_t                 lastMask = 0xFF << (7 - (x2 & 7));
+    int16_t                 first = x1 >> 3;
+    int16_t                 last = x2 >> 3;
+    int16_t                 i;
+
+    if (first == last) {
+        changed = DisplaySharpDma_setBits(&row[first], firstMask & lastMask,
+                value);
+    }
+    else {
+        changed  = DisplaySharpDma_setBits(&row[first], firstMask, value);
+        for (i = first + 1; i < last; i++) {
+            changed |= DisplaySharpDma_setBits(&row[i], 0xFF, value);
+        }
+        changed |= DisplaySharpDma_setBits(&row[last], lastMask, value);
+    }
+
+    if (changed) {
+        MARK_DIRTY(object, y);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_lineDrawV ========
+ */
+static void DisplaySharpDma_lineDrawV(const Graphics_Display *pDisplay,
+                                      int16_t x, int16_t y1, int16_t y2,
+                                      uint16_t value)
+{
+    for (; y1 <= y2; y1++) {
+        DisplaySharpDma_pixelDraw(pDisplay, x, y1, value);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_rectFill ========
+ */
+static void DisplaySharpDma_rectFill(const Graphics_Display *pDisplay,
+                                     const Graphics_Rectangle *rect,
+                                     uint16_t value)
+{
+    int16_t y;
+
+    for (y = rect->yMin; y <= rect->yMax; y++) {
+        DisplaySharpDma_lineDrawH(pDisplay, rect->xMin, rect->xMax, y, value);
+    }
+}
+
+/*
+ *  ======== DisplaySharpDma_colorTranslate ========
+ *  Map a 24-bit RGB color to white (1) or black (0) by its luminance.
+ */
+static uint32_t DisplaySharpDma_colorTranslate(const Graphics_Display *pDisplay,
+                                               uint32_t value)
+{
+    return (((((value >> 16) & 0xFF) * 19661) +
+             (((value >> 8) & 0xFF) * 38666) +
+             ((value & 0xFF) * 7209)) / (65536 * 128));
+}
+
+/*
+ *  ======== DisplaySharpDma_flush ========
+ *  Send the rows from the first to the last dirty one in one transfer.
+ *
+ *  The transfer starts with the command in the prefix byte of the first
+ *  row and ends with the two bytes after the last row. If rows follow, the
+ *  second of those is their address, which is zeroed for the transfer.
+ */
+static void DisplaySharpDma_flush(const Graphics_Display *pDisplay)
+{
+    DisplaySharpDma_Object *object =
+        (DisplaySharpDma_Object *)pDisplay->displayData;
+    uint8_t                 clear[2];
+    uint8_t                *start;
+    uint8_t                *end;
+    uint8_t                 address;
+    uint16_t                rows;
+
+    if (object->hSpi == NULL) {
+        /* Transport closed, keep the dirty rows for later */
+        return;
+    }
+
+    DisplaySharpDma_busBegin(object);
+
+    if (object->clearPending) {
+        clear[0] = CMD_CLEAR_ALL | object->vcom;
+        clear[1] = 0x00;
+        DisplaySharpDma_send(object, clear, sizeof(clear));
+        object->clearPending = false;
+        object->stats.clears++;
+    }
+
+    if (object->dirtyFirst > object->dirtyLast) {
+        DisplaySharpDma_busEnd(object);
+        return;
+    }
+
+    rows  = object->dirtyLast - object->dirtyFirst + 1;
+    start = ROW(object, object->dirtyFirst);
+    end   = ROW(object, object->dirtyLast + 1);
+
+    address = end[ROW_ADDRESS];
+    end[ROW_ADDRESS] = 0x00;
+    start[ROW_PREFIX] = CMD_WRITE_LINE | object->vcom;
+
+    DisplaySharpDma_send(object, start, (end - start) + 2);
+
+    start[ROW_PREFIX] = 0x00;
+    end[ROW_ADDRESS] = address;
+
+    object->stats.refreshes++;
+    object->stats.rows += rows;
+
+    object->dirtyFirst = object->height;
+    object->dirtyLast  = 0;
+
+    DisplaySharpDma_busEnd(object);
+}
+
+/*
+ *  ======== DisplaySharpDma_clearDisplay ========
+ *  Clearing to white is left to the panel's "all clear" command, so only
+ *  rows drawn afterwards become dirty.
+ */
+static void DisplaySharpDma_clearDisplay(const Graphics_Display *pDisplay,
+                                         uint16_t value)
+{
+    DisplaySharpDma_Object *object =
+        (DisplaySharpDma_Object *)pDisplay->displayData;
+    uint16_t                y;
+
+    if (value != 0) {
+        for (y = 0; y < object->height; y++) {
+            memset(&ROW(object, y)[ROW_PIXELS], 0xFF,
+                    object->stride - ROW_PIXELS);
+        }
+        object->clearPending = true;
+        object->dirtyFirst   = object->height;
+        object->dirtyLast    = 0;
+    }
+    else {
+        for (y = 0; y < object->height; y++) {
+            DisplaySharpDma_lineDrawH(pDisplay, 0,
+                    ((object->stride - ROW_PIXELS) * 8) - 1, y, value);
+        }
+    }
+}
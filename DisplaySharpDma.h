@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       DisplaySharpDma.h
+ *
+ *  @brief      Sharp memory LCD Display implementation that only sends
+ *              modified lines.
+ *
+ *  Drop-in replacement for DisplaySharp with the same text output: GrLib
+ *  renders into a framebuffer with a 6x8 fixed font and the buffer is sent
+ *  to the panel after every Display_printf() or Display_clear().
+ *
+ *  # Dirty lines #
+ *  Every drawing primitive compares the bytes it changes with the old
+ *  contents and records the first and last pixel row that actually
+ *  differs. A refresh sends only the rows from the first to the last dirty
+ *  one; rows in between that did not change are sent as well, so that the
+ *  refresh stays a single SPI transfer. Redrawing a value that did not
+ *  change sends nothing, and changing a few digits of a status line
+ *  typically sends only the 5-8 rows that the glyphs differ in.
+ *
+ *  Clearing the screen uses the panel's "all clear" command, which is two
+ *  bytes on the wire instead of a full frame.
+ *
+ *  # Framebuffer layout #
+ *  The framebuffer is kept in the format the panel expects on the wire, so
+ *  that the uDMA can send any range of rows straight from it. Each row
+ *  takes DisplaySharpDma_STRIDE(width) bytes:
+ *
+ *  | Offset | Size      | Content                                       |
+ *  |--------|-----------|-----------------------------------------------|
+ *  | 0      | 1         | Trailer of the previous row, or the command   |
+ *  | 1      | 1         | Row address, bit reversed                     |
+ *  | 2      | width / 8 | Pixels, MSB is the leftmost, 1 is white       |
+ *
+ *  followed by two bytes for the trailer of the last row and of the
+ *  transfer. The board file allocates DisplaySharpDma_BUF_SIZE() bytes.
+ *
+ *  # VCOM #
+ *  The panel needs its VCOM polarity inverted regularly, or a DC bias
+ *  builds up in the liquid crystal. Every transfer inverts it, and a clock
+ *  sends a VCOM-only command every DisplaySharpDma_VCOM_PERIOD_MS so that a
+ *  static screen is inverted as well. The clock runs in a Swi and the SPI
+ *  is used in callback mode for that reason; the command is skipped while
+ *  a refresh is sending or the transport is closed.
+ *
+ *  # Shared SPI bus #
+ *  The LaunchPad has the LCD and the external flash on SPI0. Send
+ *  DISPLAY_CMD_TRANSPORT_CLOSE before opening the other device and
+ *  DISPLAY_CMD_TRANSPORT_OPEN after closing it. While the transport is
+ *  closed drawing continues in the framebuffer and the dirty rows are sent
+ *  once it is opened again.
+ *
+ *  ============================================================================
+ */
+#ifndef __DISPLAYSHARPDMA_H__
+#define __DISPLAYSHARPDMA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/SPI.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+#include <ti/grlib/grlib.h>
+
+/*! Interval of the VCOM-only command, in ms */
+#ifndef DisplaySharpDma_VCOM_PERIOD_MS
+#define DisplaySharpDma_VCOM_PERIOD_MS  1000
+#endif
+
+/*! Framebuffer bytes per pixel row of a panel @p width pixels wide */
+#define DisplaySharpDma_STRIDE(width)   (((width) / 8) + 2)
+
+/*! Framebuffer size of a @p width x @p height panel */
+#define DisplaySharpDma_BUF_SIZE(width, height) \
+    ((DisplaySharpDma_STRIDE(width) * (height)) + 2)
+
+/*!
+ *  @brief  Read the refresh counters
+ *
+ *  @p arg of Display_control() must point to a DisplaySharpDma_Stats.
+ */
+#define DisplaySharpDma_CMD_GET_STATS   (DISPLAY_CMD_RESERVED + 0)
+
+/*!
+ *  @brief  Send every row with the next refresh
+ *
+ *  Recovers from a panel that lost its contents, and gives the cost of a
+ *  full refresh for comparison. @p arg is not used.
+ */
+#define DisplaySharpDma_CMD_INVALIDATE  (DISPLAY_CMD_RESERVED + 1)
+
+/*!
+ *  @brief  Refresh counters of a DisplaySharpDma instance
+ */
+typedef struct DisplaySharpDma_Stats {
+    uint32_t refreshes;  /*!< Refreshes that sent at least one row */
+    uint32_t clears;     /*!< "All clear" commands sent */
+    uint32_t rows;       /*!< Pixel rows sent */
+    uint32_t bytes;      /*!< Bytes sent over SPI, commands included */
+    uint32_t vcoms;      /*!< VCOM-only commands sent by the clock */
+} DisplaySharpDma_Stats;
+
+/*!
+ *  @brief  DisplaySharpDma hardware attributes
+ *
+ *  @p pixelWidth must be a multiple of 8.
+ */
+typedef struct DisplaySharpDma_HWAttrs {
+    uint_least8_t  spiIndex;    /*!< SPI instance the panel is on */
+    uint32_t       bitRate;     /*!< SPI clock in Hz */
+    uint_least8_t  csPin;       /*!< GPIO index of the chip select */
+    uint_least8_t  powerPin;    /*!< GPIO index of the panel supply */
+    uint_least8_t  enablePin;   /*!< GPIO index of the DISP input */
+    uint16_t       pixelWidth;  /*!< Panel width in pixels */
+    uint16_t       pixelHeight; /*!< Panel height in pixels */
+    uint8_t       *displayBuf;  /*!< DisplaySharpDma_BUF_SIZE() bytes */
+} DisplaySharpDma_HWAttrs;
+
+/*!
+ *  @brief  DisplaySharpDma object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct DisplaySharpDma_Object {
+    Graphics_Context       g_sContext;
+    Graphics_Display       g_sDisplay;
+    SemaphoreP_Struct      lcdMutex;
+    SemaphoreP_Struct      spiDone;
+    ClockP_Struct          vcomClock;
+    SPI_Handle             hSpi;
+    SPI_Transaction        vcomTransaction;
+    Display_LineClearMode  lineClearMode;
+    uint8_t               *frame;
+    uint_least8_t          csPin;
+    uint16_t               stride;
+    uint16_t               height;
+    uint16_t               dirtyFirst;
+    uint16_t               dirtyLast;
+    bool                   clearPending;
+    volatile bool          busy;
+    volatile bool          vcomActive;
+    uint8_t                vcom;
+    uint8_t                vcomCmd[2];
+    DisplaySharpDma_Stats  stats;
+} DisplaySharpDma_Object;
+
+extern const Display_FxnTable DisplaySharpDma_fxnTable;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DISPLAYSHARPDMA_H__ */
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== DisplayUartDma.c ========
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/dpl/SystemP.h>
+#include <ti/display/Display.h>
+
+#include "Atomic.h"
+#include "DisplayUartDma.h"
+#include "Fmt.h"
+#include "Prof.h"
+
+/* Line terminator appended to every message */
+#define DISPLAYUARTDMA_EOL      "\r\n"
+#define DISPLAYUARTDMA_EOL_LEN  2
+
+void DisplayUartDma_init(Display_Handle handle);
+Display_Handle DisplayUartDma_open(Display_Handle handle,
+                                   Display_Params *params);
+void DisplayUartDma_clear(Display_Handle handle);
+void DisplayUartDma_clearLines(Display_Handle handle, uint8_t fromLine,
+                               uint8_t toLine);
+void DisplayUartDma_vprintf(Display_Handle handle, uint8_t line,
+                            uint8_t column, char *fmt, va_list va);
+void DisplayUartDma_close(Display_Handle handle);
+int DisplayUartDma_control(Display_Handle handle, unsigned int cmd,
+                           void *arg);
+unsigned int DisplayUartDma_getType(void);
+
+const Display_FxnTable DisplayUartDma_fxnTable = {
+    DisplayUartDma_init,
+    DisplayUartDma_open,
+    DisplayUartDma_clear,
+    DisplayUartDma_clearLines,
+    DisplayUartDma_vprintf,
+    DisplayUartDma_close,
+    DisplayUartDma_control,
+    DisplayUartDma_getType,
+};
+
+/*
+ *  ======== DisplayUartDma_init ========
+ */
+void DisplayUartDma_init(Display_Handle handle)
+{
+}
+
+/*
+ *  ======== DisplayUartDma_open ========
+ */
+Display_Handle DisplayUartDma_open(Display_Handle handle,
+                                   Display_Params *params)
+{
+    DisplayUartDma_Object        *object =
+        (DisplayUartDma_Object *)handle->object;
+    DisplayUartDma_HWAttrs const *hwAttrs =
+        (DisplayUartDma_HWAttrs const *)handle->hwAttrs;
+    UartDmaCC26XX_Params          uartParams;
+
+    UartDmaCC26XX_Params_init(&uartParams);
+    uartParams.baudRate       = hwAttrs->baudRate;
+    uartParams.overflowPolicy = hwAttrs->overflowPolicy;
+    uartParams.blockTimeout   = hwAttrs->blockTimeout;
+
+    object->uartHandle = UartDmaCC26XX_open(hwAttrs->uartIdx, &uartParams);
+    if (object->uartHandle == NULL) {
+        return (NULL);
+    }
+
+    object->truncated = 0;
+
+    return (handle);
+}
+
+/*
+ *  ======== DisplayUartDma_clear ========
+ */
+void DisplayUartDma_clear(Display_Handle handle)
+{
+}
+
+/*
+ *  ======== DisplayUartDma_clearLines ========
+ */
+void DisplayUartDma_clearLines(Display_Handle handle, uint8_t fromLine,
+                               uint8_t toLine)
+{
+}
+
+/*
+ *  ======== DisplayUartDma_vprintf ========
+ */
+void DisplayUartDma_vprintf(Display_Handle handle, uint8_t line,
+                            uint8_t column, char *fmt, va_list va)
+{
+    DisplayUartDma_Object *object = (DisplayUartDma_Object *)handle->object;
+    UartDmaCC26XX_TxSlot  *slot;
+    uint8_t               *data;
+    size_t                 room;
+    int                    len;
+    Prof_BEGIN(start);
+
+    slot = UartDmaCC26XX_reserve(object->uartHandle, &data);
+    if (slot == NULL) {
+        /* Counted as dropped by the UART driver */
+        return;
+    }
+
+    /* Keep room for the line terminator */
+    room = UartDmaCC26XX_slotSize(object->uartHandle) - DISPLAYUARTDMA_EOL_LEN;
+
+    len = Fmt_vsnprintf((char *)data, room + 1, fmt, va);
+    if (len < 0) {
+        /* Conversion that Fmt does not handle */
+        len = SystemP_vsnprintf((char *)data, room + 1, fmt, va);
+    }
+    if (len < 0) {
+        len = 0;
+    }
+    else if ((size_t)len > room) {
+        Atomic_add32(&object->truncated, 1);
+        len = room;
+    }
+
+    data[len++] = DISPLAYUARTDMA_EOL[0];
+    data[len++] = DISPLAYUARTDMA_EOL[1];
+
+    UartDmaCC26XX_commit(object->uartHandle, slot, len);
+
+    /* Dropped lines are not charged */
+    Prof_END(ProfSite_DISPLAY, start);
+}
+
+/*
+ *  ======== DisplayUartDma_close ========
+ */
+void DisplayUartDma_close(Display_Handle handle)
+{
+    DisplayUartDma_Object *object = (DisplayUartDma_Object *)handle->object;
+
+    UartDmaCC26XX_close(object->uartHandle);
+    object->uartHandle = NULL;
+}
+
+/*
+ *  ======== DisplayUartDma_control ========
+ */
+int DisplayUartDma_control(Display_Handle handle, unsigned int cmd, void *arg)
+{
+    DisplayUartDma_Object *object = (DisplayUartDma_Object *)handle->object;
+    DisplayUartDma_Stats  *stats;
+
+    switch (cmd) {
+        case DisplayUartDma_CMD_GET_STATS:
+            stats = (DisplayUartDma_Stats *)arg;
+            stats->truncated = object->truncated;
+            UartDmaCC26XX_getStats(object->uartHandle, &stats->uart);
+            return (DISPLAY_STATUS_SUCCESS);
+
+        default:
+            return (DISPLAY_STATUS_UNDEFINEDCMD);
+    }
+}
+
+/*
+ *  ======== DisplayUartDma_getType ========
+ */
+unsigned int DisplayUartDma_getType(void)
+{
+    return (Display_Type_UART);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       DisplayUartDma.h
+ *
+ *  @brief      Non-blocking Display implementation on top of UartDmaCC26XX.
+ *
+ *  Display_printf() formats the message straight into a transmit slot of
+ *  the UartDmaCC26XX driver and returns; the uDMA moves the bytes to the
+ *  UART in the background. Output is the same as DisplayUartMin: line and
+ *  column are ignored and every message is terminated by "\r\n".
+ *
+ *  Messages longer than the UART transmit slot are truncated. If no slot is
+ *  available the UartDmaCC26XX overflow policy from the hardware attributes
+ *  decides whether the caller waits or the message is dropped. Both events
+ *  are counted, see DisplayUartDma_CMD_GET_STATS.
+ *
+ *  ============================================================================
+ */
+#ifndef __DISPLAYUARTDMA_H__
+#define __DISPLAYUARTDMA_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+
+#include "UartDmaCC26XX.h"
+
+/*!
+ *  @brief  Read the message counters
+ *
+ *  @p arg of Display_control() must point to a DisplayUartDma_Stats.
+ */
+#define DisplayUartDma_CMD_GET_STATS    (DISPLAY_CMD_RESERVED + 0)
+
+/*!
+ *  @brief  Message counters of a DisplayUartDma instance
+ */
+typedef struct DisplayUartDma_Stats {
+    uint32_t            truncated;  /*!< Messages cut at the slot size */
+    UartDmaCC26XX_Stats uart;       /*!< Counters of the underlying UART */
+} DisplayUartDma_Stats;
+
+/*!
+ *  @brief  DisplayUartDma hardware attributes
+ */
+typedef struct DisplayUartDma_HWAttrs {
+    unsigned int                 uartIdx;        /*!< UartDmaCC26XX index */
+    unsigned int                 baudRate;       /*!< Baud rate */
+    UartDmaCC26XX_OverflowPolicy overflowPolicy; /*!< Full queue behavior */
+    uint32_t                     blockTimeout;   /*!< Ticks to wait for a
+                                                      slot when blocking */
+} DisplayUartDma_HWAttrs;
+
+/*!
+ *  @brief  DisplayUartDma object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct DisplayUartDma_Object {
+    UartDmaCC26XX_Handle uartHandle;
+    uint32_t             truncated;
+} DisplayUartDma_Object;
+
+extern const Display_FxnTable DisplayUartDma_fxnTable;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DISPLAYUARTDMA_H__ */
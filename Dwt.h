@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Dwt.h
+ *
+ *  @brief      Cycle counter of the Cortex-M3 data watchpoint and trace unit.
+ *
+ *  The counter runs at the CPU clock, 48 MHz on the CC1310, and wraps about
+ *  every 89 s; differences of two reads are correct across one wrap. It
+ *  stops while the CPU sleeps. Enabling it is idempotent, so every module
+ *  that reads it enables it at init.
+ *
+ *  @code
+ *  uint32_t start;
+ *
+ *  Dwt_enable();
+ *  start = Dwt_cycles();
+ *  work();
+ *  cycles = Dwt_cycles() - start;
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __DWT_H__
+#define __DWT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*! Debug exception and monitor control register */
+#define Dwt_DEMCR           (*(volatile uint32_t *)0xE000EDFC)
+#define Dwt_DEMCR_TRCENA    0x01000000
+
+/*! DWT control register */
+#define Dwt_CTRL            (*(volatile uint32_t *)0xE0001000)
+#define Dwt_CTRL_CYCCNTENA  0x00000001
+
+/*! DWT cycle counter */
+#define Dwt_CYCCNT          (*(volatile uint32_t *)0xE0001004)
+
+/*!
+ *  @brief  Start the cycle counter
+ */
+static inline void Dwt_enable(void)
+{
+    Dwt_DEMCR |= Dwt_DEMCR_TRCENA;
+    Dwt_CTRL  |= Dwt_CTRL_CYCCNTENA;
+}
+
+/*!
+ *  @brief  Current cycle count
+ */
+static inline uint32_t Dwt_cycles(void)
+{
+    return (Dwt_CYCCNT);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DWT_H__ */
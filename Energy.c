@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Energy.c ========
+ */
+
+#include <stdint.h>
+
+#include <ti/devices/cc13x0/driverlib/aon_rtc.h>
+#include <ti/display/Display.h>
+#include <ti/drivers/Power.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/power/PowerCC26XX.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "Energy.h"
+
+Energy_States Energy_states;
+Energy_Op     Energy_ops[EnergyOp_COUNT];
+
+static const char *const Energy_names[EnergyOp_COUNT] = EnergyOp_NAMES;
+static const uint32_t    Energy_currents[EnergyOp_COUNT] = EnergyOp_CURRENTS;
+
+static Power_NotifyObj Energy_notify;
+static Task_Handle     Energy_idle;
+static uint32_t        Energy_last;
+static uint32_t        Energy_idleStart;
+static uint32_t        Energy_standbyStart;
+
+static uint64_t Energy_charge(uint64_t ticks, uint32_t nA);
+static int Energy_notifyFxn(unsigned int eventType, uintptr_t eventArg,
+                            uintptr_t clientArg);
+static uint32_t Energy_ms(uint64_t ticks);
+static void Energy_update(uint32_t now);
+
+/*
+ *  ======== Energy_now ========
+ *  RTC in 1/65536 s.
+ */
+static inline uint32_t Energy_now(void)
+{
+    return (AONRTCCurrentCompareValueGet());
+}
+
+/*
+ *  ======== Energy_start ========
+ */
+void Energy_start(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < EnergyOp_COUNT; i++) {
+        Energy_ops[i].name = Energy_names[i];
+    }
+
+    Energy_idle = Task_getIdleTask();
+    Energy_last = Energy_now();
+
+    Power_registerNotify(&Energy_notify,
+                         PowerCC26XX_ENTERING_STANDBY |
+                         PowerCC26XX_AWAKE_STANDBY,
+                         Energy_notifyFxn, 0);
+}
+
+/*
+ *  ======== Energy_taskSwitch ========
+ *  Runs with interrupts disabled.
+ */
+void Energy_taskSwitch(Task_Handle prev, Task_Handle next)
+{
+    uint32_t now;
+
+    if (next == Energy_idle) {
+        now = Energy_now();
+        Energy_update(now);
+        Energy_idleStart = now;
+    }
+    else if (prev == Energy_idle && Energy_idle != NULL) {
+        now = Energy_now();
+        Energy_update(now);
+        Energy_states.idleTask += (uint32_t)(now - Energy_idleStart);
+    }
+}
+
+/*
+ *  ======== Energy_begin ========
+ */
+void Energy_begin(EnergyOp op)
+{
+    Energy_Op *entry = &Energy_ops[op];
+    uintptr_t  key;
+
+    key = HwiP_disable();
+    entry->start    = Energy_now();
+    entry->idleTask = Energy_states.idleTask;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== Energy_end ========
+ */
+void Energy_end(EnergyOp op)
+{
+    Energy_Op *entry = &Energy_ops[op];
+    uint32_t   duration;
+    uint32_t   idle;
+    uintptr_t  key;
+
+    key = HwiP_disable();
+
+    /* The Idle task only runs while the caller is blocked */
+    duration = Energy_now() - entry->start;
+    idle     = (uint32_t)(Energy_states.idleTask - entry->idleTask);
+
+    entry->count++;
+    entry->duration += duration;
+    entry->active   += (idle < duration) ? duration - idle : 0;
+
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== Energy_getStates ========
+ */
+void Energy_getStates(Energy_States *states)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    Energy_update(Energy_now());
+    *states = Energy_states;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== Energy_getCharge ========
+ */
+uint64_t Energy_getCharge(void)
+{
+    Energy_States states;
+    uint64_t      charge;
+    uint64_t      duration;
+    uintptr_t     key;
+    unsigned int  i;
+
+    Energy_getStates(&states);
+
+    charge = Energy_charge(states.total - states.idleTask,
+                           Energy_ACTIVE_NA) +
+             Energy_charge(states.idleTask - states.standby,
+                           Energy_IDLE_NA) +
+             Energy_charge(states.standby, Energy_STANDBY_NA);
+
+    for (i = 0; i < EnergyOp_COUNT; i++) {
+        key = HwiP_disable();
+        duration = Energy_ops[i].duration;
+        HwiP_restore(key);
+        charge += Energy_charge(duration, Energy_currents[i]);
+    }
+
+    return (charge);
+}
+
+/*
+ *  ======== Energy_print ========
+ */
+void Energy_print(Display_Handle handle)
+{
+    Energy_States states;
+    Energy_Op     entry;
+    uint64_t      idle;
+    uint64_t      active;
+    uint64_t      charge;
+    uint32_t      average;
+    uintptr_t     key;
+    unsigned int  i;
+
+    Energy_getStates(&states);
+    if (states.total == 0) {
+        return;
+    }
+
+    idle   = states.idleTask - states.standby;
+    active = states.total - states.idleTask;
+    charge = Energy_getCharge();
+    average = (uint32_t)(charge * Energy_TICKS_PER_SEC / states.total);
+
+    Display_printf(handle, 0, 0,
+            "Power over %u ms: active %u ms, idle %u ms, standby %u ms",
+            Energy_ms(states.total), Energy_ms(active), Energy_ms(idle),
+            Energy_ms(states.standby));
+    Display_printf(handle, 0, 0, "  %u uC, average %u uA, %u wakeups",
+            (uint32_t)(charge / 1000), average / 1000, states.wakeups);
+
+    for (i = 0; i < EnergyOp_COUNT; i++) {
+        key = HwiP_disable();
+        entry = Energy_ops[i];
+        HwiP_restore(key);
+        if (entry.count == 0) {
+            continue;
+        }
+        Display_printf(handle, 0, 0,
+                "  %s: %u times, %u ms active of %u ms, %u uC",
+                entry.name, entry.count, Energy_ms(entry.active),
+                Energy_ms(entry.duration),
+                (uint32_t)((Energy_charge(entry.active, Energy_ACTIVE_NA) +
+                        Energy_charge(entry.duration, Energy_currents[i])) /
+                        1000));
+    }
+}
+
+/*
+ *  ======== Energy_charge ========
+ *  nC drawn at @p nA over @p ticks.
+ */
+static uint64_t Energy_charge(uint64_t ticks, uint32_t nA)
+{
+    return (ticks * nA / Energy_TICKS_PER_SEC);
+}
+
+/*
+ *  ======== Energy_ms ========
+ */
+static uint32_t Energy_ms(uint64_t ticks)
+{
+    return ((uint32_t)(ticks * 1000 / Energy_TICKS_PER_SEC));
+}
+
+/*
+ *  ======== Energy_notifyFxn ========
+ *  Runs in the Idle task with interrupts disabled.
+ */
+static int Energy_notifyFxn(unsigned int eventType, uintptr_t eventArg,
+                            uintptr_t clientArg)
+{
+    if (eventType == PowerCC26XX_ENTERING_STANDBY) {
+        Energy_standbyStart = Energy_now();
+    }
+    else {
+        Energy_states.standby += (uint32_t)(Energy_now() -
+                Energy_standbyStart);
+        Energy_states.wakeups++;
+    }
+
+    return (Power_NOTIFYDONE);
+}
+
+/*
+ *  ======== Energy_update ========
+ *  Adds the time since the previous call to the total. Must be called
+ *  with interrupts disabled.
+ */
+static void Energy_update(uint32_t now)
+{
+    Energy_states.total += (uint32_t)(now - Energy_last);
+    Energy_last = now;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Energy.h
+ *
+ *  @brief      Time in each power state and charge of tagged operations.
+ *
+ *  A Task switch hook timestamps every switch to and from the Idle task
+ *  with the RTC, and Power notifications timestamp every standby. Time in
+ *  the Idle task is idle time, less the standby time within it; all other
+ *  time is active. The totals are kept in Energy_states for the debugger's
+ *  expression view or ROV.
+ *
+ *  The hook only runs if it is added to the kernel configuration, the .cfg
+ *  file of the tirtos_builds project:
+ *
+ *  @code
+ *  var Task = xdc.useModule('ti.sysbios.knl.Task');
+ *  Task.addHookSet({
+ *      switchFxn: '&Energy_taskSwitch'
+ *  });
+ *  @endcode
+ *
+ *  Code that draws extra current, such as a flash erase, is tagged with
+ *  Energy_begin() and Energy_end() around it. The active time of the scope,
+ *  which excludes the idle and standby time within it, and its duration
+ *  are added to the entry of the operation in Energy_ops.
+ *
+ *  Energy_print() turns the totals into charge with the currents of
+ *  EnergyConfig.h: the time in each state at the current of that state,
+ *  plus the duration of each operation at its own current. The charge of
+ *  an operation also includes the active CPU time it took, which is
+ *  already part of the active total, so the figures of the operations
+ *  show what each one costs rather than adding up to the total.
+ *
+ *  Times come from the RTC in units of 1/65536 s. Interrupts and Swis
+ *  taken while the Idle task runs count as idle, which makes the active
+ *  time of a device that mostly services interrupts too low. The Idle
+ *  task has to run at least every 18 hours for the totals to stay right.
+ *
+ *  @code
+ *  Energy_begin(EnergyOp_NVS_ERASE);
+ *  status = NVS_write(handle, offset, buffer, size, NVS_WRITE_ERASE);
+ *  Energy_end(EnergyOp_NVS_ERASE);
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __ENERGY_H__
+#define __ENERGY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "EnergyConfig.h"
+
+/*! RTC ticks per second */
+#define Energy_TICKS_PER_SEC    65536
+
+/*!
+ *  @brief  Time in each power state, in RTC ticks
+ *
+ *  Idle time is @p idleTask less @p standby, active time the rest of
+ *  @p total.
+ */
+typedef struct Energy_States {
+    uint64_t total;     /*!< Since Energy_start() */
+    uint64_t idleTask;  /*!< In the Idle task, including standby */
+    uint64_t standby;   /*!< In standby */
+    uint32_t wakeups;   /*!< From standby */
+} Energy_States;
+
+/*!
+ *  @brief  Totals of one operation
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Energy_Op {
+    const char *name;       /*!< From EnergyOp_NAMES */
+    uint32_t    count;      /*!< Completed scopes */
+    uint64_t    duration;   /*!< RTC ticks of all scopes */
+    uint64_t    active;     /*!< RTC ticks the CPU was active in them */
+    uint32_t    start;      /*!< RTC of the open scope */
+    uint64_t    idleTask;   /*!< Energy_States.idleTask at its start */
+} Energy_Op;
+
+/*! Residency, current as of the last switch from the Idle task */
+extern Energy_States Energy_states;
+
+/*! One entry per EnergyOp */
+extern Energy_Op Energy_ops[EnergyOp_COUNT];
+
+/*!
+ *  @brief  Start accounting
+ *
+ *  Call from main() after Board_initGeneral(), before BIOS_start().
+ */
+extern void Energy_start(void);
+
+/*!
+ *  @brief  Task switch hook
+ */
+extern void Energy_taskSwitch(Task_Handle prev, Task_Handle next);
+
+/*!
+ *  @brief  Start a scope of @p op
+ *
+ *  Must be called from Task context. Each operation has one scope open
+ *  at a time.
+ */
+extern void Energy_begin(EnergyOp op);
+
+/*!
+ *  @brief  End the scope of @p op
+ */
+extern void Energy_end(EnergyOp op);
+
+/*!
+ *  @brief  Bring the totals up to date and copy them to @p states
+ */
+extern void Energy_getStates(Energy_States *states);
+
+/*!
+ *  @brief  Estimated charge drawn since Energy_start(), in nC
+ *
+ *  The time in each state and the duration of each operation at its
+ *  current. Must be called from Task context.
+ */
+extern uint64_t Energy_getCharge(void);
+
+/*!
+ *  @brief  Print the residency, average current and operations
+ *
+ *  Must be called from Task context.
+ */
+extern void Energy_print(Display_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ENERGY_H__ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       EnergyConfig.h
+ *
+ *  @brief      Tagged operations and supply currents, see Energy.h.
+ *
+ *  Every tagged operation has an entry in EnergyOp, a name at the same
+ *  position in EnergyOp_NAMES and a current at the same position in
+ *  EnergyOp_CURRENTS. Currents are in nA and can be overridden from the
+ *  build options, e.g. -DEnergy_STANDBY_NA=1200.
+ *
+ *  The state currents are typical figures of the CC1310 datasheet for the
+ *  chip alone. The current of an operation is drawn by the parts it keeps
+ *  busy, on top of that of the CPU state, and is only a rough figure from
+ *  the datasheets of those parts. Replace them by measurements of the
+ *  board when the estimates are used for a battery budget.
+ *
+ *  Included by Energy.h only.
+ *
+ *  ============================================================================
+ */
+#ifndef __ENERGYCONFIG_H__
+#define __ENERGYCONFIG_H__
+
+/*!
+ *  @brief  Tagged operations
+ */
+typedef enum EnergyOp {
+    EnergyOp_NVS_ERASE = 0, /*!< Erase and write of a mainThread page */
+    EnergyOp_NVS_LOG,       /*!< Write of a sensor log record */
+    EnergyOp_SPI_WAKE,      /*!< Wakeup of the external SPI flash */
+    EnergyOp_UART_DUMP,     /*!< Remote dump of a flash range */
+    EnergyOp_XOSC_HF,       /*!< 24 MHz crystal held by XoscHf, awake */
+
+    EnergyOp_COUNT
+} EnergyOp;
+
+/*! Names printed by Energy_print(), in EnergyOp order */
+#define EnergyOp_NAMES {    \
+    "nvs_erase",            \
+    "nvs_log",              \
+    "spi_wake",             \
+    "uart_dump",            \
+    "xosc_hf"               \
+}
+
+/*! CPU running at 48 MHz from flash */
+#ifndef Energy_ACTIVE_NA
+#define Energy_ACTIVE_NA        2500000
+#endif
+
+/*! CPU waiting for an interrupt, supply and RAM powered */
+#ifndef Energy_IDLE_NA
+#define Energy_IDLE_NA          550000
+#endif
+
+/*! Standby with the RTC running and RAM retained */
+#ifndef Energy_STANDBY_NA
+#define Energy_STANDBY_NA       700
+#endif
+
+/*!
+ *  Added current of each operation, in EnergyOp order: flash erase and
+ *  program, flash program, MX25R8035F active, UART and uDMA, 24 MHz
+ *  crystal oscillator
+ */
+#ifndef EnergyOp_CURRENTS
+#define EnergyOp_CURRENTS       {8000000, 8000000, 3000000, 300000, 200000}
+#endif
+
+#endif /* __ENERGYCONFIG_H__ */
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== EventGroup.c ========
+ */
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Event.h>
+
+#include "EventGroup.h"
+
+/*
+ *  ======== EventGroup_construct ========
+ */
+void EventGroup_construct(EventGroup_Struct *group)
+{
+    Event_construct(&group->event, NULL);
+}
+
+/*
+ *  ======== EventGroup_destruct ========
+ */
+void EventGroup_destruct(EventGroup_Struct *group)
+{
+    Event_destruct(&group->event);
+}
+
+/*
+ *  ======== EventGroup_waitAny ========
+ */
+uint32_t EventGroup_waitAny(EventGroup_Struct *group, uint32_t mask,
+                            uint32_t timeout)
+{
+    return (Event_pend(Event_handle(&group->event), Event_Id_NONE, mask,
+            timeout));
+}
+
+/*
+ *  ======== EventGroup_waitAll ========
+ */
+uint32_t EventGroup_waitAll(EventGroup_Struct *group, uint32_t mask,
+                            uint32_t timeout)
+{
+    return (Event_pend(Event_handle(&group->event), mask, Event_Id_NONE,
+            timeout));
+}
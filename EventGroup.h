@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       EventGroup.h
+ *
+ *  @brief      Wait for any or all of several conditions at once.
+ *
+ *  An event group is a 32-bit set of condition bits on top of the kernel's
+ *  Event module. Setting bits is O(1) and may be done from any context,
+ *  including Hwis; it wakes the waiting task only if its condition is now
+ *  met. A task waits for any bit of a mask, or for all of them, with a
+ *  timeout, and the bits that satisfied the wait are cleared as it
+ *  returns; bits outside the mask stay set for a later wait.
+ *
+ *  This replaces loops that test flags and sleep: the task runs once per
+ *  condition instead of once per poll period, and reacts as soon as the
+ *  bit is set rather than at its next poll.
+ *
+ *  As with Event, only one task may wait on a group at a time. Give each
+ *  waiting task its own group; any number of producers may set bits.
+ *
+ *  @code
+ *  #define SAMPLE_READY    0x01
+ *  #define FLUSH_REQUEST   0x02
+ *
+ *  bits = EventGroup_waitAny(&group, SAMPLE_READY | FLUSH_REQUEST,
+ *                            EventGroup_WAIT_FOREVER);
+ *  if (bits & SAMPLE_READY) {
+ *      ...
+ *  }
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __EVENTGROUP_H__
+#define __EVENTGROUP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/BIOS.h>
+#include <ti/sysbios/knl/Event.h>
+
+/*! Timeout of a wait without limit */
+#define EventGroup_WAIT_FOREVER     BIOS_WAIT_FOREVER
+
+/*!
+ *  @brief  EventGroup object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct EventGroup_Struct {
+    Event_Struct event;
+} EventGroup_Struct;
+
+/*!
+ *  @brief  Construct a group with no bit set
+ */
+extern void EventGroup_construct(EventGroup_Struct *group);
+
+/*!
+ *  @brief  Destruct a group nobody waits on
+ */
+extern void EventGroup_destruct(EventGroup_Struct *group);
+
+/*!
+ *  @brief  Set @p bits, from any context
+ */
+static inline void EventGroup_set(EventGroup_Struct *group, uint32_t bits)
+{
+    Event_post(Event_handle(&group->event), bits);
+}
+
+/*!
+ *  @brief  Bits set now, without waiting or clearing them
+ */
+static inline uint32_t EventGroup_get(EventGroup_Struct *group)
+{
+    return (Event_getPostedEvents(Event_handle(&group->event)));
+}
+
+/*!
+ *  @brief  Wait until any bit of @p mask is set, from Task context
+ *
+ *  @param  timeout  In ClockP ticks, 0 or EventGroup_WAIT_FOREVER
+ *
+ *  @return The bits of @p mask that were set, now cleared; 0 on timeout.
+ */
+extern uint32_t EventGroup_waitAny(EventGroup_Struct *group, uint32_t mask,
+                                   uint32_t timeout);
+
+/*!
+ *  @brief  Wait until every bit of @p mask is set, from Task context
+ *
+ *  @param  timeout  In ClockP ticks, 0 or EventGroup_WAIT_FOREVER
+ *
+ *  @return @p mask, now cleared; 0 on timeout.
+ */
+extern uint32_t EventGroup_waitAll(EventGroup_Struct *group, uint32_t mask,
+                                   uint32_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EVENTGROUP_H__ */
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== FlashDump.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/drivers/NVS.h>
+
+#include "Crc16.h"
+#include "FlashDump.h"
+
+/* Shortest run of 0xFF worth an erased token */
+#define ERASED_MIN      8
+
+/* Shortest and longest copy */
+#define MATCH_MIN       4
+#define MATCH_MAX       (MATCH_MIN + 0x3F)
+
+/* Longest literal token */
+#define LITERAL_MAX     128
+
+/* Longest token that is not a literal: erased token and 5 byte length */
+#define TOKEN_MAX       6
+
+/* Hash table entry that matches nothing */
+#define HASH_EMPTY      0xFFFF
+
+/*
+ *  ======== FlashDump_hash ========
+ */
+static inline uint32_t FlashDump_hash(const uint8_t *src)
+{
+    uint32_t word = src[0] | ((uint32_t)src[1] << 8) |
+                    ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+
+    return ((word * 2654435761U) >> (32 - FlashDump_HASH_BITS));
+}
+
+/*
+ *  ======== FlashDump_erased ========
+ *  Number of leading 0xFF bytes in @p src, at most @p len.
+ */
+static size_t FlashDump_erased(const uint8_t *src, size_t len)
+{
+    size_t count = 0;
+
+    while (count < len && ((uintptr_t)(src + count) & 3) != 0) {
+        if (src[count] != 0xFF) {
+            return (count);
+        }
+        count++;
+    }
+    while (len - count >= 4 &&
+           *(const uint32_t *)(src + count) == 0xFFFFFFFF) {
+        count += 4;
+    }
+    while (count < len && src[count] == 0xFF) {
+        count++;
+    }
+
+    return (count);
+}
+
+/*
+ *  ======== FlashDump_literals ========
+ */
+static size_t FlashDump_literals(uint8_t *dst, const uint8_t *src,
+                                 size_t len)
+{
+    if (len == 0) {
+        return (0);
+    }
+
+    dst[0] = FlashDump_TOKEN_LITERAL | (uint8_t)(len - 1);
+    memcpy(&dst[1], src, len);
+
+    return (len + 1);
+}
+
+/*
+ *  ======== FlashDump_fill ========
+ *  Read the window starting at region offset @p pos.
+ */
+static int_fast16_t FlashDump_fill(FlashDump_Object *dump, uint32_t pos)
+{
+    uint32_t len = dump->end - pos;
+
+    if (len > FlashDump_WINDOW_SIZE) {
+        len = FlashDump_WINDOW_SIZE;
+    }
+
+    dump->winStart = pos;
+    dump->winLen   = len;
+
+    return (NVS_read(dump->nvs, pos, dump->window, len));
+}
+
+/*
+ *  ======== FlashDump_init ========
+ */
+void FlashDump_init(FlashDump_Object *dump, NVS_Handle nvs, uint32_t offset,
+                    uint32_t length)
+{
+    dump->nvs      = nvs;
+    dump->pos      = offset;
+    dump->end      = offset + length;
+    dump->winStart = offset;
+    dump->winLen   = 0;
+    dump->crc      = Crc16_INIT;
+}
+
+/*
+ *  ======== FlashDump_next ========
+ */
+int_fast16_t FlashDump_next(FlashDump_Object *dump, uint8_t *dst, size_t size,
+                            uint32_t *offset, size_t *len)
+{
+    const uint8_t *window = dump->window;
+    uint32_t       i;
+    uint32_t       lit;
+    uint32_t       crcFrom;
+    uint32_t       cand;
+    uint32_t       count;
+    uint32_t       run;
+    uint32_t       h;
+    size_t         out = 0;
+    bool           refilled = false;
+    int_fast16_t   status;
+
+    *offset = dump->pos;
+    *len    = 0;
+
+    if (dump->pos == dump->end) {
+        return (NVS_STATUS_SUCCESS);
+    }
+
+    if (dump->pos == dump->winStart + dump->winLen) {
+        status = FlashDump_fill(dump, dump->pos);
+        if (status != NVS_STATUS_SUCCESS) {
+            return (status);
+        }
+    }
+
+    /* Blocks are decoded on their own, forget earlier matches */
+    memset(dump->hash, 0xFF, sizeof(dump->hash));
+
+    i = dump->pos - dump->winStart;
+    lit = i;
+    crcFrom = i;
+
+    while (i < dump->winLen) {
+        /* Room for the pending literals and one more token */
+        if (out + (i - lit) + 1 + TOKEN_MAX > size) {
+            break;
+        }
+
+        count = FlashDump_erased(&window[i], dump->winLen - i);
+        if (count >= ERASED_MIN) {
+            out += FlashDump_literals(&dst[out], &window[lit], i - lit);
+            run = count;
+            i += count;
+
+            /* Follow the run into the next windows */
+            while (i == dump->winLen &&
+                   dump->winStart + dump->winLen < dump->end) {
+                dump->crc = Crc16_update(dump->crc, &window[crcFrom],
+                                         i - crcFrom);
+                status = FlashDump_fill(dump, dump->winStart + dump->winLen);
+                if (status != NVS_STATUS_SUCCESS) {
+                    return (status);
+                }
+                count = FlashDump_erased(window, dump->winLen);
+                run += count;
+                i = count;
+                crcFrom = 0;
+                refilled = true;
+            }
+
+            dst[out++] = FlashDump_TOKEN_ERASED;
+            while (run >= 0x80) {
+                dst[out++] = (uint8_t)run | 0x80;
+                run >>= 7;
+            }
+            dst[out++] = (uint8_t)run;
+            lit = i;
+
+            if (refilled) {
+                /* Earlier matches refer to the previous window */
+                break;
+            }
+            continue;
+        }
+
+        if (dump->winLen - i >= MATCH_MIN) {
+            h = FlashDump_hash(&window[i]);
+            cand = dump->hash[h];
+            dump->hash[h] = (uint16_t)i;
+
+            if (cand != HASH_EMPTY &&
+                memcmp(&window[cand], &window[i], MATCH_MIN) == 0) {
+                count = MATCH_MIN;
+                while (count < MATCH_MAX && i + count < dump->winLen &&
+                       window[cand + count] == window[i + count]) {
+                    count++;
+                }
+
+                out += FlashDump_literals(&dst[out], &window[lit], i - lit);
+                dst[out++] = FlashDump_TOKEN_MATCH |
+                             (uint8_t)(count - MATCH_MIN);
+                dst[out++] = (uint8_t)(i - cand);
+                dst[out++] = (uint8_t)((i - cand) >> 8);
+
+                i += count;
+                lit = i;
+                continue;
+            }
+        }
+
+        i++;
+        if (i - lit == LITERAL_MAX) {
+            out += FlashDump_literals(&dst[out], &window[lit], i - lit);
+            lit = i;
+        }
+    }
+
+    out += FlashDump_literals(&dst[out], &window[lit], i - lit);
+    dump->crc = Crc16_update(dump->crc, &window[crcFrom], i - crcFrom);
+    dump->pos = dump->winStart + i;
+
+    *len = out;
+
+    return (NVS_STATUS_SUCCESS);
+}
+
+/*
+ *  ======== FlashDump_getCrc ========
+ */
+uint16_t FlashDump_getCrc(FlashDump_Object *dump)
+{
+    return (dump->crc);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       FlashDump.h
+ *
+ *  @brief      Compressed streaming of an NVS region.
+ *
+ *  Splits a range of an NVS region into independently decodable blocks of
+ *  at most a given size, for RemoteCmd_CMD_DUMPZ. Flash is read in
+ *  FlashDump_WINDOW_SIZE chunks into a window; a block never refers to
+ *  data outside of itself, so every block is decoded on its own.
+ *
+ *  # Block format #
+ *  A block is a sequence of tokens:
+ *
+ *  | Token       | Followed by          | Produces                          |
+ *  |-------------|----------------------|-----------------------------------|
+ *  | 0x00 - 0x7F | token + 1 bytes      | Those bytes                       |
+ *  | 0x80        | Length, LEB128       | Length bytes of 0xFF              |
+ *  | 0xC0 - 0xFF | Distance, 2 bytes LE | (token & 0x3F) + 4 bytes copied   |
+ *  |             |                      | from distance bytes back          |
+ *
+ *  Erased flash is detected a word at a time and sent as a single 0x80
+ *  token, however long it is, even across window reads. Other data goes
+ *  through a greedy LZ77 pass with a small hash table. Copies may overlap
+ *  their own output, which also covers runs of any other byte value.
+ *
+ *  A CRC-16 of all data read (see Crc16.h) lets the host check the image it
+ *  reassembled. The decoder is tools/flashdump.py.
+ *
+ *  ============================================================================
+ */
+#ifndef __FLASHDUMP_H__
+#define __FLASHDUMP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/NVS.h>
+
+/*! Bytes read from flash at a time */
+#define FlashDump_WINDOW_SIZE   1024
+
+/*! log2 of the number of match hash table entries */
+#define FlashDump_HASH_BITS     8
+
+/*!
+ *  @name Tokens
+ *  @{
+ */
+#define FlashDump_TOKEN_LITERAL 0x00
+#define FlashDump_TOKEN_ERASED  0x80
+#define FlashDump_TOKEN_MATCH   0xC0
+/*! @} */
+
+/*!
+ *  @brief  State of one dump
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct FlashDump_Object {
+    NVS_Handle  nvs;
+    uint32_t    pos;
+    uint32_t    end;
+    uint32_t    winStart;
+    uint32_t    winLen;
+    uint16_t    crc;
+    uint16_t    hash[1 << FlashDump_HASH_BITS];
+    uint8_t     window[FlashDump_WINDOW_SIZE];
+} FlashDump_Object;
+
+/*!
+ *  @brief  Prepare to dump @p length bytes at @p offset of @p nvs
+ */
+extern void FlashDump_init(FlashDump_Object *dump, NVS_Handle nvs,
+                           uint32_t offset, uint32_t length);
+
+/*!
+ *  @brief  Encode the next block
+ *
+ *  @param  dump    Dump state
+ *  @param  dst     Receives the block
+ *  @param  size    Size of @p dst, at least 8 bytes
+ *  @param  offset  Receives the region offset of the first byte in the block
+ *  @param  len     Receives the length of the block, 0 once the whole range
+ *                  has been sent
+ *
+ *  @return NVS_STATUS_SUCCESS or the error returned by NVS_read().
+ */
+extern int_fast16_t FlashDump_next(FlashDump_Object *dump, uint8_t *dst,
+                                   size_t size, uint32_t *offset,
+                                   size_t *len);
+
+/*!
+ *  @brief  CRC-16 of the data encoded so far
+ */
+extern uint16_t FlashDump_getCrc(FlashDump_Object *dump);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLASHDUMP_H__ */
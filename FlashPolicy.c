@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== FlashPolicy.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/Power.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+#include <ti/drivers/power/PowerCC26XX.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Clock.h>
+
+#include "Atomic.h"
+#include "FlashPolicy.h"
+#include "StaticThread.h"
+
+static StaticThread_Struct FlashPolicy_thread;
+static SemaphoreP_Struct   FlashPolicy_sem;
+static volatile bool       FlashPolicy_started;
+
+/* Protected by HwiP_disable(), sorted by deadline */
+static FlashPolicy_Job    *FlashPolicy_jobs;
+static bool                FlashPolicy_flush;
+static uint32_t            FlashPolicy_schedules;
+static uint32_t            FlashPolicy_coalesced;
+static uint32_t            FlashPolicy_early;
+
+/* Written by the worker only */
+static uint32_t            FlashPolicy_batches;
+static uint32_t            FlashPolicy_jobCount;
+
+static bool FlashPolicy_unlink(FlashPolicy_Job *job);
+static void *FlashPolicy_worker(void *arg);
+
+/*
+ *  ======== FlashPolicy_start ========
+ */
+bool FlashPolicy_start(void *stack, size_t stackSize)
+{
+    StaticThread_Config config = {
+        "flash", FlashPolicy_worker, NULL, FlashPolicy_PRIORITY,
+        stack, stackSize
+    };
+
+    if (FlashPolicy_started) {
+        return (true);
+    }
+
+    SemaphoreP_constructBinary(&FlashPolicy_sem, 0);
+    if (!StaticThread_construct(&FlashPolicy_thread, &config)) {
+        SemaphoreP_destruct(&FlashPolicy_sem);
+        return (false);
+    }
+
+    FlashPolicy_started = true;
+
+    return (true);
+}
+
+/*
+ *  ======== FlashPolicy_Job_init ========
+ */
+void FlashPolicy_Job_init(FlashPolicy_Job *job, FlashPolicy_Fxn fxn,
+                          uintptr_t arg)
+{
+    job->next   = NULL;
+    job->fxn    = fxn;
+    job->arg    = arg;
+    job->due    = 0;
+    job->queued = false;
+}
+
+/*
+ *  ======== FlashPolicy_schedule ========
+ */
+bool FlashPolicy_schedule(FlashPolicy_Job *job, uint32_t latencyMs)
+{
+    FlashPolicy_Job **link;
+    uint32_t          due;
+    uintptr_t         key;
+    bool              added = true;
+    bool              wake;
+
+    if (!FlashPolicy_started) {
+        /* Nobody would run it */
+        return (false);
+    }
+
+    due = ClockP_getSystemTicks() + latencyMs * 1000 / ClockP_tickPeriod;
+
+    key = HwiP_disable();
+
+    FlashPolicy_schedules++;
+    if (job->queued) {
+        FlashPolicy_coalesced++;
+        /* Not in the queue if the worker has taken it already */
+        if ((int32_t)(due - job->due) >= 0 || !FlashPolicy_unlink(job)) {
+            HwiP_restore(key);
+            return (false);
+        }
+        added = false;
+    }
+
+    job->due    = due;
+    job->queued = true;
+    for (link = &FlashPolicy_jobs; *link != NULL; link = &(*link)->next) {
+        if ((int32_t)((*link)->due - due) > 0) {
+            break;
+        }
+    }
+    job->next = *link;
+    *link = job;
+
+    /* The worker waits for the earliest deadline */
+    wake = (FlashPolicy_jobs == job);
+
+    HwiP_restore(key);
+
+    if (wake) {
+        SemaphoreP_post(&FlashPolicy_sem);
+    }
+
+    return (added);
+}
+
+/*
+ *  ======== FlashPolicy_begin ========
+ */
+void FlashPolicy_begin(void)
+{
+    Power_setConstraint(PowerCC26XX_SB_DISALLOW);
+}
+
+/*
+ *  ======== FlashPolicy_end ========
+ */
+void FlashPolicy_end(void)
+{
+    Power_releaseConstraint(PowerCC26XX_SB_DISALLOW);
+}
+
+/*
+ *  ======== FlashPolicy_policy ========
+ *  Runs in the Idle task. Hands the queued jobs to the worker if the
+ *  earliest deadline would end the coming standby, else leaves the
+ *  choice between idle and standby to the stock policy.
+ */
+void FlashPolicy_policy(void)
+{
+    uintptr_t key;
+    int32_t   left;
+    bool      flush = false;
+
+    key = HwiP_disable();
+
+    if (FlashPolicy_jobs != NULL && !FlashPolicy_flush &&
+        (Power_getConstraintMask() &
+         (1 << PowerCC26XX_SB_DISALLOW)) == 0) {
+        left = (int32_t)(FlashPolicy_jobs->due - ClockP_getSystemTicks());
+        /* One tick of rounding between the deadline and the timeout */
+        if (left <= (int32_t)Clock_getTicksUntilInterrupt() + 1) {
+            FlashPolicy_flush = true;
+            FlashPolicy_early++;
+            flush = true;
+        }
+    }
+
+    HwiP_restore(key);
+
+    if (flush) {
+        /* The Idle task runs the policy again once the worker is done */
+        SemaphoreP_post(&FlashPolicy_sem);
+    }
+    else {
+        PowerCC26XX_standbyPolicy();
+    }
+}
+
+/*
+ *  ======== FlashPolicy_getStats ========
+ */
+void FlashPolicy_getStats(FlashPolicy_Stats *stats)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    stats->schedules = FlashPolicy_schedules;
+    stats->coalesced = FlashPolicy_coalesced;
+    stats->batches   = FlashPolicy_batches;
+    stats->early     = FlashPolicy_early;
+    stats->jobs      = FlashPolicy_jobCount;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== FlashPolicy_unlink ========
+ *  Takes @p job out of the queue. Must be called with interrupts disabled.
+ *
+ *  @return false if the job was not in the queue.
+ */
+static bool FlashPolicy_unlink(FlashPolicy_Job *job)
+{
+    FlashPolicy_Job **link;
+
+    for (link = &FlashPolicy_jobs; *link != NULL; link = &(*link)->next) {
+        if (*link == job) {
+            *link = job->next;
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/*
+ *  ======== FlashPolicy_worker ========
+ *  Takes the whole queue when the earliest deadline has come or the policy
+ *  asks for it, and runs it with standby disallowed.
+ */
+static void *FlashPolicy_worker(void *arg)
+{
+    FlashPolicy_Job *job;
+    FlashPolicy_Job *next;
+    uint32_t         timeout;
+    uintptr_t        key;
+    int32_t          left;
+
+    for (;;) {
+        timeout = SemaphoreP_WAIT_FOREVER;
+        job = NULL;
+
+        key = HwiP_disable();
+        if (FlashPolicy_jobs != NULL) {
+            left = (int32_t)(FlashPolicy_jobs->due - ClockP_getSystemTicks());
+            if (left <= 0 || FlashPolicy_flush) {
+                job = FlashPolicy_jobs;
+                FlashPolicy_jobs = NULL;
+            }
+            else {
+                timeout = (uint32_t)left;
+            }
+        }
+        FlashPolicy_flush = false;
+        HwiP_restore(key);
+
+        if (job == NULL) {
+            /* Also woken by earlier deadlines */
+            SemaphoreP_pend(&FlashPolicy_sem, timeout);
+            continue;
+        }
+
+        FlashPolicy_batches++;
+        Power_setConstraint(PowerCC26XX_SB_DISALLOW);
+
+        while (job != NULL) {
+            /* Detached jobs are not touched by schedules until unqueued */
+            next = job->next;
+            Atomic_dmb();
+            job->queued = false;
+
+            job->fxn(job->arg);
+            FlashPolicy_jobCount++;
+            job = next;
+        }
+
+        Power_releaseConstraint(PowerCC26XX_SB_DISALLOW);
+    }
+
+    return (NULL);
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       FlashPolicy.h
+ *
+ *  @brief      Power policy that knows about flash work.
+ *
+ *  Flash work that can wait, such as writing buffered log records, is
+ *  scheduled as a job with a deadline instead of being done at once. A
+ *  worker thread runs all queued jobs together, either when the earliest
+ *  deadline comes or when FlashPolicy_policy(), the Power policy of the
+ *  board file, finds that the device is about to enter standby and the
+ *  next wakeup would be for that deadline. Running the jobs then, while
+ *  the device is awake anyway, saves the wakeup; otherwise they wait for
+ *  a later chance or their deadline.
+ *
+ *  The worker disallows standby while it runs jobs, so a flash operation
+ *  in flight, which may wait on the SPI flash, is never cut by standby; the
+ *  policy then idles instead. FlashPolicy_begin() and FlashPolicy_end() do
+ *  the same for flash operations done directly. In every other case the
+ *  policy is PowerCC26XX_standbyPolicy().
+ *
+ *  Scheduling a job that is already queued only moves its deadline if the
+ *  new one is earlier, so a job that writes whatever has been buffered is
+ *  scheduled after every addition and runs once per batch. A job is taken
+ *  off the queue just before its function is called.
+ *
+ *  The worker is only constructed by FlashPolicy_start(), on a stack of
+ *  the caller, so an application without deferred flash work spends no RAM
+ *  on it. Until then the policy behaves as the stock one and jobs cannot
+ *  be scheduled.
+ *
+ *  @code
+ *  static StaticThread_STACK(flashStack, FlashPolicy_STACK_SIZE);
+ *  static FlashPolicy_Job flushJob;
+ *
+ *  if (!FlashPolicy_start(flashStack, sizeof(flashStack))) {
+ *      return;
+ *  }
+ *  FlashPolicy_Job_init(&flushJob, flushFxn, 0);
+ *
+ *  // After buffering a record, written within 30 s
+ *  FlashPolicy_schedule(&flushJob, 30000);
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __FLASHPOLICY_H__
+#define __FLASHPOLICY_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ *  Priority of the worker thread. The lowest, the same as mainThread's, so
+ *  jobs never preempt the application; they run while it blocks.
+ */
+#ifndef FlashPolicy_PRIORITY
+#define FlashPolicy_PRIORITY    1
+#endif
+
+/*! Suggested stack of the worker thread, in bytes, for the deepest job */
+#ifndef FlashPolicy_STACK_SIZE
+#define FlashPolicy_STACK_SIZE  1024
+#endif
+
+/*!
+ *  @brief  Job function, called by the worker thread, may block
+ */
+typedef void (*FlashPolicy_Fxn)(uintptr_t arg);
+
+/*!
+ *  @brief  A deferred flash job
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct FlashPolicy_Job {
+    struct FlashPolicy_Job *next;
+    FlashPolicy_Fxn         fxn;
+    uintptr_t               arg;
+    uint32_t                due;     /*!< ClockP tick of the deadline */
+    volatile bool           queued;
+} FlashPolicy_Job;
+
+/*!
+ *  @brief  Counters
+ */
+typedef struct FlashPolicy_Stats {
+    uint32_t schedules;  /*!< Calls of FlashPolicy_schedule() */
+    uint32_t coalesced;  /*!< Schedules of jobs that were already queued */
+    uint32_t batches;    /*!< Runs of the queued jobs */
+    uint32_t early;      /*!< Batches run before standby */
+    uint32_t jobs;       /*!< Job functions called */
+} FlashPolicy_Stats;
+
+/*!
+ *  @brief  Construct the worker thread on @p stack
+ *
+ *  Call from main() or a thread before the first job is scheduled, and
+ *  not from two threads at once. Further calls do nothing.
+ *
+ *  @param  stack      Stack of the worker, see StaticThread_STACK()
+ *  @param  stackSize  Its size in bytes, e.g. FlashPolicy_STACK_SIZE
+ *
+ *  @return false if the thread could not be constructed.
+ */
+extern bool FlashPolicy_start(void *stack, size_t stackSize);
+
+/*!
+ *  @brief  Initialize a job that is not queued
+ */
+extern void FlashPolicy_Job_init(FlashPolicy_Job *job, FlashPolicy_Fxn fxn,
+                                 uintptr_t arg);
+
+/*!
+ *  @brief  Queue a job to run within @p latencyMs, from any context
+ *
+ *  @return false if the job was already queued, or the worker has not
+ *          been started and the job was not queued.
+ */
+extern bool FlashPolicy_schedule(FlashPolicy_Job *job, uint32_t latencyMs);
+
+/*!
+ *  @brief  Disallow standby during a flash operation
+ *
+ *  Must be paired with FlashPolicy_end().
+ */
+extern void FlashPolicy_begin(void);
+
+/*!
+ *  @brief  End a flash operation started by FlashPolicy_begin()
+ */
+extern void FlashPolicy_end(void);
+
+/*!
+ *  @brief  Power policy, the policyFxn of PowerCC26XX_config
+ */
+extern void FlashPolicy_policy(void);
+
+/*!
+ *  @brief  Read the counters
+ */
+extern void FlashPolicy_getStats(FlashPolicy_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FLASHPOLICY_H__ */
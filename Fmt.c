@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Fmt.c ========
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Fmt.h"
+
+/* "00" to "99", 200 bytes of flash */
+static const char Fmt_digitPairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const char Fmt_hexDigits[2][16] = {
+    {'0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f'},
+    {'0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'}
+};
+
+static const uint32_t Fmt_pow10[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+    1000000000
+};
+
+/* Where Fmt_format() takes its arguments from */
+typedef struct Fmt_Source {
+    va_list         *va;
+    const uintptr_t *args;
+    size_t           nargs;
+} Fmt_Source;
+
+static int Fmt_format(char *dst, size_t size, const char *fmt,
+                      Fmt_Source *src);
+static uintptr_t Fmt_nextArg(Fmt_Source *src, char conv);
+static bool Fmt_supported(const char *fmt);
+
+/*
+ *  ======== Fmt_digits ========
+ *  Number of decimal digits of @p value.
+ */
+static inline size_t Fmt_digits(uint32_t value)
+{
+    size_t n = 1;
+
+    while ((n < 10) && (value >= Fmt_pow10[n])) {
+        n++;
+    }
+
+    return (n);
+}
+
+/*
+ *  ======== Fmt_putDigits ========
+ *  Write the @p n lowest decimal digits of @p value, with leading zeros,
+ *  backwards from @p end.
+ */
+static inline void Fmt_putDigits(char *end, uint32_t value, size_t n)
+{
+    uint32_t q;
+
+    while (n >= 2) {
+        q = value / 100;
+        end -= 2;
+        memcpy(end, &Fmt_digitPairs[(value - (q * 100)) * 2], 2);
+        value = q;
+        n -= 2;
+    }
+    if (n != 0) {
+        *--end = (char)('0' + (value % 10));
+    }
+}
+
+/*
+ *  ======== Fmt_u32 ========
+ */
+size_t Fmt_u32(char *dst, uint32_t value)
+{
+    size_t n = Fmt_digits(value);
+
+    Fmt_putDigits(dst + n, value, n);
+
+    return (n);
+}
+
+/*
+ *  ======== Fmt_i32 ========
+ */
+size_t Fmt_i32(char *dst, int32_t value)
+{
+    if (value < 0) {
+        *dst = '-';
+        return (Fmt_u32(dst + 1, 0U - (uint32_t)value) + 1);
+    }
+
+    return (Fmt_u32(dst, (uint32_t)value));
+}
+
+/*
+ *  ======== Fmt_hex ========
+ */
+static size_t Fmt_hex(char *dst, uint32_t value, const char *digits)
+{
+    size_t n = 1;
+    size_t i;
+
+    while ((n < 8) && ((value >> (4 * n)) != 0)) {
+        n++;
+    }
+
+    for (i = n; i > 0; i--) {
+        dst[i - 1] = digits[value & 0xF];
+        value >>= 4;
+    }
+
+    return (n);
+}
+
+/*
+ *  ======== Fmt_hex32 ========
+ */
+size_t Fmt_hex32(char *dst, uint32_t value)
+{
+    return (Fmt_hex(dst, value, Fmt_hexDigits[0]));
+}
+
+/*
+ *  ======== Fmt_fixed ========
+ */
+size_t Fmt_fixed(char *dst, int32_t value, uint_fast8_t decimals)
+{
+    uint32_t magnitude;
+    uint32_t scale;
+    size_t   len = 0;
+
+    if (decimals == 0) {
+        return (Fmt_i32(dst, value));
+    }
+    if (decimals > 9) {
+        decimals = 9;
+    }
+
+    if (value < 0) {
+        dst[len++] = '-';
+        magnitude = 0U - (uint32_t)value;
+    }
+    else {
+        magnitude = (uint32_t)value;
+    }
+
+    scale = Fmt_pow10[decimals];
+    len += Fmt_u32(&dst[len], magnitude / scale);
+    dst[len++] = '.';
+    Fmt_putDigits(&dst[len + decimals], magnitude % scale, decimals);
+
+    return (len + decimals);
+}
+
+/*
+ *  ======== Fmt_vsnprintf ========
+ */
+int Fmt_vsnprintf(char *dst, size_t size, const char *fmt, va_list va)
+{
+    Fmt_Source src;
+    va_list    args;
+    int        len;
+
+    if (!Fmt_supported(fmt)) {
+        return (-1);
+    }
+
+    va_copy(args, va);
+    src.va    = &args;
+    src.args  = NULL;
+    src.nargs = 0;
+    len = Fmt_format(dst, size, fmt, &src);
+    va_end(args);
+
+    return (len);
+}
+
+/*
+ *  ======== Fmt_snprintfArgs ========
+ */
+int Fmt_snprintfArgs(char *dst, size_t size, const char *fmt,
+                     const uintptr_t *args, size_t nargs)
+{
+    Fmt_Source src;
+
+    if (!Fmt_supported(fmt)) {
+        return (-1);
+    }
+
+    src.va    = NULL;
+    src.args  = args;
+    src.nargs = nargs;
+
+    return (Fmt_format(dst, size, fmt, &src));
+}
+
+/*
+ *  ======== Fmt_supported ========
+ *  Check every conversion of @p fmt before any argument is consumed.
+ */
+static bool Fmt_supported(const char *fmt)
+{
+    while ((fmt = strchr(fmt, '%')) != NULL) {
+        fmt++;
+        if (*fmt == 'l') {
+            fmt++;
+        }
+        if ((*fmt == '\0') || (strchr("diuxXcs%", *fmt) == NULL)) {
+            return (false);
+        }
+        fmt++;
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== Fmt_nextArg ========
+ */
+static uintptr_t Fmt_nextArg(Fmt_Source *src, char conv)
+{
+    if (src->va == NULL) {
+        if (src->nargs == 0) {
+            return (0);
+        }
+        src->nargs--;
+        return (*src->args++);
+    }
+
+    switch (conv) {
+        case 's':
+            return ((uintptr_t)va_arg(*src->va, const char *));
+
+        case 'd':
+        case 'i':
+        case 'c':
+            return ((uintptr_t)va_arg(*src->va, int));
+
+        default:
+            return ((uintptr_t)va_arg(*src->va, unsigned int));
+    }
+}
+
+/*
+ *  ======== Fmt_format ========
+ *  Conversions are formatted into a small buffer and copied, so that
+ *  truncation only has to be handled in one place.
+ */
+static int Fmt_format(char *dst, size_t size, const char *fmt,
+                      Fmt_Source *src)
+{
+    char        conv[Fmt_I32_MAX_LEN];
+    const char *text;
+    size_t      total = 0;
+    size_t      room = (size > 0) ? (size - 1) : 0;
+    size_t      n;
+    size_t      copy;
+    uintptr_t   arg;
+
+    while (*fmt != '\0') {
+        if (*fmt != '%') {
+            text = fmt;
+            n = strcspn(fmt, "%");
+            fmt += n;
+        }
+        else {
+            fmt++;
+            if (*fmt == 'l') {
+                fmt++;
+            }
+
+            text = conv;
+            if (*fmt == '%') {
+                conv[0] = '%';
+                n = 1;
+            }
+            else {
+                arg = Fmt_nextArg(src, *fmt);
+                switch (*fmt) {
+                    case 'd':
+                    case 'i':
+                        n = Fmt_i32(conv, (int32_t)arg);
+                        break;
+
+                    case 'u':
+                        n = Fmt_u32(conv, (uint32_t)arg);
+                        break;
+
+                    case 'x':
+                        n = Fmt_hex(conv, (uint32_t)arg, Fmt_hexDigits[0]);
+                        break;
+
+                    case 'X':
+                        n = Fmt_hex(conv, (uint32_t)arg, Fmt_hexDigits[1]);
+                        break;
+
+                    case 'c':
+                        conv[0] = (char)arg;
+                        n = 1;
+                        break;
+
+                    default: /* 's' */
+                        text = (arg != 0) ? (const char *)arg : "(null)";
+                        n = strlen(text);
+                        break;
+                }
+            }
+            fmt++;
+        }
+
+        if (total < room) {
+            copy = (n < (room - total)) ? n : (room - total);
+            memcpy(&dst[total], text, copy);
+        }
+        total += n;
+    }
+
+    if (size > 0) {
+        dst[(total < room) ? total : room] = '\0';
+    }
+
+    return ((int)total);
+}
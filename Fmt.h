@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Fmt.h
+ *
+ *  @brief      Fast integer to text conversion without varargs or buffers.
+ *
+ *  Each formatter writes the digits of one value to @p dst, without a
+ *  terminating NUL, and returns the number of characters written. @p dst
+ *  must have room for the Fmt_xxx_MAX_LEN of the formatter. Decimal output
+ *  is produced two digits at a time from a table of digit pairs, so a
+ *  32-bit value takes at most five divisions by 100, which the compiler
+ *  turns into multiplications.
+ *
+ *  Fmt_vsnprintf() is a drop-in for the common cases of SystemP_vsnprintf()
+ *  built on them. The Display backends and text mode logging try it first
+ *  and only fall back to SystemP_vsnprintf() for formats it rejects.
+ *
+ *  @code
+ *  char    text[Fmt_U32_MAX_LEN + 1];
+ *  size_t  len;
+ *
+ *  len = Fmt_u32(text, 64532);
+ *  text[len] = '\0';
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __FMT_H__
+#define __FMT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*! Longest output of Fmt_u32(), "4294967295" */
+#define Fmt_U32_MAX_LEN     10
+
+/*! Longest output of Fmt_i32(), "-2147483648" */
+#define Fmt_I32_MAX_LEN     11
+
+/*! Longest output of Fmt_hex32(), "ffffffff" */
+#define Fmt_HEX32_MAX_LEN   8
+
+/*! Longest output of Fmt_fixed(), "-2147483.648" or "-0.000000001" */
+#define Fmt_FIXED_MAX_LEN   12
+
+/*!
+ *  @brief  Format an unsigned value in decimal, as "%u"
+ */
+extern size_t Fmt_u32(char *dst, uint32_t value);
+
+/*!
+ *  @brief  Format a signed value in decimal, as "%d"
+ */
+extern size_t Fmt_i32(char *dst, int32_t value);
+
+/*!
+ *  @brief  Format a value in lower case hexadecimal, as "%x"
+ */
+extern size_t Fmt_hex32(char *dst, uint32_t value);
+
+/*!
+ *  @brief  Format a fixed point value
+ *
+ *  @param  dst       Destination
+ *  @param  value     Value in units of 10^-@p decimals
+ *  @param  decimals  Number of digits after the point, 0 to 9
+ *
+ *  For example a value of -1205 with 2 decimals is written as "-12.05".
+ */
+extern size_t Fmt_fixed(char *dst, int32_t value, uint_fast8_t decimals);
+
+/*!
+ *  @brief  Format a message with the conversions used in this application
+ *
+ *  Accepts "%d", "%i", "%u", "%x", "%X", "%c", "%s" and "%%", optionally
+ *  with an "l" length modifier. Output is truncated to @p size - 1
+ *  characters and terminated by a NUL, as with snprintf().
+ *
+ *  @return The length of the complete message, or -1 if @p fmt has a
+ *          conversion that is not supported. In that case nothing has been
+ *          consumed from the caller's copy of @p va.
+ */
+extern int Fmt_vsnprintf(char *dst, size_t size, const char *fmt, va_list va);
+
+/*!
+ *  @brief  Fmt_vsnprintf() with the arguments in an array
+ *
+ *  Used by the text mode of Log_write(). Missing arguments read as 0.
+ */
+extern int Fmt_snprintfArgs(char *dst, size_t size, const char *fmt,
+                            const uintptr_t *args, size_t nargs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FMT_H__ */
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Log.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SystemP.h>
+
+#include "Atomic.h"
+#include "Cobs.h"
+#include "Fmt.h"
+#include "Log.h"
+#include "UartDmaCC26XX.h"
+
+/* Type, sequence number, token and arguments of up to 5 varint bytes */
+#define Log_MAX_RECORD_LEN  (4 + Log_MAX_ARGS * 5)
+
+volatile uint8_t Log_mask[LogMod_COUNT];
+
+static UartDmaCC26XX_Handle Log_uart = NULL;
+static volatile uint32_t    Log_seq = 0;
+static volatile uint32_t    Log_dropped = 0;
+
+/*
+ *  ======== Log_init ========
+ */
+bool Log_init(uint_least8_t uartIndex)
+{
+    UartDmaCC26XX_Handle uart;
+
+    uart = UartDmaCC26XX_getHandle(uartIndex);
+    if (uart == NULL) {
+        uart = UartDmaCC26XX_open(uartIndex, NULL);
+    }
+
+    Log_uart = uart;
+
+    memset((void *)Log_mask, 0xFF, sizeof(Log_mask));
+
+    return (uart != NULL);
+}
+
+/*
+ *  ======== Log_setLevel ========
+ */
+void Log_setLevel(uint_least8_t mod, uint_least8_t level)
+{
+    if (mod < LogMod_COUNT) {
+        Log_mask[mod] = Log_MASK_UPTO(level);
+    }
+}
+
+/*
+ *  ======== Log_setMask ========
+ */
+void Log_setMask(uint_least8_t mod, uint8_t mask)
+{
+    if (mod < LogMod_COUNT) {
+        Log_mask[mod] = mask;
+    }
+}
+
+/*
+ *  ======== Log_getDropped ========
+ */
+uint32_t Log_getDropped(void)
+{
+    return (Log_dropped);
+}
+
+#if (Log_TEXT)
+
+/*
+ *  ======== Log_write ========
+ *  Text mode: format on the device.
+ */
+void Log_write(const char *fmt, uint_fast8_t nargs, uintptr_t a0,
+               uintptr_t a1, uintptr_t a2, uintptr_t a3)
+{
+    UartDmaCC26XX_TxSlot *slot;
+    uint8_t              *data;
+    uintptr_t             args[Log_MAX_ARGS];
+    size_t                room;
+    int                   len;
+
+    if (Log_uart == NULL) {
+        return;
+    }
+
+    slot = UartDmaCC26XX_reserve(Log_uart, &data);
+    if (slot == NULL) {
+        Atomic_add32(&Log_dropped, 1);
+        return;
+    }
+
+    /* Keep room for "\r\n" */
+    room = UartDmaCC26XX_slotSize(Log_uart) - 2;
+
+    args[0] = a0;
+    args[1] = a1;
+    args[2] = a2;
+    args[3] = a3;
+
+    len = Fmt_snprintfArgs((char *)data, room + 1, fmt, args, nargs);
+    if (len < 0) {
+        len = SystemP_snprintf((char *)data, room + 1, fmt, a0, a1, a2, a3);
+    }
+    if (len < 0) {
+        len = 0;
+    }
+    else if ((size_t)len > room) {
+        len = room;
+    }
+
+    data[len++] = '\r';
+    data[len++] = '\n';
+
+    UartDmaCC26XX_commit(Log_uart, slot, len);
+}
+
+#else
+
+/*
+ *  ======== Log_putVarint ========
+ */
+static inline size_t Log_putVarint(uint8_t *dst, uint32_t value)
+{
+    size_t len = 0;
+
+    while (value >= 0x80) {
+        dst[len++] = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    dst[len++] = (uint8_t)value;
+
+    return (len);
+}
+
+/*
+ *  ======== Log_write ========
+ */
+void Log_write(const char *fmt, uint_fast8_t nargs, uintptr_t a0,
+               uintptr_t a1, uintptr_t a2, uintptr_t a3)
+{
+    UartDmaCC26XX_TxSlot *slot;
+    uint8_t               record[Log_MAX_RECORD_LEN];
+    uint8_t              *data;
+    uint16_t              token = (uint16_t)(uintptr_t)fmt;
+    uintptr_t             key;
+    size_t                len;
+
+    if (Log_uart == NULL) {
+        return;
+    }
+
+    record[0] = Log_FRAME_TYPE;
+    record[2] = (uint8_t)token;
+    record[3] = (uint8_t)(token >> 8);
+    len = 4;
+
+    if (nargs > 0) {
+        len += Log_putVarint(&record[len], a0);
+    }
+    if (nargs > 1) {
+        len += Log_putVarint(&record[len], a1);
+    }
+    if (nargs > 2) {
+        len += Log_putVarint(&record[len], a2);
+    }
+    if (nargs > 3) {
+        len += Log_putVarint(&record[len], a3);
+    }
+
+    /*
+     * Slots go out in the order they are claimed, so the number is taken
+     * with the slot. A full queue is counted in Log_dropped and leaves no
+     * gap, gaps only show records lost on the way to the decoder.
+     */
+    key = HwiP_disable();
+    slot = UartDmaCC26XX_tryReserve(Log_uart, &data);
+    if (slot != NULL) {
+        record[1] = (uint8_t)Log_seq++;
+    }
+    HwiP_restore(key);
+
+    if (slot == NULL) {
+        Atomic_add32(&Log_dropped, 1);
+        return;
+    }
+
+    data[0] = Cobs_DELIMITER;
+    len = Cobs_encode(record, len, &data[1]) + 1;
+    data[len++] = Cobs_DELIMITER;
+
+    UartDmaCC26XX_commit(Log_uart, slot, len);
+}
+
+#endif /* Log_TEXT */
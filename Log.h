@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Log.h
+ *
+ *  @brief      Deferred binary logging.
+ *
+ *  A Log_printN() statement does not format anything on the device. Its
+ *  format string is placed in the .log_fmt section, which the linker command
+ *  file maps to the LOG_DATA region with type = COPY: the strings are kept in
+ *  the ELF file but never loaded into flash. The device only sends a record
+ *  holding the low 16 bits of the string address (the token) and the raw
+ *  arguments. tools/logdecode.py looks the tokens up in the ELF file and
+ *  prints the formatted messages.
+ *
+ *  # Record format #
+ *  Each record is sent as a COBS packet, see Cobs.h:
+ *
+ *  | Offset | Size | Content                                          |
+ *  |--------|------|--------------------------------------------------|
+ *  | 0      | 1    | Log_FRAME_TYPE                                   |
+ *  | 1      | 1    | Sequence number, gaps show link losses           |
+ *  | 2      | 2    | Token, little endian                             |
+ *  | 4      | 1-5  | Each argument as an unsigned LEB128 varint       |
+ *
+ *  A "%s" argument must point to a string in flash; the decoder reads it
+ *  from the ELF file.
+ *
+ *  Records share the UART with Display output, the decoder passes text
+ *  through unchanged.
+ *
+ *  # Levels and modules #
+ *  Statements are normally written with a level and a module, for example
+ *  Log_error1(LogMod_NVS, ...). Modules and their compile time levels are
+ *  listed in LogConfig.h. A statement is compiled in only if its level is
+ *  enabled both by Log_LEVEL and by the module's LogMod_xxx_LEVEL; other
+ *  statements leave neither a call nor a string in the image and do not
+ *  evaluate their arguments.
+ *
+ *  Compiled in statements are also filtered at run time by Log_mask, one
+ *  byte per module with one bit per level, see Log_setLevel(). The check is
+ *  a single byte load and branch, as the module and level are constants.
+ *  The decoder prefixes each message with its level and module.
+ *
+ *  Log_printN() statements have no level and are always compiled in.
+ *
+ *  # Text mode #
+ *  Building with Log_TEXT=1 keeps the format strings in flash and formats
+ *  them on the device instead, for use with a plain terminal.
+ *
+ *  @code
+ *  Log_init(Board_UART0);
+ *  Log_info1(LogMod_NVS, "Reading value from page 0x%x", 0x12000);
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __LOG_H__
+#define __LOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef Log_TEXT
+#define Log_TEXT    0
+#endif
+
+/* Levels, in decreasing priority */
+#define Log_LEVEL_ERROR     0
+#define Log_LEVEL_WARNING   1
+#define Log_LEVEL_INFO      2
+#define Log_LEVEL_DEBUG     3
+
+/*!
+ *  Lowest priority level compiled in for all modules. Release builds
+ *  typically set this to Log_LEVEL_WARNING or Log_LEVEL_ERROR.
+ */
+#ifndef Log_LEVEL
+#define Log_LEVEL           Log_LEVEL_DEBUG
+#endif
+
+#include "LogConfig.h"
+
+/*! Log_mask value that enables @p level and every level above it */
+#define Log_MASK_UPTO(level)    ((uint8_t)((2U << (level)) - 1))
+
+/*! First byte of every log record packet */
+#define Log_FRAME_TYPE      0x4C
+
+/*! Largest number of arguments of a log statement */
+#define Log_MAX_ARGS        4
+
+/*
+ *  ======== Log_FMT ========
+ *  Declare the format string of one log statement.
+ */
+#if (Log_TEXT)
+#define Log_FMT(name, fmt)  static const char name[] = fmt
+#elif defined(__IAR_SYSTEMS_ICC__)
+#define Log_FMT(name, fmt)  _Pragma("location=\".log_fmt\"") \
+                            static const char name[] = fmt
+#else
+#define Log_FMT(name, fmt)  static const char name[] \
+                            __attribute__((section(".log_fmt"))) = fmt
+#endif
+
+#define Log_PRINT(fmt, nargs, a0, a1, a2, a3)                             \
+    do {                                                                  \
+        Log_FMT(Log_fmtStr, fmt);                                         \
+        Log_write(Log_fmtStr, (nargs), (uintptr_t)(a0), (uintptr_t)(a1),  \
+                  (uintptr_t)(a2), (uintptr_t)(a3));                      \
+    } while (0)
+
+/*
+ *  ======== Log_TAG ========
+ *  Level and module prefix of a format string, read by the decoder. Text
+ *  mode keeps flash usage unchanged and leaves it out.
+ */
+#if (Log_TEXT)
+#define Log_TAG(mod, level)     ""
+#else
+#define Log_TAG(mod, level)     level "|" #mod "|"
+#endif
+
+/* Run time filter of a leveled statement */
+#define Log_ENABLED(mod, level)     (Log_mask[mod] & (1U << (level)))
+
+#define Log_LPRINT_ON(mod, level, tag, fmt, nargs, a0, a1, a2, a3)        \
+    do {                                                                  \
+        if (Log_ENABLED(mod, level)) {                                    \
+            Log_PRINT(Log_TAG(mod, tag) fmt, nargs, a0, a1, a2, a3);      \
+        }                                                                 \
+    } while (0)
+
+#define Log_LPRINT_OFF(mod, level, tag, fmt, nargs, a0, a1, a2, a3)       \
+    ((void)0)
+
+/*
+ *  ======== Log_LPRINT ========
+ *  Compile time filter of a leveled statement. The preprocessor pastes the
+ *  statement's level and the module's LogMod_xxx_LEVEL into the name of a
+ *  Log_ON_<level>_<module level> entry, which selects Log_LPRINT_ON or
+ *  Log_LPRINT_OFF, so a statement filtered out leaves no string and no
+ *  call whatever the optimization level. LogMod_xxx_LEVEL must therefore
+ *  expand to a plain level number, as the Log_LEVEL_xxx names do.
+ */
+#define Log_LPRINT(mod, level, tag, fmt, nargs, a0, a1, a2, a3)           \
+    Log_SELECT(level, mod##_LEVEL)(mod, level, tag, fmt, nargs,           \
+                                   a0, a1, a2, a3)
+
+#define Log_SELECT(level, modLevel)     Log_SELECT_(level, modLevel)
+#define Log_SELECT_(level, modLevel)    Log_ON_##level##_##modLevel
+
+#define Log_ON_0_0  Log_LPRINT_ON
+#define Log_ON_0_1  Log_LPRINT_ON
+#define Log_ON_0_2  Log_LPRINT_ON
+#define Log_ON_0_3  Log_LPRINT_ON
+#define Log_ON_1_0  Log_LPRINT_OFF
+#define Log_ON_1_1  Log_LPRINT_ON
+#define Log_ON_1_2  Log_LPRINT_ON
+#define Log_ON_1_3  Log_LPRINT_ON
+#define Log_ON_2_0  Log_LPRINT_OFF
+#define Log_ON_2_1  Log_LPRINT_OFF
+#define Log_ON_2_2  Log_LPRINT_ON
+#define Log_ON_2_3  Log_LPRINT_ON
+#define Log_ON_3_0  Log_LPRINT_OFF
+#define Log_ON_3_1  Log_LPRINT_OFF
+#define Log_ON_3_2  Log_LPRINT_OFF
+#define Log_ON_3_3  Log_LPRINT_ON
+
+/*!
+ *  @brief  Log a message with no arguments
+ *
+ *  @p fmt must be a string literal.
+ */
+#define Log_print0(fmt) \
+    Log_PRINT(fmt, 0, 0, 0, 0, 0)
+
+/*! @brief  Log a message with one argument */
+#define Log_print1(fmt, a0) \
+    Log_PRINT(fmt, 1, a0, 0, 0, 0)
+
+/*! @brief  Log a message with two arguments */
+#define Log_print2(fmt, a0, a1) \
+    Log_PRINT(fmt, 2, a0, a1, 0, 0)
+
+/*! @brief  Log a message with three arguments */
+#define Log_print3(fmt, a0, a1, a2) \
+    Log_PRINT(fmt, 3, a0, a1, a2, 0)
+
+/*! @brief  Log a message with four arguments */
+#define Log_print4(fmt, a0, a1, a2, a3) \
+    Log_PRINT(fmt, 4, a0, a1, a2, a3)
+
+/*
+ *  ======== Log_error0 .. Log_error4 ========
+ *  Log errors of module @p mod.
+ */
+#if (Log_LEVEL >= Log_LEVEL_ERROR)
+#define Log_error0(mod, fmt) \
+    Log_LPRINT(mod, Log_LEVEL_ERROR, "E", fmt, 0, 0, 0, 0, 0)
+#define Log_error1(mod, fmt, a0) \
+    Log_LPRINT(mod, Log_LEVEL_ERROR, "E", fmt, 1, a0, 0, 0, 0)
+#define Log_error2(mod, fmt, a0, a1) \
+    Log_LPRINT(mod, Log_LEVEL_ERROR, "E", fmt, 2, a0, a1, 0, 0)
+#define Log_error3(mod, fmt, a0, a1, a2) \
+    Log_LPRINT(mod, Log_LEVEL_ERROR, "E", fmt, 3, a0, a1, a2, 0)
+#define Log_error4(mod, fmt, a0, a1, a2, a3) \
+    Log_LPRINT(mod, Log_LEVEL_ERROR, "E", fmt, 4, a0, a1, a2, a3)
+#else
+#define Log_error0(mod, fmt)                   ((void)0)
+#define Log_error1(mod, fmt, a0)               ((void)0)
+#define Log_error2(mod, fmt, a0, a1)           ((void)0)
+#define Log_error3(mod, fmt, a0, a1, a2)       ((void)0)
+#define Log_error4(mod, fmt, a0, a1, a2, a3)   ((void)0)
+#endif
+
+/*
+ *  ======== Log_warning0 .. Log_warning4 ========
+ *  Log warnings of module @p mod.
+ */
+#if (Log_LEVEL >= Log_LEVEL_WARNING)
+#define Log_warning0(mod, fmt) \
+    Log_LPRINT(mod, Log_LEVEL_WARNING, "W", fmt, 0, 0, 0, 0, 0)
+#define Log_warning1(mod, fmt, a0) \
+    Log_LPRINT(mod, Log_LEVEL_WARNING, "W", fmt, 1, a0, 0, 0, 0)
+#define Log_warning2(mod, fmt, a0, a1) \
+    Log_LPRINT(mod, Log_LEVEL_WARNING, "W", fmt, 2, a0, a1, 0, 0)
+#define Log_warning3(mod, fmt, a0, a1, a2) \
+    Log_LPRINT(mod, Log_LEVEL_WARNING, "W", fmt, 3, a0, a1, a2, 0)
+#define Log_warning4(mod, fmt, a0, a1, a2, a3) \
+    Log_LPRINT(mod, Log_LEVEL_WARNING, "W", fmt, 4, a0, a1, a2, a3)
+#else
+#define Log_warning0(mod, fmt)                   ((void)0)
+#define Log_warning1(mod, fmt, a0)               ((void)0)
+#define Log_warning2(mod, fmt, a0, a1)           ((void)0)
+#define Log_warning3(mod, fmt, a0, a1, a2)       ((void)0)
+#define Log_warning4(mod, fmt, a0, a1, a2, a3)   ((void)0)
+#endif
+
+/*
+ *  ======== Log_info0 .. Log_info4 ========
+ *  Log informational messages of module @p mod.
+ */
+#if (Log_LEVEL >= Log_LEVEL_INFO)
+#define Log_info0(mod, fmt) \
+    Log_LPRINT(mod, Log_LEVEL_INFO, "I", fmt, 0, 0, 0, 0, 0)
+#define Log_info1(mod, fmt, a0) \
+    Log_LPRINT(mod, Log_LEVEL_INFO, "I", fmt, 1, a0, 0, 0, 0)
+#define Log_info2(mod, fmt, a0, a1) \
+    Log_LPRINT(mod, Log_LEVEL_INFO, "I", fmt, 2, a0, a1, 0, 0)
+#define Log_info3(mod, fmt, a0, a1, a2) \
+    Log_LPRINT(mod, Log_LEVEL_INFO, "I", fmt, 3, a0, a1, a2, 0)
+#define Log_info4(mod, fmt, a0, a1, a2, a3) \
+    Log_LPRINT(mod, Log_LEVEL_INFO, "I", fmt, 4, a0, a1, a2, a3)
+#else
+#define Log_info0(mod, fmt)                   ((void)0)
+#define Log_info1(mod, fmt, a0)               ((void)0)
+#define Log_info2(mod, fmt, a0, a1)           ((void)0)
+#define Log_info3(mod, fmt, a0, a1, a2)       ((void)0)
+#define Log_info4(mod, fmt, a0, a1, a2, a3)   ((void)0)
+#endif
+
+/*
+ *  ======== Log_debug0 .. Log_debug4 ========
+ *  Log debug messages of module @p mod.
+ */
+#if (Log_LEVEL >= Log_LEVEL_DEBUG)
+#define Log_debug0(mod, fmt) \
+    Log_LPRINT(mod, Log_LEVEL_DEBUG, "D", fmt, 0, 0, 0, 0, 0)
+#define Log_debug1(mod, fmt, a0) \
+    Log_LPRINT(mod, Log_LEVEL_DEBUG, "D", fmt, 1, a0, 0, 0, 0)
+#define Log_debug2(mod, fmt, a0, a1) \
+    Log_LPRINT(mod, Log_LEVEL_DEBUG, "D", fmt, 2, a0, a1, 0, 0)
+#define Log_debug3(mod, fmt, a0, a1, a2) \
+    Log_LPRINT(mod, Log_LEVEL_DEBUG, "D", fmt, 3, a0, a1, a2, 0)
+#define Log_debug4(mod, fmt, a0, a1, a2, a3) \
+    Log_LPRINT(mod, Log_LEVEL_DEBUG, "D", fmt, 4, a0, a1, a2, a3)
+#else
+#define Log_debug0(mod, fmt)                   ((void)0)
+#define Log_debug1(mod, fmt, a0)               ((void)0)
+#define Log_debug2(mod, fmt, a0, a1)           ((void)0)
+#define Log_debug3(mod, fmt, a0, a1, a2)       ((void)0)
+#define Log_debug4(mod, fmt, a0, a1, a2, a3)   ((void)0)
+#endif
+
+/*!
+ *  @brief  Run time level mask, one byte per module
+ *
+ *  Bit n enables level n. Use Log_setLevel() or Log_setMask() to change it.
+ */
+extern volatile uint8_t Log_mask[LogMod_COUNT];
+
+/*!
+ *  @brief  Start sending log records on a UartDmaCC26XX instance
+ *
+ *  Uses the instance if it is already open, for example by the
+ *  DisplayUartDma display, and opens it with default parameters otherwise.
+ *  Enables every compiled in level of every module. Log statements before
+ *  Log_init() are discarded.
+ *
+ *  @return true on success.
+ */
+extern bool Log_init(uint_least8_t uartIndex);
+
+/*!
+ *  @brief  Enable @p level and all levels above it for module @p mod
+ *
+ *  Levels that were not compiled in stay disabled.
+ */
+extern void Log_setLevel(uint_least8_t mod, uint_least8_t level);
+
+/*!
+ *  @brief  Set the run time level mask of module @p mod
+ */
+extern void Log_setMask(uint_least8_t mod, uint8_t mask);
+
+/*!
+ *  @brief  Number of records lost because the UART queue was full
+ *
+ *  Such records take no sequence number. Binary records never wait for
+ *  room in the queue, whatever its overflow policy.
+ */
+extern uint32_t Log_getDropped(void);
+
+/*!
+ *  @brief  Back end of the Log_printN() macros, not to be called directly
+ */
+extern void Log_write(const char *fmt, uint_fast8_t nargs, uintptr_t a0,
+                      uintptr_t a1, uintptr_t a2, uintptr_t a3);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LOG_H__ */
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       LogConfig.h
+ *
+ *  @brief      Log modules of this application, see Log.h.
+ *
+ *  Every module has an entry in LogMod and a LogMod_xxx_LEVEL giving the
+ *  lowest priority level that is compiled in for it. The levels can be
+ *  overridden from the build options, e.g. -DLogMod_NVS_LEVEL=Log_LEVEL_ERROR.
+ *  A level must be one of the Log_LEVEL_xxx names or its number, as Log.h
+ *  pastes it into a macro name.
+ *
+ *  Included by Log.h only.
+ *
+ *  ============================================================================
+ */
+#ifndef __LOGCONFIG_H__
+#define __LOGCONFIG_H__
+
+/*!
+ *  @brief  Log modules
+ *
+ *  Enumerators rather than macros, so that the module name survives macro
+ *  expansion in the Log statements.
+ */
+typedef enum LogMod {
+    LogMod_APP = 0,     /*!< Application flow */
+    LogMod_NVS,         /*!< Non-volatile storage accesses */
+
+    LogMod_COUNT
+} LogMod;
+
+#ifndef LogMod_APP_LEVEL
+#define LogMod_APP_LEVEL    Log_LEVEL_DEBUG
+#endif
+
+#ifndef LogMod_NVS_LEVEL
+#define LogMod_NVS_LEVEL    Log_LEVEL_DEBUG
+#endif
+
+#endif /* __LOGCONFIG_H__ */
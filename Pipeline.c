@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Pipeline.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Pipeline.h"
+
+static void Pipeline_construct(Pipeline_Queue *queue, uint8_t depth,
+                               uint8_t count);
+static void Pipeline_destruct(Pipeline_Object *object);
+static Pipeline_Record *Pipeline_get(Pipeline_Queue *queue, bool *waited);
+static bool Pipeline_put(Pipeline_Queue *queue, Pipeline_Record *record);
+static void *Pipeline_stageFxn(void *arg);
+
+/*
+ *  ======== Pipeline_start ========
+ */
+bool Pipeline_start(Pipeline_Object *object, Pipeline_Config const *config)
+{
+    Pipeline_Stage const *stage;
+    Pipeline_Record      *record;
+    StaticThread_Config   thread;
+    unsigned int          i;
+
+    if ((config->stageCount == 0) ||
+        (config->stageCount > Pipeline_MAX_STAGES) ||
+        (config->recordCount == 0) ||
+        (config->recordCount > Pipeline_MAX_RECORDS) ||
+        (config->recordBuf == NULL)) {
+        return (false);
+    }
+    for (i = 0; i < config->stageCount - 1U; i++) {
+        if ((config->stages[i].queueDepth == 0) ||
+            (config->stages[i].queueDepth > Pipeline_MAX_RECORDS)) {
+            return (false);
+        }
+    }
+
+    memset(object, 0, sizeof(Pipeline_Object));
+    object->config = config;
+
+    /* The pool starts out holding every record */
+    for (i = 0; i < config->recordCount; i++) {
+        record = &object->records[i];
+        record->data = &config->recordBuf[i * config->recordSize];
+        record->size = config->recordSize;
+        object->pool.slots[i] = record;
+    }
+    Pipeline_construct(&object->pool, config->recordCount,
+            config->recordCount);
+
+    for (i = 0; i < config->stageCount - 1U; i++) {
+        Pipeline_construct(&object->queues[i], config->stages[i].queueDepth,
+                0);
+    }
+
+    SemaphoreP_constructBinary(&object->done, 0);
+    object->startTicks = ClockP_getSystemTicks();
+
+    /*
+     * From the last stage to the first, so that a failure leaves only
+     * later stages running, which an end marker can stop.
+     */
+    for (i = config->stageCount; i-- > 0;) {
+        stage = &config->stages[i];
+        object->stages[i].pipeline = object;
+        object->stages[i].index    = i;
+
+        thread.name      = stage->name;
+        thread.fxn       = Pipeline_stageFxn;
+        thread.arg       = &object->stages[i];
+        thread.priority  = stage->priority;
+        thread.stack     = stage->stack;
+        thread.stackSize = stage->stackSize;
+
+        if (!StaticThread_construct(&object->stages[i].thread, &thread)) {
+            if (i + 1U < config->stageCount) {
+                record = Pipeline_get(&object->pool, NULL);
+                record->flags = Pipeline_FLAG_END;
+                Pipeline_put(&object->queues[i], record);
+                SemaphoreP_pend(&object->done, SemaphoreP_WAIT_FOREVER);
+            }
+            while (++i < config->stageCount) {
+                StaticThread_join(&object->stages[i].thread);
+            }
+            Pipeline_destruct(object);
+
+            return (false);
+        }
+    }
+
+    object->running = true;
+
+    return (true);
+}
+
+/*
+ *  ======== Pipeline_stop ========
+ */
+void Pipeline_stop(Pipeline_Object *object)
+{
+    unsigned int i;
+
+    if (!object->running) {
+        return;
+    }
+
+    object->stopping = true;
+    SemaphoreP_pend(&object->done, SemaphoreP_WAIT_FOREVER);
+
+    /* The stacks may be reused once the threads have returned */
+    for (i = 0; i < object->config->stageCount; i++) {
+        StaticThread_join(&object->stages[i].thread);
+    }
+
+    Pipeline_destruct(object);
+    object->running = false;
+}
+
+/*
+ *  ======== Pipeline_getStats ========
+ */
+void Pipeline_getStats(Pipeline_Object *object, Pipeline_Stats *stats)
+{
+    Pipeline_Queue *queue;
+    uintptr_t       key;
+    unsigned int    i;
+
+    memset(stats, 0, sizeof(Pipeline_Stats));
+    if (object->config == NULL) {
+        return;
+    }
+
+    key = HwiP_disable();
+
+    stats->ticks        = ClockP_getSystemTicks() - object->startTicks;
+    stats->overruns     = object->overruns;
+    stats->latencyCount = object->latencyCount;
+    stats->latencyMin   = object->latencyMin;
+    stats->latencyMax   = object->latencyMax;
+    stats->latencyTotal = object->latencyTotal;
+    stats->stageCount   = object->config->stageCount;
+
+    for (i = 0; i < stats->stageCount; i++) {
+        stats->stages[i] = object->stages[i].stats;
+    }
+
+    /* For the pool, count is the free records and highWater the most used */
+    stats->pool.depth     = object->pool.depth;
+    stats->pool.count     = object->pool.count;
+    stats->pool.highWater = object->pool.depth - object->pool.lowWater;
+
+    for (i = 0; i + 1U < stats->stageCount; i++) {
+        queue = &object->queues[i];
+        stats->queues[i].depth     = queue->depth;
+        stats->queues[i].count     = queue->count;
+        stats->queues[i].highWater = queue->highWater;
+    }
+
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== Pipeline_construct ========
+ *  The first @p count slots must already hold records.
+ */
+static void Pipeline_construct(Pipeline_Queue *queue, uint8_t depth,
+                               uint8_t count)
+{
+    SemaphoreP_Params semParams;
+
+    queue->depth     = depth;
+    queue->head      = 0;
+    queue->count     = count;
+    queue->highWater = count;
+    queue->lowWater  = count;
+
+    SemaphoreP_Params_init(&semParams);
+    semParams.mode = SemaphoreP_Mode_COUNTING;
+    SemaphoreP_construct(&queue->items, count, &semParams);
+    SemaphoreP_construct(&queue->spaces, depth - count, &semParams);
+}
+
+/*
+ *  ======== Pipeline_destruct ========
+ */
+static void Pipeline_destruct(Pipeline_Object *object)
+{
+    unsigned int i;
+
+    SemaphoreP_destruct(&object->pool.items);
+    SemaphoreP_destruct(&object->pool.spaces);
+
+    for (i = 0; i + 1U < object->config->stageCount; i++) {
+        SemaphoreP_destruct(&object->queues[i].items);
+        SemaphoreP_destruct(&object->queues[i].spaces);
+    }
+
+    SemaphoreP_destruct(&object->done);
+}
+
+/*
+ *  ======== Pipeline_get ========
+ *  Sets *waited if the queue was empty.
+ */
+static Pipeline_Record *Pipeline_get(Pipeline_Queue *queue, bool *waited)
+{
+    Pipeline_Record *record;
+    uintptr_t        key;
+    bool             empty = false;
+
+    if (SemaphoreP_pend(&queue->items, 0) != SemaphoreP_OK) {
+        empty = true;
+        SemaphoreP_pend(&queue->items, SemaphoreP_WAIT_FOREVER);
+    }
+
+    key = HwiP_disable();
+
+    record = queue->slots[queue->head];
+    queue->head = (queue->head + 1 == queue->depth) ? 0 : queue->head + 1;
+    queue->count--;
+    if (queue->count < queue->lowWater) {
+        queue->lowWater = queue->count;
+    }
+
+    HwiP_restore(key);
+
+    SemaphoreP_post(&queue->spaces);
+
+    if (waited != NULL) {
+        *waited = empty;
+    }
+
+    return (record);
+}
+
+/*
+ *  ======== Pipeline_put ========
+ *  Returns true if the queue was full.
+ */
+static bool Pipeline_put(Pipeline_Queue *queue, Pipeline_Record *record)
+{
+    uintptr_t    key;
+    unsigned int tail;
+    bool         full = false;
+
+    if (SemaphoreP_pend(&queue->spaces, 0) != SemaphoreP_OK) {
+        full = true;
+        SemaphoreP_pend(&queue->spaces, SemaphoreP_WAIT_FOREVER);
+    }
+
+    key = HwiP_disable();
+
+    tail = queue->head + queue->count;
+    if (tail >= queue->depth) {
+        tail -= queue->depth;
+    }
+    queue->slots[tail] = record;
+    queue->count++;
+    if (queue->count > queue->highWater) {
+        queue->highWater = queue->count;
+    }
+
+    HwiP_restore(key);
+
+    SemaphoreP_post(&queue->items);
+
+    return (full);
+}
+
+/*
+ *  ======== Pipeline_stageFxn ========
+ */
+static void *Pipeline_stageFxn(void *arg)
+{
+    Pipeline_StageState  *state = (Pipeline_StageState *)arg;
+    Pipeline_Object      *object = state->pipeline;
+    Pipeline_Stage const *stage = &object->config->stages[state->index];
+    bool                  first = (state->index == 0);
+    bool                  last = (state->index + 1U ==
+                                  object->config->stageCount);
+    Pipeline_Queue       *in;
+    Pipeline_Queue       *out;
+    Pipeline_Record      *record;
+    uint32_t              start;
+    uint32_t              end;
+    uint32_t              latency;
+    uintptr_t             key;
+    bool                  waited;
+    bool                  keep;
+
+    in  = first ? &object->pool : &object->queues[state->index - 1];
+    out = last ? &object->pool : &object->queues[state->index];
+
+    for (;;) {
+        record = Pipeline_get(in, &waited);
+
+        if (first) {
+            if (waited) {
+                object->overruns++;
+            }
+            if (object->stopping) {
+                record->flags = Pipeline_FLAG_END;
+            }
+            else {
+                record->flags  = 0;
+                record->length = 0;
+                record->seq    = object->seq++;
+            }
+        }
+
+        if (record->flags & Pipeline_FLAG_END) {
+            Pipeline_put(out, record);
+            if (last) {
+                SemaphoreP_post(&object->done);
+            }
+
+            return (NULL);
+        }
+
+        start = ClockP_getSystemTicks();
+        keep  = stage->fxn(record, stage->arg);
+        end   = ClockP_getSystemTicks();
+
+        if (first) {
+            record->timestamp = end;
+        }
+
+        key = HwiP_disable();
+
+        state->stats.records++;
+        state->stats.busyTicks += end - start;
+        if (!keep) {
+            state->stats.dropped++;
+        }
+        else if (last) {
+            latency = end - record->timestamp;
+            if ((object->latencyCount == 0) ||
+                (latency < object->latencyMin)) {
+                object->latencyMin = latency;
+            }
+            if (latency > object->latencyMax) {
+                object->latencyMax = latency;
+            }
+            object->latencyTotal += latency;
+            object->latencyCount++;
+        }
+
+        HwiP_restore(key);
+
+        if (!keep) {
+            /* The pool holds every record, this never blocks */
+            Pipeline_put(&object->pool, record);
+        }
+        else if (Pipeline_put(out, record)) {
+            state->stats.fullWaits++;
+        }
+    }
+}
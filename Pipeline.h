@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Pipeline.h
+ *
+ *  @brief      Chain of threads passing records through bounded queues.
+ *
+ *  A pipeline is a fixed number of stages, each running in its own thread
+ *  with its own priority and stack. Records are taken from a pool, filled
+ *  by the first stage, handed from stage to stage and returned to the pool
+ *  by the last one:
+ *
+ *      pool -> stage 0 -> queue 0 -> stage 1 -> queue 1 -> ... -> pool
+ *
+ *  Only record handles travel through the queues; the data stays where the
+ *  first stage wrote it and later stages work on it in place.
+ *
+ *  A stage function returns false to drop its record, which then goes back
+ *  to the pool without reaching the later stages.
+ *
+ *  # Backpressure #
+ *  A stage blocks when its output queue is full, and the first stage blocks
+ *  when the pool is empty. A slow stage therefore only stalls the earlier
+ *  ones once all records are queued behind it; until then the queues absorb
+ *  it. The first stage counts the times it had to wait for a record as
+ *  overruns, so an undersized pool shows up in the statistics.
+ *
+ *  # Statistics #
+ *  Pipeline_getStats() returns the records and busy time of each stage, the
+ *  fill level of each queue and the latency from the end of the first stage
+ *  to the end of the last one, in ClockP ticks.
+ *
+ *  All functions must be called from Task context.
+ *
+ *  ============================================================================
+ */
+#ifndef __PIPELINE_H__
+#define __PIPELINE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "StaticThread.h"
+
+/*! Largest number of stages of a pipeline */
+#define Pipeline_MAX_STAGES     4
+
+/*! Largest number of records of a pipeline */
+#define Pipeline_MAX_RECORDS    16
+
+/*! Record flag: last record, stages exit after passing it on */
+#define Pipeline_FLAG_END       0x0001
+
+/*!
+ *  @brief  A record, passed between the stages by reference
+ */
+typedef struct Pipeline_Record {
+    uint8_t  *data;       /*!< Record buffer, set by Pipeline_start() */
+    uint16_t  size;       /*!< Size of @p data */
+    uint16_t  length;     /*!< Bytes of @p data in use */
+    uint16_t  flags;      /*!< Pipeline_FLAG_xxx, owned by the pipeline */
+    uint32_t  seq;        /*!< Sequence number, set before stage 0 */
+    uint32_t  timestamp;  /*!< ClockP ticks at the end of stage 0 */
+} Pipeline_Record;
+
+/*!
+ *  @brief  Stage function
+ *
+ *  @param  record  Record to work on, owned by the stage until it returns
+ *  @param  arg     Argument of the stage configuration
+ *
+ *  @return false to drop the record
+ */
+typedef bool (*Pipeline_StageFxn)(Pipeline_Record *record, void *arg);
+
+/*!
+ *  @brief  A stage, in the pipeline configuration
+ */
+typedef struct Pipeline_Stage {
+    const char        *name;        /*!< Name shown in reports */
+    Pipeline_StageFxn  fxn;
+    void              *arg;
+    int                priority;    /*!< Thread priority */
+    void              *stack;       /*!< Thread stack, see
+                                         StaticThread_STACK() */
+    size_t             stackSize;
+    uint8_t            queueDepth;  /*!< Records the output queue holds, at
+                                         most Pipeline_MAX_RECORDS; unused
+                                         for the last stage */
+} Pipeline_Stage;
+
+/*!
+ *  @brief  Pipeline configuration
+ */
+typedef struct Pipeline_Config {
+    Pipeline_Stage const *stages;       /*!< Stages, in processing order */
+    uint8_t               stageCount;   /*!< Entries of @p stages */
+    uint8_t               recordCount;  /*!< Records in the pool, at most
+                                             Pipeline_MAX_RECORDS */
+    uint16_t              recordSize;   /*!< Bytes per record */
+    uint8_t              *recordBuf;    /*!< recordCount * recordSize bytes */
+} Pipeline_Config;
+
+/*!
+ *  @brief  Counters of one stage
+ */
+typedef struct Pipeline_StageStats {
+    uint32_t records;    /*!< Records processed */
+    uint32_t dropped;    /*!< Records the stage function dropped */
+    uint32_t busyTicks;  /*!< ClockP ticks spent in the stage function */
+    uint32_t fullWaits;  /*!< Times the output queue was full */
+} Pipeline_StageStats;
+
+/*!
+ *  @brief  Fill level of one queue
+ */
+typedef struct Pipeline_QueueStats {
+    uint8_t depth;       /*!< Capacity */
+    uint8_t count;       /*!< Records queued now */
+    uint8_t highWater;   /*!< Most records queued at the same time */
+} Pipeline_QueueStats;
+
+/*!
+ *  @brief  Counters of a pipeline
+ */
+typedef struct Pipeline_Stats {
+    uint32_t            ticks;        /*!< ClockP ticks since the start */
+    uint32_t            overruns;     /*!< Times stage 0 found the pool
+                                           empty */
+    uint32_t            latencyCount; /*!< Records that left the last stage */
+    uint32_t            latencyMin;   /*!< In ClockP ticks */
+    uint32_t            latencyMax;
+    uint32_t            latencyTotal;
+    uint8_t             stageCount;   /*!< Valid entries of the arrays */
+    Pipeline_StageStats stages[Pipeline_MAX_STAGES];
+    Pipeline_QueueStats pool;         /*!< Free records */
+    Pipeline_QueueStats queues[Pipeline_MAX_STAGES - 1];
+} Pipeline_Stats;
+
+/*!
+ *  @brief  Bounded queue of record handles
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Pipeline_Queue {
+    Pipeline_Record   *slots[Pipeline_MAX_RECORDS];
+    uint8_t            depth;
+    uint8_t            head;
+    uint8_t            count;
+    uint8_t            highWater;
+    uint8_t            lowWater;
+    SemaphoreP_Struct  items;
+    SemaphoreP_Struct  spaces;
+} Pipeline_Queue;
+
+struct Pipeline_Object;
+
+/*!
+ *  @brief  State of one stage
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Pipeline_StageState {
+    struct Pipeline_Object *pipeline;
+    uint8_t                 index;
+    StaticThread_Struct     thread;
+    Pipeline_StageStats     stats;
+} Pipeline_StageState;
+
+/*!
+ *  @brief  Pipeline object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Pipeline_Object {
+    Pipeline_Config const *config;
+    Pipeline_Record        records[Pipeline_MAX_RECORDS];
+    Pipeline_Queue         pool;
+    Pipeline_Queue         queues[Pipeline_MAX_STAGES - 1];
+    Pipeline_StageState    stages[Pipeline_MAX_STAGES];
+    SemaphoreP_Struct      done;
+    volatile bool          stopping;
+    bool                   running;
+    uint32_t               seq;
+    uint32_t               startTicks;
+    uint32_t               overruns;
+    uint32_t               latencyCount;
+    uint32_t               latencyMin;
+    uint32_t               latencyMax;
+    uint32_t               latencyTotal;
+} Pipeline_Object;
+
+/*!
+ *  @brief  Start the stage threads
+ *
+ *  @param  object  Pipeline object, statically allocated by the caller
+ *  @param  config  Configuration, must stay valid while the pipeline runs
+ *
+ *  @return false if the configuration is invalid or a thread could not be
+ *          created.
+ */
+extern bool Pipeline_start(Pipeline_Object *object,
+                           Pipeline_Config const *config);
+
+/*!
+ *  @brief  Stop the pipeline
+ *
+ *  Stage 0 finishes the record it is working on and sends an end marker
+ *  after it. Returns once the marker has passed the last stage, that is
+ *  when every queued record has been processed and all stage threads have
+ *  exited.
+ */
+extern void Pipeline_stop(Pipeline_Object *object);
+
+/*!
+ *  @brief  Read the counters
+ */
+extern void Pipeline_getStats(Pipeline_Object *object, Pipeline_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PIPELINE_H__ */
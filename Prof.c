@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Prof.c ========
+ */
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "Dwt.h"
+#include "Prof.h"
+
+#if (Prof_ENABLE)
+
+Prof_Entry Prof_table[ProfSite_COUNT];
+uint32_t   Prof_overhead;
+
+static const char *const Prof_names[ProfSite_COUNT] = ProfSite_NAMES;
+
+static uint32_t Prof_net(uint32_t cycles);
+
+/*
+ *  ======== Prof_init ========
+ */
+void Prof_init(void)
+{
+    unsigned int i;
+
+    Dwt_enable();
+
+    for (i = 0; i < ProfSite_COUNT; i++) {
+        Prof_table[i].name  = Prof_names[i];
+        Prof_table[i].calls = 0;
+        Prof_table[i].min   = UINT32_MAX;
+        Prof_table[i].max   = 0;
+        Prof_table[i].total = 0;
+    }
+
+    /* The cheapest of a few empty scopes, the first one loads the cache */
+    for (i = 0; i < 4; i++) {
+        Prof_SCOPE(ProfSite_NVS_READ, );
+    }
+    Prof_overhead = Prof_table[ProfSite_NVS_READ].min;
+
+    Prof_table[ProfSite_NVS_READ].calls = 0;
+    Prof_table[ProfSite_NVS_READ].min   = UINT32_MAX;
+    Prof_table[ProfSite_NVS_READ].max   = 0;
+    Prof_table[ProfSite_NVS_READ].total = 0;
+}
+
+/*
+ *  ======== Prof_print ========
+ */
+void Prof_print(Display_Handle handle)
+{
+    Prof_Entry   entry;
+    uintptr_t    key;
+    unsigned int i;
+
+    Display_printf(handle, 0, 0, "Profile, less %u cycles per scope:",
+            Prof_overhead);
+
+    for (i = 0; i < ProfSite_COUNT; i++) {
+        /* A consistent copy, the entry keeps changing */
+        key = HwiP_disable();
+        entry = Prof_table[i];
+        HwiP_restore(key);
+        if (entry.calls == 0) {
+            continue;
+        }
+        Display_printf(handle, 0, 0,
+                "  %s: %u calls, min %u, avg %u, max %u cycles",
+                entry.name, entry.calls, Prof_net(entry.min),
+                Prof_net((uint32_t)(entry.total / entry.calls)),
+                Prof_net(entry.max));
+    }
+}
+
+/*
+ *  ======== Prof_net ========
+ *  Cycles of a scope without those of the measurement.
+ */
+static uint32_t Prof_net(uint32_t cycles)
+{
+    return ((cycles > Prof_overhead) ? (cycles - Prof_overhead) : 0);
+}
+
+#endif /* Prof_ENABLE */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Prof.h
+ *
+ *  @brief      Cycle counts of selected call sites.
+ *
+ *  A scope reads the DWT cycle counter before and after the code it wraps
+ *  and adds the difference to the fixed entry of its site, which keeps the
+ *  number of calls and the lowest, highest and total cycle count. Sites
+ *  are listed in ProfConfig.h; their entries live in Prof_table, so the
+ *  debugger's expression view or ROV shows them without stopping anything
+ *  but the CPU, and Prof_print() dumps them over the display.
+ *
+ *  @code
+ *  Prof_SCOPE(ProfSite_NVS_READ,
+ *             status = NVS_read(handle, offset, buffer, size));
+ *  @endcode
+ *
+ *  Function bodies, such as driver callbacks, use a pair of statements:
+ *
+ *  @code
+ *  Prof_BEGIN(start);
+ *  ...
+ *  Prof_END(ProfSite_UART_HWI, start);
+ *  @endcode
+ *
+ *  Profiling is off unless the build defines Prof_ENABLE to 1. Otherwise
+ *  the macros leave only the wrapped code and Prof.c compiles to nothing.
+ *
+ *  Inside the measured window a scope adds a single counter read; the
+ *  bookkeeping after it masks all interrupts for a dozen cycles so that a
+ *  site entered from several threads stays consistent. Prof_init() measures
+ *  the cost of an empty scope, which Prof_print() takes off every figure.
+ *  Nested scopes charge the inner cost to both sites, and preemption
+ *  inside a scope is charged to it.
+ *
+ *  ============================================================================
+ */
+#ifndef __PROF_H__
+#define __PROF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+
+#include "Dwt.h"
+#include "ProfConfig.h"
+
+#ifndef Prof_ENABLE
+#define Prof_ENABLE         0
+#endif
+
+#if (Prof_ENABLE)
+
+#if defined(__IAR_SYSTEMS_ICC__)
+#include <intrinsics.h>
+#endif
+
+/*!
+ *  @brief  Cycle counts of one site
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Prof_Entry {
+    const char *name;       /*!< From ProfSite_NAMES */
+    uint32_t    calls;      /*!< Completed scopes */
+    uint32_t    min;        /*!< Fewest cycles of a scope */
+    uint32_t    max;        /*!< Most cycles of a scope */
+    uint64_t    total;      /*!< Cycles of all scopes */
+} Prof_Entry;
+
+/*! One entry per ProfSite */
+extern Prof_Entry Prof_table[ProfSite_COUNT];
+
+/*! Cycles of an empty scope, measured by Prof_init() */
+extern uint32_t Prof_overhead;
+
+/*!
+ *  @brief  Add one scope of @p cycles to @p site
+ *
+ *  Callable from any context.
+ */
+static inline void Prof_record(ProfSite site, uint32_t cycles)
+{
+    Prof_Entry *entry = &Prof_table[site];
+#if defined(__TI_COMPILER_VERSION__)
+    uint32_t    key = _disable_IRQ();
+#elif defined(__IAR_SYSTEMS_ICC__)
+    uint32_t    key = __get_PRIMASK();
+
+    __disable_interrupt();
+#elif defined(__GNUC__)
+    uint32_t    key;
+
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (key) :: "memory");
+#endif
+
+    entry->calls++;
+    entry->total += cycles;
+    if (cycles < entry->min) {
+        entry->min = cycles;
+    }
+    if (cycles > entry->max) {
+        entry->max = cycles;
+    }
+
+#if defined(__TI_COMPILER_VERSION__)
+    _restore_interrupts(key);
+#elif defined(__IAR_SYSTEMS_ICC__)
+    __set_PRIMASK(key);
+#elif defined(__GNUC__)
+    __asm volatile ("msr primask, %0" :: "r" (key) : "memory");
+#endif
+}
+
+/*!
+ *  @brief  Measure @p stmt as one scope of @p site
+ */
+#define Prof_SCOPE(site, stmt)                              \
+    do {                                                    \
+        uint32_t Prof_start_ = Dwt_cycles();                \
+        stmt;                                               \
+        Prof_record((site), Dwt_cycles() - Prof_start_);    \
+    } while (0)
+
+/*!
+ *  @brief  Start a scope, declaring @p start
+ */
+#define Prof_BEGIN(start)   uint32_t start = Dwt_cycles()
+
+/*!
+ *  @brief  End the scope started by Prof_BEGIN(@p start)
+ */
+#define Prof_END(site, start) \
+    Prof_record((site), Dwt_cycles() - (start))
+
+/*!
+ *  @brief  Enable the cycle counter and reset all entries
+ *
+ *  Call from main() before the kernel starts.
+ */
+extern void Prof_init(void);
+
+/*!
+ *  @brief  Print the entries that have been entered
+ *
+ *  Must be called from Task context.
+ */
+extern void Prof_print(Display_Handle handle);
+
+#else /* Prof_ENABLE */
+
+#define Prof_SCOPE(site, stmt)  do { stmt; } while (0)
+#define Prof_BEGIN(start)
+#define Prof_END(site, start)   ((void)0)
+#define Prof_init()             ((void)0)
+#define Prof_print(handle)      ((void)(handle))
+
+#endif /* Prof_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROF_H__ */
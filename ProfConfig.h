@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       ProfConfig.h
+ *
+ *  @brief      Profiling sites of this application, see Prof.h.
+ *
+ *  Every measured call site has an entry in ProfSite and a name at the same
+ *  position in ProfSite_NAMES.
+ *
+ *  Included by Prof.h only.
+ *
+ *  ============================================================================
+ */
+#ifndef __PROFCONFIG_H__
+#define __PROFCONFIG_H__
+
+/*!
+ *  @brief  Profiling sites
+ */
+typedef enum ProfSite {
+    ProfSite_NVS_READ = 0,  /*!< NVS_read() of mainThread */
+    ProfSite_NVS_WRITE,     /*!< NVS_write() of mainThread, with erase */
+    ProfSite_NVS_LOG,       /*!< NVS_write() of the sensor log */
+    ProfSite_DISPLAY,       /*!< Display_printf() to the UART */
+    ProfSite_UART_HWI,      /*!< UartDmaCC26XX interrupt */
+    ProfSite_UART_DRAIN,    /*!< UartDmaCC26XX deferred drain */
+
+    ProfSite_COUNT
+} ProfSite;
+
+/*! Names printed by Prof_print(), in ProfSite order */
+#define ProfSite_NAMES { \
+    "nvs_read",          \
+    "nvs_write",         \
+    "nvs_log",           \
+    "display",           \
+    "uart_hwi",          \
+    "uart_drain"         \
+}
+
+#endif /* __PROFCONFIG_H__ */
@@ -0,0 +1,598 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== RemoteCmd.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/drivers/NVS.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Cobs.h"
+#include "Crc16.h"
+#include "Energy.h"
+#include "FlashDump.h"
+#include "FlashPolicy.h"
+#include "RemoteCmd.h"
+#include "UartDmaCC26XX.h"
+
+/* Type, sequence number, command and status */
+#define RemoteCmd_HEADER_LEN    4
+
+/* Largest packet: response header, dump offset, data and CRC */
+#define RemoteCmd_MAX_PACKET    (RemoteCmd_HEADER_LEN + 4 + \
+                                 RemoteCmd_MAX_DATA + 2)
+
+/* Largest packet on the wire, with both delimiters */
+#define RemoteCmd_MAX_FRAME     (Cobs_MAX_ENCODED_LEN(RemoteCmd_MAX_PACKET) + 2)
+
+/* Responses that can be in flight at the same time */
+#define RemoteCmd_TX_BUFS       3
+
+typedef struct RemoteCmd_Object {
+    UartDmaCC26XX_Handle uart;
+    NVS_Handle           nvs[RemoteCmd_MAX_REGIONS];
+    NVS_Attrs            attrs[RemoteCmd_MAX_REGIONS];
+    uint_least8_t        regionCount;
+    Supervisor_Client   *client;
+    SemaphoreP_Struct    txFree;
+    uint_fast8_t         txNext;
+    size_t               splitLen;
+    bool                 splitDrop;
+    uint32_t             frames;
+    uint32_t             badFrames;
+    uint32_t             splitFrames;
+    uint8_t              split[Cobs_MAX_ENCODED_LEN(RemoteCmd_MAX_PACKET)];
+    uint8_t              packet[RemoteCmd_MAX_PACKET];
+    uint8_t              txBuf[RemoteCmd_TX_BUFS][RemoteCmd_MAX_FRAME];
+    FlashDump_Object     dump;
+} RemoteCmd_Object;
+
+static RemoteCmd_Object RemoteCmd_object;
+
+static void RemoteCmd_dump(uint8_t seq, uint32_t offset, uint32_t length);
+static void RemoteCmd_dumpz(uint8_t seq, uint8_t region, uint32_t offset,
+                            uint32_t length);
+static void RemoteCmd_erase(uint8_t seq, uint32_t offset);
+static void RemoteCmd_frame(uint8_t *buf, size_t len);
+static void RemoteCmd_grace(void);
+static bool RemoteCmd_inRegion(uint_fast8_t region, uint32_t offset,
+                               uint32_t length);
+static void RemoteCmd_read(uint8_t seq, uint32_t offset, uint32_t length);
+static void RemoteCmd_receive(uint8_t *data, size_t count);
+static void RemoteCmd_send(uint8_t seq, uint8_t cmd, uint8_t status,
+                           size_t len);
+static void RemoteCmd_stats(uint8_t seq);
+static void RemoteCmd_txDoneFxn(UartDmaCC26XX_Handle handle, void *arg);
+static void RemoteCmd_write(uint8_t seq, uint32_t offset, uint8_t flags,
+                            const uint8_t *data, size_t len);
+
+/*
+ *  ======== RemoteCmd_get16 ========
+ */
+static inline uint32_t RemoteCmd_get16(const uint8_t *src)
+{
+    return (src[0] | ((uint32_t)src[1] << 8));
+}
+
+/*
+ *  ======== RemoteCmd_get32 ========
+ */
+static inline uint32_t RemoteCmd_get32(const uint8_t *src)
+{
+    return (RemoteCmd_get16(src) | (RemoteCmd_get16(src + 2) << 16));
+}
+
+/*
+ *  ======== RemoteCmd_put32 ========
+ */
+static inline void RemoteCmd_put32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+/*
+ *  ======== RemoteCmd_run ========
+ */
+bool RemoteCmd_run(uint_least8_t uartIndex, const NVS_Handle *nvsHandles,
+                   uint_least8_t nvsCount, Supervisor_Client *client)
+{
+    RemoteCmd_Object  *object = &RemoteCmd_object;
+    SemaphoreP_Params  semParams;
+    const uint8_t     *data;
+    size_t             count;
+    uint32_t           timeout = SemaphoreP_WAIT_FOREVER;
+    uint_least8_t      i;
+
+    if (nvsCount == 0 || nvsCount > RemoteCmd_MAX_REGIONS) {
+        return (false);
+    }
+
+    object->uart = UartDmaCC26XX_getHandle(uartIndex);
+    if (object->uart == NULL) {
+        object->uart = UartDmaCC26XX_open(uartIndex, NULL);
+    }
+    if (object->uart == NULL || !UartDmaCC26XX_rxStart(object->uart)) {
+        return (false);
+    }
+
+    for (i = 0; i < nvsCount; i++) {
+        object->nvs[i] = nvsHandles[i];
+        NVS_getAttrs(nvsHandles[i], &object->attrs[i]);
+    }
+    object->regionCount = nvsCount;
+    object->client      = client;
+
+    if (client != NULL) {
+        /* Check in twice per deadline while the host is quiet */
+        timeout = client->deadline / 2;
+    }
+
+    SemaphoreP_Params_init(&semParams);
+    semParams.mode = SemaphoreP_Mode_COUNTING;
+    SemaphoreP_construct(&(object->txFree), RemoteCmd_TX_BUFS, &semParams);
+    object->txNext = 0;
+
+    /* Returns once reception has been stopped */
+    for (;;) {
+        if (client != NULL) {
+            Supervisor_checkIn(client);
+        }
+
+        count = UartDmaCC26XX_rxAcquire(object->uart, &data, timeout);
+        if (count == 0) {
+            if (!UartDmaCC26XX_rxIsRunning(object->uart)) {
+                break;
+            }
+            continue;
+        }
+
+        /* The bytes stay ours until released, decode them where they are */
+        RemoteCmd_receive((uint8_t *)data, count);
+        UartDmaCC26XX_rxRelease(object->uart, count);
+    }
+
+    /* Queued responses post txFree when they are sent, wait for all */
+    for (i = 0; i < RemoteCmd_TX_BUFS; i++) {
+        SemaphoreP_pend(&(object->txFree), SemaphoreP_WAIT_FOREVER);
+    }
+    SemaphoreP_destruct(&(object->txFree));
+
+    return (true);
+}
+
+/*
+ *  ======== RemoteCmd_receive ========
+ *  Split received bytes into frames. A frame that is complete within
+ *  @p data is handled in place; one that starts or ends outside of it is
+ *  collected in the split buffer first.
+ */
+static void RemoteCmd_receive(uint8_t *data, size_t count)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    uint8_t          *end;
+    size_t            len;
+
+    while (count > 0) {
+        end = memchr(data, Cobs_DELIMITER, count);
+        len = (end != NULL) ? (size_t)(end - data) : count;
+
+        if (object->splitLen == 0 && !object->splitDrop && end != NULL) {
+            if (len > 0) {
+                RemoteCmd_frame(data, len);
+            }
+        }
+        else {
+            if (object->splitLen + len > sizeof(object->split)) {
+                /* Too long for a request, skip to the next delimiter */
+                object->splitDrop = true;
+            }
+            else {
+                memcpy(&object->split[object->splitLen], data, len);
+                object->splitLen += len;
+            }
+
+            if (end != NULL) {
+                if (object->splitDrop) {
+                    object->badFrames++;
+                }
+                else if (object->splitLen > 0) {
+                    object->splitFrames++;
+                    RemoteCmd_frame(object->split, object->splitLen);
+                }
+                object->splitLen  = 0;
+                object->splitDrop = false;
+            }
+        }
+
+        if (end != NULL) {
+            len++;
+        }
+        data  += len;
+        count -= len;
+    }
+}
+
+/*
+ *  ======== RemoteCmd_frame ========
+ *  Check and dispatch one COBS encoded packet.
+ */
+static void RemoteCmd_frame(uint8_t *buf, size_t len)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    const uint8_t    *args;
+    size_t            argLen;
+    uint8_t           seq;
+    uint8_t           cmd;
+
+    len = Cobs_decode(buf, len);
+    if (len < 3 + 2 || buf[0] != RemoteCmd_REQUEST) {
+        object->badFrames++;
+        return;
+    }
+
+    len -= 2;
+    if (Crc16_update(Crc16_INIT, buf, len) != RemoteCmd_get16(&buf[len])) {
+        object->badFrames++;
+        return;
+    }
+
+    object->frames++;
+
+    seq    = buf[1];
+    cmd    = buf[2];
+    args   = &buf[3];
+    argLen = len - 3;
+
+    switch (cmd) {
+        case RemoteCmd_CMD_READ:
+            if (argLen == 6) {
+                RemoteCmd_read(seq, RemoteCmd_get32(args),
+                               RemoteCmd_get16(args + 4));
+                return;
+            }
+            break;
+
+        case RemoteCmd_CMD_WRITE:
+            if (argLen >= 5) {
+                RemoteCmd_write(seq, RemoteCmd_get32(args), args[4],
+                                args + 5, argLen - 5);
+                return;
+            }
+            break;
+
+        case RemoteCmd_CMD_ERASE:
+            if (argLen == 4) {
+                RemoteCmd_erase(seq, RemoteCmd_get32(args));
+                return;
+            }
+            break;
+
+        case RemoteCmd_CMD_STATS:
+            RemoteCmd_stats(seq);
+            return;
+
+        case RemoteCmd_CMD_DUMP:
+            if (argLen == 8) {
+                Energy_begin(EnergyOp_UART_DUMP);
+                RemoteCmd_dump(seq, RemoteCmd_get32(args),
+                               RemoteCmd_get32(args + 4));
+                Energy_end(EnergyOp_UART_DUMP);
+                return;
+            }
+            break;
+
+        case RemoteCmd_CMD_DUMPZ:
+            if (argLen == 9) {
+                /* Region 1 is on the SPI flash */
+                FlashPolicy_begin();
+                Energy_begin(EnergyOp_UART_DUMP);
+                RemoteCmd_dumpz(seq, args[0], RemoteCmd_get32(args + 1),
+                                RemoteCmd_get32(args + 5));
+                Energy_end(EnergyOp_UART_DUMP);
+                FlashPolicy_end();
+                return;
+            }
+            break;
+
+        default:
+            RemoteCmd_send(seq, cmd, RemoteCmd_STATUS_BAD_CMD, 0);
+            return;
+    }
+
+    RemoteCmd_send(seq, cmd, RemoteCmd_STATUS_BAD_ARG, 0);
+}
+
+/*
+ *  ======== RemoteCmd_grace ========
+ *  Cover a flash write or erase, which may stall longer than the deadline.
+ */
+static void RemoteCmd_grace(void)
+{
+    if (RemoteCmd_object.client != NULL) {
+        Supervisor_grace(RemoteCmd_object.client, RemoteCmd_ERASE_GRACE_MS);
+    }
+}
+
+/*
+ *  ======== RemoteCmd_inRegion ========
+ */
+static bool RemoteCmd_inRegion(uint_fast8_t region, uint32_t offset,
+                               uint32_t length)
+{
+    size_t size;
+
+    if (region >= RemoteCmd_object.regionCount) {
+        return (false);
+    }
+    size = RemoteCmd_object.attrs[region].regionSize;
+
+    return (offset <= size && length <= size - offset);
+}
+
+/*
+ *  ======== RemoteCmd_read ========
+ */
+static void RemoteCmd_read(uint8_t seq, uint32_t offset, uint32_t length)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    uint8_t          *results = &object->packet[RemoteCmd_HEADER_LEN];
+
+    if (length > RemoteCmd_MAX_DATA || !RemoteCmd_inRegion(0, offset, length)) {
+        RemoteCmd_send(seq, RemoteCmd_CMD_READ, RemoteCmd_STATUS_BAD_ARG, 0);
+        return;
+    }
+
+    if (NVS_read(object->nvs[0], offset, results, length) !=
+        NVS_STATUS_SUCCESS) {
+        RemoteCmd_send(seq, RemoteCmd_CMD_READ, RemoteCmd_STATUS_NVS_ERROR, 0);
+        return;
+    }
+
+    RemoteCmd_send(seq, RemoteCmd_CMD_READ, RemoteCmd_STATUS_OK, length);
+}
+
+/*
+ *  ======== RemoteCmd_write ========
+ */
+static void RemoteCmd_write(uint8_t seq, uint32_t offset, uint8_t flags,
+                            const uint8_t *data, size_t len)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    uint_fast16_t     nvsFlags = NVS_WRITE_POST_VERIFY;
+    int_fast16_t      status;
+
+    if (len > RemoteCmd_MAX_DATA || !RemoteCmd_inRegion(0, offset, len)) {
+        RemoteCmd_send(seq, RemoteCmd_CMD_WRITE, RemoteCmd_STATUS_BAD_ARG, 0);
+        return;
+    }
+
+    if (flags & RemoteCmd_WRITE_ERASE) {
+        nvsFlags |= NVS_WRITE_ERASE;
+
+        /* The CPU stalls for the erase, stop the sender first */
+        UartDmaCC26XX_rxHold(object->uart, true);
+    }
+    RemoteCmd_grace();
+
+    /* Straight from the receive buffer */
+    status = NVS_write(object->nvs[0], offset, (void *)data, len, nvsFlags);
+
+    UartDmaCC26XX_rxHold(object->uart, false);
+
+    RemoteCmd_send(seq, RemoteCmd_CMD_WRITE, (status == NVS_STATUS_SUCCESS) ?
+                   RemoteCmd_STATUS_OK : RemoteCmd_STATUS_NVS_ERROR, 0);
+}
+
+/*
+ *  ======== RemoteCmd_erase ========
+ */
+static void RemoteCmd_erase(uint8_t seq, uint32_t offset)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    size_t            sectorSize = object->attrs[0].sectorSize;
+    int_fast16_t      status;
+
+    if (offset >= object->attrs[0].regionSize) {
+        RemoteCmd_send(seq, RemoteCmd_CMD_ERASE, RemoteCmd_STATUS_BAD_ARG, 0);
+        return;
+    }
+
+    UartDmaCC26XX_rxHold(object->uart, true);
+    RemoteCmd_grace();
+    status = NVS_erase(object->nvs[0], offset & ~(sectorSize - 1), sectorSize);
+    UartDmaCC26XX_rxHold(object->uart, false);
+
+    RemoteCmd_send(seq, RemoteCmd_CMD_ERASE, (status == NVS_STATUS_SUCCESS) ?
+                   RemoteCmd_STATUS_OK : RemoteCmd_STATUS_NVS_ERROR, 0);
+}
+
+/*
+ *  ======== RemoteCmd_stats ========
+ */
+static void RemoteCmd_stats(uint8_t seq)
+{
+    RemoteCmd_Object    *object = &RemoteCmd_object;
+    uint8_t             *results = &object->packet[RemoteCmd_HEADER_LEN];
+    UartDmaCC26XX_Stats  uartStats;
+    uint32_t             values[RemoteCmd_STAT_COUNT];
+    uint_fast8_t         i;
+
+    UartDmaCC26XX_getStats(object->uart, &uartStats);
+
+    values[RemoteCmd_STAT_FRAMES]        = object->frames;
+    values[RemoteCmd_STAT_BAD_FRAMES]    = object->badFrames;
+    values[RemoteCmd_STAT_SPLIT_FRAMES]  = object->splitFrames;
+    values[RemoteCmd_STAT_RX_BYTES]      = uartStats.rxBytes;
+    values[RemoteCmd_STAT_RX_INTERRUPTS] = uartStats.rxInterrupts;
+    values[RemoteCmd_STAT_RX_OVERRUNS]   = uartStats.rxOverruns;
+    values[RemoteCmd_STAT_RX_THROTTLED]  = uartStats.rxThrottled;
+    values[RemoteCmd_STAT_TX_BYTES]      = uartStats.txBytes;
+    values[RemoteCmd_STAT_TX_DROPPED]    = uartStats.txDropped;
+
+    results[0] = RemoteCmd_STAT_COUNT;
+    for (i = 0; i < RemoteCmd_STAT_COUNT; i++) {
+        RemoteCmd_put32(&results[1 + 4 * i], values[i]);
+    }
+
+    RemoteCmd_send(seq, RemoteCmd_CMD_STATS, RemoteCmd_STATUS_OK,
+                   1 + 4 * RemoteCmd_STAT_COUNT);
+}
+
+/*
+ *  ======== RemoteCmd_dump ========
+ *  Stream a range as one response per chunk. Each chunk is queued as soon
+ *  as it is read, the next one is read while it is being sent.
+ */
+static void RemoteCmd_dump(uint8_t seq, uint32_t offset, uint32_t length)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    uint8_t          *results = &object->packet[RemoteCmd_HEADER_LEN];
+    uint32_t          chunk;
+
+    if (!RemoteCmd_inRegion(0, offset, length)) {
+        RemoteCmd_send(seq, RemoteCmd_CMD_DUMP, RemoteCmd_STATUS_BAD_ARG, 0);
+        return;
+    }
+
+    while (length > 0) {
+        chunk = (length < RemoteCmd_MAX_DATA) ? length : RemoteCmd_MAX_DATA;
+
+        RemoteCmd_put32(results, offset);
+        if (NVS_read(object->nvs[0], offset, results + 4, chunk) !=
+            NVS_STATUS_SUCCESS) {
+            RemoteCmd_send(seq, RemoteCmd_CMD_DUMP,
+                           RemoteCmd_STATUS_NVS_ERROR, 0);
+            return;
+        }
+        RemoteCmd_send(seq, RemoteCmd_CMD_DUMP, RemoteCmd_STATUS_MORE,
+                       4 + chunk);
+
+        offset += chunk;
+        length -= chunk;
+    }
+
+    RemoteCmd_send(seq, RemoteCmd_CMD_DUMP, RemoteCmd_STATUS_OK, 0);
+}
+
+/*
+ *  ======== RemoteCmd_dumpz ========
+ *  Like RemoteCmd_dump(), but every chunk is a FlashDump block. Reading and
+ *  compressing the next block overlaps with sending the previous ones from
+ *  the transmit buffers.
+ */
+static void RemoteCmd_dumpz(uint8_t seq, uint8_t region, uint32_t offset,
+                            uint32_t length)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    uint8_t          *results = &object->packet[RemoteCmd_HEADER_LEN];
+    uint32_t          blockOffset;
+    size_t            len;
+    uint16_t          crc;
+
+    if (length == 0 && region < object->regionCount &&
+        offset <= object->attrs[region].regionSize) {
+        length = object->attrs[region].regionSize - offset;
+    }
+    if (!RemoteCmd_inRegion(region, offset, length)) {
+        RemoteCmd_send(seq, RemoteCmd_CMD_DUMPZ, RemoteCmd_STATUS_BAD_ARG, 0);
+        return;
+    }
+
+    FlashDump_init(&object->dump, object->nvs[region], offset, length);
+
+    for (;;) {
+        if (FlashDump_next(&object->dump, results + 4, RemoteCmd_MAX_DATA,
+                           &blockOffset, &len) != NVS_STATUS_SUCCESS) {
+            RemoteCmd_send(seq, RemoteCmd_CMD_DUMPZ,
+                           RemoteCmd_STATUS_NVS_ERROR, 0);
+            return;
+        }
+        if (len == 0) {
+            break;
+        }
+
+        RemoteCmd_put32(results, blockOffset);
+        RemoteCmd_send(seq, RemoteCmd_CMD_DUMPZ, RemoteCmd_STATUS_MORE,
+                       4 + len);
+    }
+
+    crc = FlashDump_getCrc(&object->dump);
+    RemoteCmd_put32(results, length);
+    results[4] = (uint8_t)crc;
+    results[5] = (uint8_t)(crc >> 8);
+
+    RemoteCmd_send(seq, RemoteCmd_CMD_DUMPZ, RemoteCmd_STATUS_OK, 6);
+}
+
+/*
+ *  ======== RemoteCmd_send ========
+ *  Complete the response in the packet buffer, whose results field holds
+ *  @p len bytes, and queue it for transmission.
+ */
+static void RemoteCmd_send(uint8_t seq, uint8_t cmd, uint8_t status,
+                           size_t len)
+{
+    RemoteCmd_Object *object = &RemoteCmd_object;
+    uint8_t          *packet = object->packet;
+    uint8_t          *frame;
+    uint16_t          crc;
+    size_t            frameLen;
+
+    packet[0] = RemoteCmd_RESPONSE;
+    packet[1] = seq;
+    packet[2] = cmd;
+    packet[3] = status;
+    len += RemoteCmd_HEADER_LEN;
+
+    crc = Crc16_update(Crc16_INIT, packet, len);
+    packet[len++] = (uint8_t)crc;
+    packet[len++] = (uint8_t)(crc >> 8);
+
+    /* Transmit buffers complete in the order they were queued */
+    SemaphoreP_pend(&(object->txFree), SemaphoreP_WAIT_FOREVER);
+    frame = object->txBuf[object->txNext];
+
+    frame[0] = Cobs_DELIMITER;
+    frameLen = Cobs_encode(packet, len, &frame[1]) + 1;
+    frame[frameLen++] = Cobs_DELIMITER;
+
+    /*
+     * The UART queue is shared with Display and Log output. Waiting for a
+     * slot is not a drop, so it is not counted in txDropped.
+     */
+    while (!UartDmaCC26XX_trySubmit(object->uart, frame, frameLen,
+                                    RemoteCmd_txDoneFxn, NULL)) {
+        ClockP_usleep(1000);
+    }
+
+    object->txNext = (object->txNext + 1) % RemoteCmd_TX_BUFS;
+
+    /* Long dumps are a stream of responses, each one shows progress */
+    if (object->client != NULL) {
+        Supervisor_checkIn(object->client);
+    }
+}
+
+/*
+ *  ======== RemoteCmd_txDoneFxn ========
+ */
+static void RemoteCmd_txDoneFxn(UartDmaCC26XX_Handle handle, void *arg)
+{
+    SemaphoreP_post(&(RemoteCmd_object.txFree));
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       RemoteCmd.h
+ *
+ *  @brief      Binary command protocol for remote access to NVS.
+ *
+ *  Lets a host read, write, erase and dump NVS regions over UART0 without
+ *  changing the application, see tools/remotecmd.py and tools/flashdump.py.
+ *
+ *  # Packet format #
+ *  Requests and responses are COBS packets (see Cobs.h) ending in a
+ *  CRC-16/CCITT-FALSE of the preceding bytes (see Crc16.h):
+ *
+ *  | Offset | Size | Request               | Response              |
+ *  |--------|------|-----------------------|-----------------------|
+ *  | 0      | 1    | RemoteCmd_REQUEST     | RemoteCmd_RESPONSE    |
+ *  | 1      | 1    | Sequence number       | Sequence of request   |
+ *  | 2      | 1    | Command               | Command of request    |
+ *  | 3      | 1    | Arguments...          | Status                |
+ *  | 4      | n    |                       | Results...            |
+ *  | end    | 2    | CRC, little endian    | CRC, little endian    |
+ *
+ *  Multi-byte fields are little endian. Offsets are relative to the start
+ *  of an NVS region. All commands but RemoteCmd_CMD_DUMPZ work on the first
+ *  region passed to RemoteCmd_run().
+ *
+ *  | Command              | Arguments                  | Results          |
+ *  |----------------------|----------------------------|------------------|
+ *  | RemoteCmd_CMD_READ   | offset:4, length:2         | data             |
+ *  | RemoteCmd_CMD_WRITE  | offset:4, flags:1, data    | -                |
+ *  | RemoteCmd_CMD_ERASE  | offset:4                   | -                |
+ *  | RemoteCmd_CMD_STATS  | -                          | count:1, u32...  |
+ *  | RemoteCmd_CMD_DUMP   | offset:4, length:4         | offset:4, data   |
+ *  | RemoteCmd_CMD_DUMPZ  | region:1, offset:4,        | offset:4, block  |
+ *  |                      | length:4                   |                  |
+ *
+ *  RemoteCmd_CMD_WRITE stores the value of a key, that is a record at a
+ *  fixed offset such as the variables of mainThread. Flag
+ *  RemoteCmd_WRITE_ERASE erases the sector first; every write is verified.
+ *  RemoteCmd_CMD_ERASE erases the sector holding the offset.
+ *  RemoteCmd_CMD_DUMP answers with a stream of RemoteCmd_STATUS_MORE
+ *  responses, one per chunk, followed by one with RemoteCmd_STATUS_OK.
+ *  RemoteCmd_CMD_DUMPZ does the same with FlashDump blocks (see
+ *  FlashDump.h) and ends with length:4 and the CRC-16 of the data:2. A
+ *  length of 0 dumps the rest of the region.
+ *
+ *  Packets with a bad CRC or framing are counted and dropped without a
+ *  response.
+ *
+ *  # Pipelining #
+ *  Requests are handled in order as they arrive and every response is
+ *  queued on the uDMA transmit path without waiting for the previous one,
+ *  so a host may keep several requests outstanding and match responses by
+ *  sequence number. Responses are built in a small pool of transmit
+ *  buffers; the command loop only waits when all of them are in flight.
+ *
+ *  Frames that arrive complete are decoded and handled in place in the
+ *  UART receive buffer. Only a frame that was split across two reads is
+ *  first collected in a frame sized buffer. No memory is allocated.
+ *
+ *  Log records and Display text share the UART; the host ignores them.
+ *
+ *  # Supervision #
+ *  The command loop can stay under the watch of a Supervisor client (see
+ *  Supervisor.h). It then wakes at least twice per deadline to check in
+ *  while the host is idle, checks in after every response, and declares a
+ *  grace window of RemoteCmd_ERASE_GRACE_MS before erasing or writing.
+ *
+ *  ============================================================================
+ */
+#ifndef __REMOTECMD_H__
+#define __REMOTECMD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/drivers/NVS.h>
+
+#include "Supervisor.h"
+
+/*! First byte of a request packet ('C') */
+#define RemoteCmd_REQUEST           0x43
+
+/*! First byte of a response packet ('R') */
+#define RemoteCmd_RESPONSE          0x52
+
+/*! Largest data field of a request or response */
+#define RemoteCmd_MAX_DATA          256
+
+/*!
+ *  @name Commands
+ *  @{
+ */
+#define RemoteCmd_CMD_READ          0x01
+#define RemoteCmd_CMD_WRITE         0x02
+#define RemoteCmd_CMD_ERASE         0x03
+#define RemoteCmd_CMD_STATS         0x04
+#define RemoteCmd_CMD_DUMP          0x05
+#define RemoteCmd_CMD_DUMPZ         0x06
+/*! @} */
+
+/*! Largest number of NVS regions served */
+#define RemoteCmd_MAX_REGIONS       2
+
+/*! Grace window for a write or an erase, in ms, see Supervisor_grace() */
+#ifndef RemoteCmd_ERASE_GRACE_MS
+#define RemoteCmd_ERASE_GRACE_MS    200
+#endif
+
+/*! RemoteCmd_CMD_WRITE flag: erase the sector before writing */
+#define RemoteCmd_WRITE_ERASE       0x01
+
+/*!
+ *  @name Status codes
+ *  @{
+ */
+#define RemoteCmd_STATUS_OK         0x00
+#define RemoteCmd_STATUS_MORE       0x01    /*!< More dump chunks follow */
+#define RemoteCmd_STATUS_BAD_CMD    0x80    /*!< Unknown command */
+#define RemoteCmd_STATUS_BAD_ARG    0x81    /*!< Bad length or range */
+#define RemoteCmd_STATUS_NVS_ERROR  0x82    /*!< NVS driver call failed */
+/*! @} */
+
+/*!
+ *  @brief  Counters returned by RemoteCmd_CMD_STATS, in this order
+ */
+typedef enum RemoteCmd_StatId {
+    RemoteCmd_STAT_FRAMES = 0,      /*!< Requests handled */
+    RemoteCmd_STAT_BAD_FRAMES,      /*!< Packets dropped for framing/CRC */
+    RemoteCmd_STAT_SPLIT_FRAMES,    /*!< Frames not handled in place */
+    RemoteCmd_STAT_RX_BYTES,        /*!< UartDmaCC26XX_Stats.rxBytes */
+    RemoteCmd_STAT_RX_INTERRUPTS,   /*!< UartDmaCC26XX_Stats.rxInterrupts */
+    RemoteCmd_STAT_RX_OVERRUNS,     /*!< UartDmaCC26XX_Stats.rxOverruns */
+    RemoteCmd_STAT_RX_THROTTLED,    /*!< UartDmaCC26XX_Stats.rxThrottled */
+    RemoteCmd_STAT_TX_BYTES,        /*!< UartDmaCC26XX_Stats.txBytes */
+    RemoteCmd_STAT_TX_DROPPED,      /*!< UartDmaCC26XX_Stats.txDropped */
+    RemoteCmd_STAT_COUNT
+} RemoteCmd_StatId;
+
+/*!
+ *  @brief  Serve remote commands on a UART
+ *
+ *  Opens the UartDmaCC26XX instance unless it is already open, starts
+ *  reception and handles requests until reception stops.
+ *
+ *  @param  uartIndex   UartDmaCC26XX instance, e.g. Board_UART0
+ *  @param  nvsHandles  Open NVS regions, numbered from 0 in this order
+ *  @param  nvsCount    Number of regions, at most RemoteCmd_MAX_REGIONS
+ *  @param  client      Registered client of the calling thread, or NULL
+ *                      to serve without supervision
+ *
+ *  @return false if the UART could not be opened or has no receive buffer.
+ */
+extern bool RemoteCmd_run(uint_least8_t uartIndex,
+                          const NVS_Handle *nvsHandles,
+                          uint_least8_t nvsCount,
+                          Supervisor_Client *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REMOTECMD_H__ */
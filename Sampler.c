@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Sampler.c ========
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/devices/cc13x0/inc/hw_gpt.h>
+#include <ti/devices/cc13x0/inc/hw_types.h>
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/timer/GPTimerCC26XX.h>
+#include <ti/sysbios/family/arm/m3/Hwi.h>
+
+#include "Sampler.h"
+
+#if (Sampler_ENABLE)
+
+/* Sampled flash, the whole CC1310F128 */
+#define FLASH_SIZE      0x20000
+
+/* Fibonacci hashing of the granule */
+#define HASH_MULT       2654435761U
+
+Sampler_Slot      Sampler_table[Sampler_SLOTS];
+volatile uint32_t Sampler_samples;
+volatile uint32_t Sampler_outside;
+volatile uint32_t Sampler_lost;
+
+static GPTimerCC26XX_Handle Sampler_timer;
+static uint32_t             Sampler_base;
+static unsigned int         Sampler_intNum;
+static unsigned int         Sampler_hashShift;
+
+/* Entry stub, reached straight from the vector table */
+void Sampler_isr(void);
+
+/* Called by Sampler_isr() with the interrupted exception frame */
+void Sampler_record(const uint32_t *frame);
+
+/*
+ *  ======== Sampler_start ========
+ */
+bool Sampler_start(uint32_t rateHz)
+{
+    GPTimerCC26XX_Params          params;
+    GPTimerCC26XX_HWAttrs const  *hwAttrs;
+    ClockP_FreqHz                 freq;
+    unsigned int                  bits;
+
+    if (rateHz == 0) {
+        return (false);
+    }
+
+    if (Sampler_timer == NULL) {
+        GPTimerCC26XX_Params_init(&params);
+        params.width          = GPT_CONFIG_32BIT;
+        params.mode           = GPT_MODE_PERIODIC_UP;
+        params.debugStallMode = GPTimerCC26XX_DEBUG_STALL_ON;
+        Sampler_timer = GPTimerCC26XX_open(Sampler_TIMER, &params);
+        if (Sampler_timer == NULL) {
+            return (false);
+        }
+
+        hwAttrs = Sampler_timer->hwAttrs;
+        Sampler_base   = hwAttrs->baseAddr;
+        Sampler_intNum = hwAttrs->intNum;
+
+        for (bits = 0; (1U << bits) < Sampler_SLOTS; bits++) {
+        }
+        Sampler_hashShift = 32 - bits;
+
+        /* Not through the driver, whose Hwi would be dispatched */
+        Hwi_plug(Sampler_intNum, (Void *)Sampler_isr);
+        Hwi_setPriority(Sampler_intNum, 0);
+        GPTimerCC26XX_enableInterrupt(Sampler_timer, GPT_INT_TIMEOUT);
+    }
+    else {
+        GPTimerCC26XX_stop(Sampler_timer);
+    }
+
+    ClockP_getCpuFreq(&freq);
+    GPTimerCC26XX_setLoadValue(Sampler_timer, freq.lo / rateHz - 1);
+
+    Hwi_enableInterrupt(Sampler_intNum);
+    GPTimerCC26XX_start(Sampler_timer);
+
+    return (true);
+}
+
+/*
+ *  ======== Sampler_stop ========
+ */
+void Sampler_stop(void)
+{
+    if (Sampler_timer != NULL) {
+        GPTimerCC26XX_stop(Sampler_timer);
+        Hwi_disableInterrupt(Sampler_intNum);
+    }
+}
+
+/*
+ *  ======== Sampler_reset ========
+ */
+void Sampler_reset(void)
+{
+    unsigned int key = 0;
+
+    /* Hwi_disable() does not mask the sampler */
+    if (Sampler_timer != NULL) {
+        key = Hwi_disableInterrupt(Sampler_intNum);
+    }
+
+    memset(Sampler_table, 0, sizeof(Sampler_table));
+    Sampler_samples = 0;
+    Sampler_outside = 0;
+    Sampler_lost    = 0;
+
+    if (Sampler_timer != NULL) {
+        Hwi_restoreInterrupt(Sampler_intNum, key);
+    }
+}
+
+/*
+ *  ======== Sampler_print ========
+ */
+void Sampler_print(Display_Handle handle)
+{
+    Sampler_Slot slot;
+    unsigned int i;
+
+    if (Sampler_samples == 0) {
+        return;
+    }
+
+    Display_printf(handle, 0, 0, "pc begin %u samples %u outside %u lost",
+            Sampler_samples, Sampler_outside, Sampler_lost);
+
+    for (i = 0; i < Sampler_SLOTS; i++) {
+        slot = Sampler_table[i];
+        if (slot.key != 0) {
+            Display_printf(handle, 0, 0, "pc 0x%08x %u",
+                    (uint32_t)slot.key << Sampler_SHIFT, slot.count);
+        }
+    }
+
+    Display_printf(handle, 0, 0, "pc end");
+}
+
+/*
+ *  ======== Sampler_isr ========
+ *  Passes the exception frame of the interrupted code, on the stack that
+ *  EXC_RETURN in lr names, to Sampler_record().
+ */
+#if defined(__TI_COMPILER_VERSION__)
+__asm("    .sect \".text:Sampler_isr\"");
+__asm("    .thumb");
+__asm("    .global Sampler_isr");
+__asm("    .global Sampler_record");
+__asm("Sampler_isr: .asmfunc");
+__asm("    tst     lr, #4");
+__asm("    ite     eq");
+__asm("    mrseq   r0, msp");
+__asm("    mrsne   r0, psp");
+__asm("    b       Sampler_record");
+__asm("    .endasmfunc");
+#elif defined(__IAR_SYSTEMS_ICC__)
+__stackless void Sampler_isr(void)
+{
+    __asm volatile ("tst     lr, #4\n"
+                    "ite     eq\n"
+                    "mrseq   r0, msp\n"
+                    "mrsne   r0, psp\n"
+                    "b       Sampler_record");
+}
+#elif defined(__GNUC__)
+__attribute__((naked)) void Sampler_isr(void)
+{
+    __asm volatile ("tst     lr, #4\n\t"
+                    "ite     eq\n\t"
+                    "mrseq   r0, msp\n\t"
+                    "mrsne   r0, psp\n\t"
+                    "b       Sampler_record");
+}
+#endif
+
+/*
+ *  ======== Sampler_record ========
+ *  Counts the return address of @p frame, the seventh word.
+ */
+void Sampler_record(const uint32_t *frame)
+{
+    Sampler_Slot *slot;
+    uint32_t      pc = frame[6];
+    uint32_t      key;
+    uint32_t      i;
+    uint32_t      probe;
+
+    HWREG(Sampler_base + GPT_O_ICLR) = GPT_ICLR_TATOCINT;
+
+    Sampler_samples++;
+
+    if (pc >= FLASH_SIZE) {
+        Sampler_outside++;
+    }
+    else {
+        /* Never 0, the vector table is not executed */
+        key = pc >> Sampler_SHIFT;
+        i = (key * HASH_MULT) >> Sampler_hashShift;
+
+        for (probe = 0; probe < Sampler_PROBES; probe++) {
+            slot = &Sampler_table[i];
+            if (slot->key == key) {
+                if (slot->count != UINT16_MAX) {
+                    slot->count++;
+                }
+                break;
+            }
+            if (slot->key == 0) {
+                slot->key   = key;
+                slot->count = 1;
+                break;
+            }
+            i = (i + 1) & (Sampler_SLOTS - 1);
+        }
+        if (probe == Sampler_PROBES) {
+            Sampler_lost++;
+        }
+    }
+
+    /* The clear must reach the timer before the exception returns */
+    (void)HWREG(Sampler_base + GPT_O_ICLR);
+}
+
+#endif /* Sampler_ENABLE */
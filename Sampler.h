@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Sampler.h
+ *
+ *  @brief      Statistical profiler sampling the program counter.
+ *
+ *  A periodic interrupt of Sampler_TIMER, a whole 32-bit GPTimer, reads the
+ *  return address from the exception frame of the code it interrupted and
+ *  counts it in a small hash table. Nothing is instrumented: after a run,
+ *  the addresses with the most samples are where the CPU spent its time,
+ *  and tools/pcsample.py maps them to functions of the ELF file.
+ *
+ *  The timer interrupt is plugged straight into the vector table at
+ *  priority 0, above Hwi_disablePriority, so it is not dispatched by the
+ *  kernel and also samples kernel code, Hwis and critical sections. This
+ *  needs the vector table in RAM (m3Hwi.vectorTableAddress = 0x20000000,
+ *  the default of the tirtos_builds project) and leaves the timer's vector
+ *  plugged after Sampler_stop(). The sampler must not call the kernel.
+ *
+ *  Addresses are counted in granules of 2^Sampler_SHIFT bytes of flash;
+ *  samples outside flash, in the ROM drivers or RAM, are counted as
+ *  outside, and samples of new granules once the table is full as lost.
+ *  Counts saturate at 65535. The table, 4 bytes per slot, stays in
+ *  Sampler_table for the debugger's expression view or ROV.
+ *
+ *  A sample costs the exception entry and exit and a table lookup. Counted
+ *  from the instructions, not yet measured on a board, that is about 70
+ *  cycles, or 0.15% of the CPU at 1 kHz and 1.5% at 10 kHz; the
+ *  SAMPLER_BENCHMARK of benchmarks/Bench.h measures it. The GPTimer driver
+ *  keeps the device out of standby while the timer runs.
+ *
+ *  The sampler is off unless the build defines Sampler_ENABLE to 1.
+ *  Otherwise Sampler.c compiles to nothing, Sampler_table takes no RAM and
+ *  Sampler_start() returns false.
+ *
+ *  @code
+ *  Sampler_start(1000);
+ *  runWorkload();
+ *  Sampler_stop();
+ *  Sampler_print(displayHandle);
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __SAMPLER_H__
+#define __SAMPLER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+
+#include "Board.h"
+
+#ifndef Sampler_ENABLE
+#define Sampler_ENABLE      0
+#endif
+
+#if (Sampler_ENABLE)
+
+/*! GPTimer used for sampling, the B half must be free as well */
+#ifndef Sampler_TIMER
+#define Sampler_TIMER       Board_GPTIMER3A
+#endif
+
+/*! Number of table slots, a power of two */
+#ifndef Sampler_SLOTS
+#define Sampler_SLOTS       256
+#endif
+
+/*! log2 of the granule size in bytes, 1 counts every instruction */
+#ifndef Sampler_SHIFT
+#define Sampler_SHIFT       2
+#endif
+
+/*! Slots tried before a sample is lost */
+#define Sampler_PROBES      8
+
+/*!
+ *  @brief  Samples of one granule
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct Sampler_Slot {
+    uint16_t key;       /*!< Address >> Sampler_SHIFT, 0 if free */
+    uint16_t count;     /*!< Samples, saturating */
+} Sampler_Slot;
+
+/*! Histogram of the sampled addresses */
+extern Sampler_Slot Sampler_table[Sampler_SLOTS];
+
+/*! All samples, including those outside flash and those lost */
+extern volatile uint32_t Sampler_samples;
+
+/*! Samples outside flash */
+extern volatile uint32_t Sampler_outside;
+
+/*! Samples of new granules that found no free slot */
+extern volatile uint32_t Sampler_lost;
+
+/*!
+ *  @brief  Sample @p rateHz times a second
+ *
+ *  Opens the timer on the first call, which can precede BIOS_start().
+ *  Calling it again changes the rate. The table is not cleared.
+ *
+ *  @return false if @p rateHz is 0 or the timer is not available.
+ */
+extern bool Sampler_start(uint32_t rateHz);
+
+/*!
+ *  @brief  Stop sampling
+ *
+ *  Does nothing if the sampler was never started.
+ */
+extern void Sampler_stop(void);
+
+/*!
+ *  @brief  Forget all samples
+ */
+extern void Sampler_reset(void);
+
+/*!
+ *  @brief  Print the table for tools/pcsample.py
+ *
+ *  Prints a "pc begin" line with the totals, one "pc <address> <count>"
+ *  line per used slot and a "pc end" line. Stop the sampler first for an
+ *  exact snapshot. Prints nothing if there are no samples.
+ *
+ *  Must be called from Task context.
+ */
+extern void Sampler_print(Display_Handle handle);
+
+#else /* Sampler_ENABLE */
+
+#define Sampler_start(rateHz)   ((void)(rateHz), false)
+#define Sampler_stop()          ((void)0)
+#define Sampler_reset()         ((void)0)
+#define Sampler_print(handle)   ((void)(handle))
+
+#endif /* Sampler_ENABLE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SAMPLER_H__ */
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       SpscRing.h
+ *
+ *  @brief      Lock-free ring for one producer and one consumer.
+ *
+ *  Meant for handing data from an interrupt to a task: the producer only
+ *  writes @p head and the consumer only writes @p tail, so neither side
+ *  takes a lock or disables interrupts. Either side may be a Hwi, Swi or
+ *  Task, as long as each has exactly one.
+ *
+ *  Positions are free running 32-bit counts and the capacity is a power of
+ *  two, so head - tail is the fill level even across wrap-around and the
+ *  slot of a position is a mask away.
+ *
+ *  # Ordering #
+ *  The Cortex-M3 does not reorder normal memory accesses as seen by its own
+ *  interrupts, but the compiler may, and a DMA or debugger reading the ring
+ *  sees the bus order. A data memory barrier (Atomic_dmb(), which is also a
+ *  compiler barrier) therefore separates:
+ *  - the producer's element writes from its store of @p head, and
+ *  - the consumer's load of @p head from its element reads, and its
+ *    element reads from its store of @p tail.
+ *
+ *  The batch functions copy as many elements as fit with one barrier pair,
+ *  which is what makes draining a burst of interrupts cheap.
+ *
+ *  @code
+ *  #include "SpscRing.h"
+ *
+ *  static Event eventBuf[16];
+ *  static SpscRing_Struct events;
+ *
+ *  SpscRing_construct(&events, eventBuf, sizeof(Event), 16);
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __SPSCRING_H__
+#define __SPSCRING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Atomic.h"
+
+/*!
+ *  @brief  Ring object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct SpscRing_Struct {
+    volatile uint32_t  head;      /*!< Written by the producer only */
+    volatile uint32_t  tail;      /*!< Written by the consumer only */
+    uint32_t           mask;
+    uint16_t           elemSize;
+    uint8_t           *buf;
+} SpscRing_Struct;
+
+/*!
+ *  @brief  Initialize an empty ring
+ *
+ *  @param  buf       @p capacity elements of @p elemSize bytes
+ *  @param  capacity  A power of two
+ *
+ *  @return false if @p capacity is not a power of two.
+ */
+static inline bool SpscRing_construct(SpscRing_Struct *ring, void *buf,
+                                      uint16_t elemSize, uint32_t capacity)
+{
+    if ((capacity == 0) || ((capacity & (capacity - 1)) != 0)) {
+        return (false);
+    }
+
+    ring->head     = 0;
+    ring->tail     = 0;
+    ring->mask     = capacity - 1;
+    ring->elemSize = elemSize;
+    ring->buf      = (uint8_t *)buf;
+
+    return (true);
+}
+
+/*!
+ *  @brief  Elements in the ring, exact for the consumer
+ */
+static inline uint32_t SpscRing_count(const SpscRing_Struct *ring)
+{
+    return (ring->head - ring->tail);
+}
+
+/*!
+ *  @brief  Free slots, exact for the producer
+ */
+static inline uint32_t SpscRing_space(const SpscRing_Struct *ring)
+{
+    return (ring->mask + 1 - (ring->head - ring->tail));
+}
+
+/*!
+ *  @brief  Copy @p n elements in at position @p pos, wrapping at the end
+ */
+static inline void SpscRing_copyIn(SpscRing_Struct *ring, uint32_t pos,
+                                   const void *src, uint32_t n)
+{
+    uint32_t slot  = pos & ring->mask;
+    uint32_t first = ring->mask + 1 - slot;
+
+    if (first > n) {
+        first = n;
+    }
+    memcpy(ring->buf + slot * ring->elemSize, src, first * ring->elemSize);
+    memcpy(ring->buf, (const uint8_t *)src + first * ring->elemSize,
+            (n - first) * ring->elemSize);
+}
+
+/*!
+ *  @brief  Copy @p n elements out from position @p pos, wrapping at the end
+ */
+static inline void SpscRing_copyOut(const SpscRing_Struct *ring, uint32_t pos,
+                                    void *dst, uint32_t n)
+{
+    uint32_t slot  = pos & ring->mask;
+    uint32_t first = ring->mask + 1 - slot;
+
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, ring->buf + slot * ring->elemSize, first * ring->elemSize);
+    memcpy((uint8_t *)dst + first * ring->elemSize, ring->buf,
+            (n - first) * ring->elemSize);
+}
+
+/*!
+ *  @brief  Append up to @p n elements, producer only
+ *
+ *  @return The number of elements appended, less than @p n if the ring
+ *          filled up.
+ */
+static inline uint32_t SpscRing_pushBatch(SpscRing_Struct *ring,
+                                          const void *src, uint32_t n)
+{
+    uint32_t head = ring->head;
+    uint32_t space = ring->mask + 1 - (head - ring->tail);
+
+    if (n > space) {
+        n = space;
+    }
+    if (n == 0) {
+        return (0);
+    }
+
+    SpscRing_copyIn(ring, head, src, n);
+
+    /* The elements must be in place before the consumer can see them */
+    Atomic_dmb();
+    ring->head = head + n;
+
+    return (n);
+}
+
+/*!
+ *  @brief  Remove up to @p n elements, consumer only
+ *
+ *  @return The number of elements removed.
+ */
+static inline uint32_t SpscRing_popBatch(SpscRing_Struct *ring, void *dst,
+                                         uint32_t n)
+{
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+
+    if (n > count) {
+        n = count;
+    }
+    if (n == 0) {
+        return (0);
+    }
+
+    /* Read the elements only after the head that covers them */
+    Atomic_dmb();
+    SpscRing_copyOut(ring, tail, dst, n);
+
+    /* And be done with them before the producer may reuse the slots */
+    Atomic_dmb();
+    ring->tail = tail + n;
+
+    return (n);
+}
+
+/*!
+ *  @brief  Append one element, producer only
+ *
+ *  @return false if the ring is full.
+ */
+static inline bool SpscRing_push(SpscRing_Struct *ring, const void *elem)
+{
+    return (SpscRing_pushBatch(ring, elem, 1) == 1);
+}
+
+/*!
+ *  @brief  Remove one element, consumer only
+ *
+ *  @return false if the ring is empty.
+ */
+static inline bool SpscRing_pop(SpscRing_Struct *ring, void *elem)
+{
+    return (SpscRing_popBatch(ring, elem, 1) == 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPSCRING_H__ */
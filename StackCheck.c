@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== StackCheck.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "StackCheck.h"
+
+#define PATTERN_WORD    (StackCheck_PATTERN * 0x01010101U)
+
+#if defined(__TI_COMPILER_VERSION__)
+/* System stack, from the linker */
+extern uint8_t __stack[];
+extern uint8_t __STACK_END[];
+
+#define SYSTEM_STACK    {"ISR", __stack, 0, 0, 0, false}
+#define SYSTEM_COUNT    1
+#else
+#define SYSTEM_STACK    {NULL, NULL, 0, 0, 0, false}
+#define SYSTEM_COUNT    0
+#endif
+
+StackCheck_Usage StackCheck_usage[StackCheck_MAX_STACKS] = {SYSTEM_STACK};
+uint_least8_t    StackCheck_count = SYSTEM_COUNT;
+
+static ClockP_Struct StackCheck_clock;
+
+static void StackCheck_clockFxn(uintptr_t arg);
+static void StackCheck_update(StackCheck_Usage *usage);
+
+/*
+ *  ======== StackCheck_register ========
+ */
+bool StackCheck_register(const char *name, void *stack, size_t size)
+{
+    StackCheck_Usage *usage = NULL;
+    uintptr_t         key;
+    unsigned int      i;
+
+    /* Only whole, aligned words are painted and scanned */
+    memset(stack, StackCheck_PATTERN, size);
+
+    key = HwiP_disable();
+
+    for (i = 0; i < StackCheck_count; i++) {
+        if (StackCheck_usage[i].base == (uint8_t *)stack) {
+            usage = &StackCheck_usage[i];
+            break;
+        }
+    }
+
+    if (usage == NULL) {
+        if (StackCheck_count == StackCheck_MAX_STACKS) {
+            HwiP_restore(key);
+            return (false);
+        }
+        usage = &StackCheck_usage[StackCheck_count];
+        usage->base     = (uint8_t *)stack;
+        usage->peak     = 0;
+        usage->overflow = false;
+        StackCheck_count++;
+    }
+    usage->name = name;
+    usage->size = (uint16_t)(size & ~(size_t)3);
+
+    HwiP_restore(key);
+
+    return (true);
+}
+
+/*
+ *  ======== StackCheck_scan ========
+ */
+void StackCheck_scan(void)
+{
+    unsigned int i;
+
+#if defined(__TI_COMPILER_VERSION__)
+    StackCheck_usage[0].size = (uint16_t)(__STACK_END - __stack);
+#endif
+
+    for (i = 0; i < StackCheck_count; i++) {
+        StackCheck_update(&StackCheck_usage[i]);
+    }
+}
+
+/*
+ *  ======== StackCheck_start ========
+ */
+void StackCheck_start(uint32_t periodMs)
+{
+    ClockP_Params clockParams;
+    uint32_t      period = periodMs * 1000 / ClockP_tickPeriod;
+
+    ClockP_Params_init(&clockParams);
+    clockParams.period    = period;
+    clockParams.startFlag = true;
+    ClockP_construct(&StackCheck_clock, StackCheck_clockFxn, period,
+            &clockParams);
+}
+
+/*
+ *  ======== StackCheck_print ========
+ */
+void StackCheck_print(Display_Handle handle)
+{
+    StackCheck_Usage *usage;
+    uint32_t          size = 0;
+    uint32_t          recommended = 0;
+    unsigned int      i;
+
+    StackCheck_scan();
+
+    for (i = 0; i < StackCheck_count; i++) {
+        usage = &StackCheck_usage[i];
+        Display_printf(handle, 0, 0,
+                "Stack %s: %u bytes, peak %u, recommended %u%s", usage->name,
+                usage->size, usage->peak, usage->recommended,
+                usage->overflow ? ", OVERFLOW" : "");
+        size        += usage->size;
+        recommended += usage->recommended;
+    }
+    Display_printf(handle, 0, 0, "Stacks: %u bytes, recommended %u", size,
+            recommended);
+}
+
+/*
+ *  ======== StackCheck_clockFxn ========
+ */
+static void StackCheck_clockFxn(uintptr_t arg)
+{
+    StackCheck_scan();
+}
+
+/*
+ *  ======== StackCheck_update ========
+ *  Counts the painted words from the low end. The word at the base is
+ *  never used by a stack that has not overflowed.
+ */
+static void StackCheck_update(StackCheck_Usage *usage)
+{
+    const uint32_t *word = (const uint32_t *)usage->base;
+    const uint32_t *end = (const uint32_t *)(usage->base + usage->size);
+    uint32_t        peak;
+    uint32_t        margin;
+
+    while ((word < end) && (*word == PATTERN_WORD)) {
+        word++;
+    }
+
+    peak = (uint32_t)((const uint8_t *)end - (const uint8_t *)word);
+    if (peak > usage->peak) {
+        usage->peak = (uint16_t)peak;
+    }
+    usage->overflow = (word == (const uint32_t *)usage->base);
+
+    margin = usage->peak * StackCheck_MARGIN_PERCENT / 100;
+    if (margin < StackCheck_MARGIN_MIN) {
+        margin = StackCheck_MARGIN_MIN;
+    }
+    usage->recommended = (uint16_t)((usage->peak + margin + 7) & ~7U);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       StackCheck.h
+ *
+ *  @brief      Stack high-water marks and recommended stack sizes.
+ *
+ *  Every stack registered with StackCheck is painted with
+ *  StackCheck_PATTERN, the fill byte the kernel uses as well. Stacks grow
+ *  down, so the painted bytes left at the low end of a stack tell how deep
+ *  it has ever been used. StaticThread_construct() registers the stack of
+ *  every thread it creates; the system stack, which the kernel uses for
+ *  main() and all interrupts, is always listed as "ISR" and painted by the
+ *  kernel at startup.
+ *
+ *  StackCheck_scan() updates the peaks and is cheap enough to run from a
+ *  clock, see StackCheck_start(). The results are kept in StackCheck_usage,
+ *  which can be watched in the debugger's expression view or ROV while the
+ *  target runs, and StackCheck_print() writes them to a display.
+ *
+ *  The recommended size is the peak plus StackCheck_MARGIN_PERCENT, at
+ *  least StackCheck_MARGIN_MIN bytes, rounded up to 8 bytes. It is only as
+ *  good as the code paths exercised before it is read; run the worst case
+ *  (error paths, full queues, Log_TEXT builds) before shrinking a stack.
+ *
+ *  ============================================================================
+ */
+#ifndef __STACKCHECK_H__
+#define __STACKCHECK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+
+/*! Largest number of stacks tracked, including the system stack */
+#define StackCheck_MAX_STACKS       12
+
+/*! Fill byte of unused stack */
+#define StackCheck_PATTERN          0xBE
+
+#ifndef StackCheck_MARGIN_PERCENT
+#define StackCheck_MARGIN_PERCENT   25
+#endif
+
+#ifndef StackCheck_MARGIN_MIN
+#define StackCheck_MARGIN_MIN       64
+#endif
+
+/*!
+ *  @brief  Use of one stack
+ */
+typedef struct StackCheck_Usage {
+    const char *name;
+    uint8_t    *base;         /*!< Lowest address */
+    uint16_t    size;         /*!< Bytes */
+    uint16_t    peak;         /*!< Most bytes ever used */
+    uint16_t    recommended;  /*!< Suggested size, from @p peak */
+    bool        overflow;     /*!< No painted byte was left */
+} StackCheck_Usage;
+
+/*! Tracked stacks, entry 0 is the system stack */
+extern StackCheck_Usage StackCheck_usage[StackCheck_MAX_STACKS];
+
+/*! Valid entries of StackCheck_usage */
+extern uint_least8_t StackCheck_count;
+
+/*!
+ *  @brief  Paint a stack and track it
+ *
+ *  Must be called before the stack is in use. A stack registered again,
+ *  for a new thread on the same memory, keeps its peak.
+ *
+ *  @return false if StackCheck_MAX_STACKS stacks are tracked already.
+ */
+extern bool StackCheck_register(const char *name, void *stack, size_t size);
+
+/*!
+ *  @brief  Update the peaks of all stacks
+ *
+ *  May be called from any context.
+ */
+extern void StackCheck_scan(void);
+
+/*!
+ *  @brief  Scan the stacks every @p periodMs milliseconds from a clock
+ */
+extern void StackCheck_start(uint32_t periodMs);
+
+/*!
+ *  @brief  Scan the stacks and print a table of their use
+ */
+extern void StackCheck_print(Display_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STACKCHECK_H__ */
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== StaticThread.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+#include <ti/sysbios/knl/Task.h>
+
+#include "StackCheck.h"
+#include "StaticThread.h"
+
+static void StaticThread_entry(UArg arg0, UArg arg1);
+
+/*
+ *  ======== StaticThread_construct ========
+ */
+bool StaticThread_construct(StaticThread_Struct *thread,
+                            StaticThread_Config const *config)
+{
+    Task_Params taskParams;
+    Error_Block eb;
+
+    thread->fxn         = config->fxn;
+    thread->arg         = config->arg;
+    thread->constructed = false;
+
+    /* Untracked beyond StackCheck_MAX_STACKS, but still usable */
+    StackCheck_register(config->name, config->stack, config->stackSize);
+
+    Task_Params_init(&taskParams);
+    taskParams.instance->name = (xdc_String)config->name;
+    taskParams.arg0           = (UArg)thread;
+    taskParams.priority       = config->priority;
+    taskParams.stack          = config->stack;
+    taskParams.stackSize      = config->stackSize;
+
+    Error_init(&eb);
+    Task_construct(&thread->task, StaticThread_entry, &taskParams, &eb);
+    if (Error_check(&eb)) {
+        return (false);
+    }
+
+    thread->constructed = true;
+
+    return (true);
+}
+
+/*
+ *  ======== StaticThread_join ========
+ */
+void StaticThread_join(StaticThread_Struct *thread)
+{
+    if (!thread->constructed) {
+        return;
+    }
+
+    while (Task_getMode(Task_handle(&thread->task)) != Task_Mode_TERMINATED) {
+        Task_sleep(1);
+    }
+
+    Task_destruct(&thread->task);
+    thread->constructed = false;
+}
+
+/*
+ *  ======== StaticThread_entry ========
+ *  The task terminates when this returns.
+ */
+static void StaticThread_entry(UArg arg0, UArg arg1)
+{
+    StaticThread_Struct *thread = (StaticThread_Struct *)arg0;
+
+    thread->fxn(thread->arg);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       StaticThread.h
+ *
+ *  @brief      Threads constructed in place, without the heap.
+ *
+ *  pthread_create() takes the thread object, and the stack unless one is
+ *  given, from the kernel heap. StaticThread constructs a kernel task in a
+ *  StaticThread_Struct owned by the caller and runs it on a caller-provided
+ *  stack, so the RAM of every thread is allocated at link time.
+ *
+ *  Thread functions have the pthread signature and may use the POSIX
+ *  functions that do not refer to the calling pthread, such as sleep(),
+ *  usleep() and sem_wait(); the DPL functions work as well. pthread_self(),
+ *  pthread_join() and thread-specific data do not.
+ *
+ *  Stacks are painted and tracked by StackCheck (see StackCheck.h).
+ *
+ *  A thread terminates by returning. StaticThread_join() waits for that,
+ *  after which the struct and the stack may be used again.
+ *
+ *  ============================================================================
+ */
+#ifndef __STATICTHREAD_H__
+#define __STATICTHREAD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <xdc/std.h>
+#include <ti/sysbios/knl/Task.h>
+
+/*!
+ *  @brief  Define a stack of @p size bytes, 8 byte aligned
+ */
+#define StaticThread_STACK(name, size)  uint64_t name[((size) + 7) / 8]
+
+/*!
+ *  @brief  Thread function, as for pthread_create()
+ */
+typedef void *(*StaticThread_Fxn)(void *arg);
+
+/*!
+ *  @brief  A thread, in a configuration table
+ */
+typedef struct StaticThread_Config {
+    const char       *name;       /*!< Task name shown in ROV */
+    StaticThread_Fxn  fxn;
+    void             *arg;
+    int               priority;   /*!< Task priority, as for pthreads */
+    void             *stack;      /*!< Stack, see StaticThread_STACK() */
+    size_t            stackSize;
+} StaticThread_Config;
+
+/*!
+ *  @brief  Thread object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct StaticThread_Struct {
+    Task_Struct       task;
+    StaticThread_Fxn  fxn;
+    void             *arg;
+    bool              constructed;
+} StaticThread_Struct;
+
+/*!
+ *  @brief  Construct a thread and make it ready to run
+ *
+ *  @p config is only read during the call.
+ *
+ *  @return false if the task could not be constructed.
+ */
+extern bool StaticThread_construct(StaticThread_Struct *thread,
+                                   StaticThread_Config const *config);
+
+/*!
+ *  @brief  Wait until a thread has returned, then destruct it
+ *
+ *  Returns at once for a thread that was never constructed.
+ */
+extern void StaticThread_join(StaticThread_Struct *thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STATICTHREAD_H__ */
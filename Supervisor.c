@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Supervisor.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/Watchdog.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "Board.h"
+#include "Log.h"
+#include "Supervisor.h"
+
+static Watchdog_Handle    Supervisor_watchdog;
+static ClockP_Struct      Supervisor_clock;
+
+/* Protected by HwiP_disable() */
+static Supervisor_Client *Supervisor_clients;
+
+/* First client found late, until all are in time again */
+static Supervisor_Client *volatile Supervisor_late;
+
+static void Supervisor_clockFxn(uintptr_t arg);
+static void Supervisor_watchdogFxn(uintptr_t handle);
+
+/*
+ *  ======== Supervisor_start ========
+ */
+bool Supervisor_start(uint32_t periodMs)
+{
+    Watchdog_Params watchdogParams;
+    ClockP_Params   clockParams;
+    uint32_t        period = periodMs * 1000 / ClockP_tickPeriod;
+
+    Watchdog_init();
+    Watchdog_Params_init(&watchdogParams);
+    watchdogParams.callbackFxn    = Supervisor_watchdogFxn;
+    watchdogParams.resetMode      = Watchdog_RESET_ON;
+    watchdogParams.debugStallMode = Watchdog_DEBUG_STALL_ON;
+    Supervisor_watchdog = Watchdog_open(Board_WATCHDOG0, &watchdogParams);
+    if (Supervisor_watchdog == NULL) {
+        return (false);
+    }
+
+    ClockP_Params_init(&clockParams);
+    clockParams.period    = period;
+    clockParams.startFlag = true;
+    ClockP_construct(&Supervisor_clock, Supervisor_clockFxn, period,
+            &clockParams);
+
+    return (true);
+}
+
+/*
+ *  ======== Supervisor_register ========
+ */
+void Supervisor_register(Supervisor_Client *client, const char *name,
+                         uint32_t deadlineMs)
+{
+    uintptr_t key;
+
+    client->name     = name;
+    client->deadline = deadlineMs * 1000 / ClockP_tickPeriod;
+    client->maxAge   = 0;
+    client->misses   = 0;
+    Supervisor_checkIn(client);
+
+    key = HwiP_disable();
+    client->next = Supervisor_clients;
+    Supervisor_clients = client;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== Supervisor_unregister ========
+ */
+void Supervisor_unregister(Supervisor_Client *client)
+{
+    Supervisor_Client **link;
+    uintptr_t           key;
+
+    key = HwiP_disable();
+    for (link = &Supervisor_clients; *link != NULL; link = &((*link)->next)) {
+        if (*link == client) {
+            *link = client->next;
+            break;
+        }
+    }
+    if (Supervisor_late == client) {
+        Supervisor_late = NULL;
+    }
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== Supervisor_print ========
+ */
+void Supervisor_print(Display_Handle handle)
+{
+    Supervisor_Client *client;
+    int32_t            margin;
+
+    for (client = Supervisor_clients; client != NULL; client = client->next) {
+        margin = (int32_t)client->deadline - (int32_t)client->maxAge;
+        Display_printf(handle, 0, 0,
+                "Watchdog %s: deadline %u ms, max gap %u ms, margin %d ms, "
+                "%u late", client->name,
+                client->deadline * ClockP_tickPeriod / 1000,
+                client->maxAge * ClockP_tickPeriod / 1000,
+                margin * (int32_t)ClockP_tickPeriod / 1000, client->misses);
+    }
+}
+
+/*
+ *  ======== Supervisor_clockFxn ========
+ *  Feeds the watchdog if no client is late.
+ */
+static void Supervisor_clockFxn(uintptr_t arg)
+{
+    Supervisor_Client *client;
+    Supervisor_Client *late = NULL;
+    uint32_t           now = ClockP_getSystemTicks();
+    int32_t            age;
+    uintptr_t          key;
+
+    key = HwiP_disable();
+    for (client = Supervisor_clients; client != NULL; client = client->next) {
+        /* Negative during a grace window */
+        age = (int32_t)(now - client->checkIn);
+        if (age <= 0) {
+            continue;
+        }
+        if ((uint32_t)age > client->maxAge) {
+            client->maxAge = age;
+        }
+        if ((uint32_t)age > client->deadline) {
+            client->misses++;
+            if (late == NULL) {
+                late = client;
+            }
+        }
+    }
+    HwiP_restore(key);
+
+    if (late == NULL) {
+        Supervisor_late = NULL;
+        Watchdog_clear(Supervisor_watchdog);
+    }
+    else if (Supervisor_late == NULL) {
+        Supervisor_late = late;
+        Log_warning1(LogMod_APP, "Watchdog: %s is late", late->name);
+    }
+}
+
+/*
+ *  ======== Supervisor_watchdogFxn ========
+ *  First timeout, the device resets at the next one.
+ */
+static void Supervisor_watchdogFxn(uintptr_t handle)
+{
+    Supervisor_Client *late = Supervisor_late;
+
+    Log_error1(LogMod_APP, "Watchdog expired, reset by %s",
+            (late != NULL) ? late->name : "unknown");
+}
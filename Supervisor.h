@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Supervisor.h
+ *
+ *  @brief      Watchdog fed only while every registered thread is alive.
+ *
+ *  The supervisor owns Board_WATCHDOG0. A clock checks the registered
+ *  clients every period and clears the watchdog only if each of them has
+ *  checked in within its own deadline; a single stuck thread therefore
+ *  lets the watchdog expire even though the kernel, and the clock, still
+ *  run. The watchdog interrupts at its first timeout and resets the device
+ *  at the second, so a hung client resets the device between one and two
+ *  reload periods (hwAttrs reloadValue) after it missed its deadline. The
+ *  interrupt logs the first late client.
+ *
+ *  A check-in is a single store of the current tick, cheap enough for any
+ *  loop. A client about to block for longer than its deadline on purpose,
+ *  such as a thread erasing flash, declares a grace window first with
+ *  Supervisor_grace(); its next check-in ends the window.
+ *
+ *  The fields of Supervisor_Client give the longest gap between check-ins
+ *  seen by the supervisor, outside grace windows, so deadlines can be tuned
+ *  from data; Supervisor_print() lists them with the remaining margin. Gaps
+ *  are sampled once per period, so they are accurate to one period.
+ *
+ *  With no client registered the watchdog is always fed.
+ *
+ *  @code
+ *  static Supervisor_Client client;
+ *
+ *  Supervisor_register(&client, "storage", 500);
+ *  while (1) {
+ *      Supervisor_checkIn(&client);
+ *      waitForWork();
+ *      Supervisor_grace(&client, 200);
+ *      eraseSector();
+ *  }
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __SUPERVISOR_H__
+#define __SUPERVISOR_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+
+/*!
+ *  @brief  A supervised thread
+ *
+ *  The application must only read @p maxAge and @p misses, and only write
+ *  the struct through the functions below.
+ */
+typedef struct Supervisor_Client {
+    struct Supervisor_Client *next;
+    const char               *name;
+    uint32_t                  deadline;  /*!< Ticks allowed between
+                                              check-ins */
+    volatile uint32_t         checkIn;   /*!< Tick of the last check-in,
+                                              later during a grace window */
+    uint32_t                  maxAge;    /*!< Ticks, longest gap seen */
+    uint32_t                  misses;    /*!< Periods found late */
+} Supervisor_Client;
+
+/*!
+ *  @brief  Open the watchdog and check the clients every @p periodMs
+ *
+ *  @p periodMs must be well below the watchdog reload period.
+ *
+ *  @return false if the watchdog is not available.
+ */
+extern bool Supervisor_start(uint32_t periodMs);
+
+/*!
+ *  @brief  Supervise a thread, starting with a check-in
+ *
+ *  @param  deadlineMs  Longest time allowed between check-ins
+ */
+extern void Supervisor_register(Supervisor_Client *client, const char *name,
+                                uint32_t deadlineMs);
+
+/*!
+ *  @brief  Stop supervising a thread, for example before it ends
+ */
+extern void Supervisor_unregister(Supervisor_Client *client);
+
+/*!
+ *  @brief  Tell the supervisor that the calling thread is alive
+ */
+static inline void Supervisor_checkIn(Supervisor_Client *client)
+{
+    client->checkIn = ClockP_getSystemTicks();
+}
+
+/*!
+ *  @brief  Allow @p ms more than the deadline until the next check-in
+ *
+ *  Dates the check-in @p ms ahead, so the deadline runs from the end of
+ *  the window.
+ */
+static inline void Supervisor_grace(Supervisor_Client *client, uint32_t ms)
+{
+    client->checkIn = ClockP_getSystemTicks() + ms * 1000 / ClockP_tickPeriod;
+}
+
+/*!
+ *  @brief  Print the deadline, longest gap and margin of every client
+ *
+ *  Clients must not be unregistered meanwhile.
+ */
+extern void Supervisor_print(Display_Handle handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SUPERVISOR_H__ */
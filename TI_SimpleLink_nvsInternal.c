@@ -122,12 +122,26 @@
 #include <string.h>
 #include <stdlib.h>
 
+/* RTOS header files */
+#include <xdc/std.h>
+#include <xdc/runtime/Memory.h>
+
 /* Driver Header files */
 #include <ti/display/Display.h>
 #include <ti/drivers/NVS.h>
 
 /* Example/Board Header files */
 #include "Board.h"
+#include "CpuLoad.h"
+#include "Energy.h"
+#include "FlashPolicy.h"
+#include "Log.h"
+#include "Prof.h"
+#include "RemoteCmd.h"
+#include "Sampler.h"
+#include "StackCheck.h"
+#include "Supervisor.h"
+#include "benchmarks/Bench.h"
 
 #define FOOTER "=================================================="
 
@@ -143,6 +157,16 @@ static uint8_t buffer[4];
 // Status of saving to NVS/reading from NVS pages
 static int8_t rwStatus = 0;
 
+/*
+ * mainThread is supervised while it accesses NVS and, through RemoteCmd,
+ * while it serves remote commands. Each write below erases a sector first,
+ * which the grace window covers.
+ */
+#define MAIN_DEADLINE_MS    500
+#define NVS_ERASE_GRACE_MS  200
+
+static Supervisor_Client mainClient;
+
 // 8-bit variables for testing
 const uint8_t variableA = 240;
 const int8_t variableB = -65;
@@ -157,8 +181,10 @@ const int16_t variableD = -6453;
 void *mainThread(void *arg0)
 {
     NVS_Handle nvsHandle;
+    NVS_Handle nvsRegions[2];
     NVS_Attrs regionAttrs;
     NVS_Params nvsParams;
+    Memory_Stats heapStats;
 
     Display_Handle displayHandle;
 
@@ -171,15 +197,21 @@ void *mainThread(void *arg0)
         while (1);
     }
 
+    /* Log records share the UART opened by the display */
+    Log_init(Board_UART0);
+
     NVS_Params_init(&nvsParams);
     nvsHandle = NVS_open(Board_NVSINTERNAL, &nvsParams);
 
     if (nvsHandle == NULL) {
-        Display_printf(displayHandle, 0, 0, "NVS_open() failed.");
+        Log_error0(LogMod_NVS, "NVS_open() failed.");
 
         return (NULL);
     }
 
+    /* Demos and benchmarks enabled in benchmarks/Bench.h */
+    Bench_runAll(displayHandle, nvsHandle);
+
     Display_printf(displayHandle, 0, 0, "\n");
 
     /*
@@ -188,61 +220,67 @@ void *mainThread(void *arg0)
      * and sector size.
      */
     NVS_getAttrs(nvsHandle, &regionAttrs);
+    Supervisor_register(&mainClient, "main", MAIN_DEADLINE_MS);
 
     /* Display the NVS region attributes */
-    Display_printf(displayHandle, 0, 0, "Region Base Address: 0x%x",
-            regionAttrs.regionBase);
-    Display_printf(displayHandle, 0, 0, "Sector Size: 0x%x",
-            regionAttrs.sectorSize);
-    Display_printf(displayHandle, 0, 0, "Region Size: 0x%x\n",
-            regionAttrs.regionSize);
+    Log_info1(LogMod_NVS, "Region Base Address: 0x%x", regionAttrs.regionBase);
+    Log_info1(LogMod_NVS, "Sector Size: 0x%x", regionAttrs.sectorSize);
+    Log_info1(LogMod_NVS, "Region Size: 0x%x", regionAttrs.regionSize);
 
     // Read from page 0x12000
-    rwStatus = NVS_read(nvsHandle, 0x10000, (void *) buffer, sizeof(buffer));
+    Prof_SCOPE(ProfSite_NVS_READ,
+            rwStatus = NVS_read(nvsHandle, 0x10000, (void *) buffer,
+                                sizeof(buffer)));
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Reading value from page 0x12000\n");
+        Log_debug1(LogMod_NVS, "Reading value from page 0x%x", 0x12000);
         uint8_t variableAtemp = buffer[0];
-        Display_printf(displayHandle, 0, 0, "%u\n", variableAtemp);
+        Log_info1(LogMod_APP, "%u", variableAtemp);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot read from page 0x12000\n");
+        Log_error1(LogMod_NVS, "Cannot read from page 0x%x", 0x12000);
     }
 
 
     // Read from page 0x6000
-    rwStatus = NVS_read(nvsHandle, 0x4000, (void *) buffer, sizeof(buffer));
+    Prof_SCOPE(ProfSite_NVS_READ,
+            rwStatus = NVS_read(nvsHandle, 0x4000, (void *) buffer,
+                                sizeof(buffer)));
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Reading value from page 0x6000\n");
+        Log_debug1(LogMod_NVS, "Reading value from page 0x%x", 0x6000);
         int8_t variableBtemp = (int8_t) buffer[0];
-        Display_printf(displayHandle, 0, 0, "%d\n", variableBtemp);
+        Log_info1(LogMod_APP, "%d", variableBtemp);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot read from page 0x6000\n");
+        Log_error1(LogMod_NVS, "Cannot read from page 0x%x", 0x6000);
     }
 
 
     // Read from page 0x16000
-    rwStatus = NVS_read(nvsHandle, 0x14000, (void *) buffer, sizeof(buffer));
+    Prof_SCOPE(ProfSite_NVS_READ,
+            rwStatus = NVS_read(nvsHandle, 0x14000, (void *) buffer,
+                                sizeof(buffer)));
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Reading value from page 0x16000\n");
+        Log_debug1(LogMod_NVS, "Reading value from page 0x%x", 0x16000);
         uint16_t variableCtemp = buffer[0] | (buffer[1] << 8);
-        Display_printf(displayHandle, 0, 0, "%u\n", variableCtemp);
+        Log_info1(LogMod_APP, "%u", variableCtemp);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot read from page 0x16000\n");
+        Log_error1(LogMod_NVS, "Cannot read from page 0x%x", 0x16000);
     }
 
 
     // Read from page 0x19000
-    rwStatus = NVS_read(nvsHandle, 0x17000, (void *) buffer, sizeof(buffer));
+    Prof_SCOPE(ProfSite_NVS_READ,
+            rwStatus = NVS_read(nvsHandle, 0x17000, (void *) buffer,
+                                sizeof(buffer)));
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Reading value from page 0x19000\n");
+        Log_debug1(LogMod_NVS, "Reading value from page 0x%x", 0x19000);
         uint16_t variableDtempU = buffer[0] | (buffer[1] << 8);
         int16_t variableDtemp = (int16_t) variableDtempU;
-        Display_printf(displayHandle, 0, 0, "%d\n", variableDtemp);
+        Log_info1(LogMod_APP, "%d", variableDtemp);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot read from page 0x19000\n");
+        Log_error1(LogMod_NVS, "Cannot read from page 0x%x", 0x19000);
     }
 
 
@@ -251,13 +289,17 @@ void *mainThread(void *arg0)
     buffer[1] = 0xff;
     buffer[2] = 0xff;
     buffer[3] = 0xff;
-    rwStatus = NVS_write(nvsHandle, 0x10000, (void *) buffer, sizeof(buffer),
-                           NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY);
+    Supervisor_grace(&mainClient, NVS_ERASE_GRACE_MS);
+    Energy_begin(EnergyOp_NVS_ERASE);
+    Prof_SCOPE(ProfSite_NVS_WRITE,
+            rwStatus = NVS_write(nvsHandle, 0x10000, (void *) buffer,
+                    sizeof(buffer), NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY));
+    Energy_end(EnergyOp_NVS_ERASE);
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Successfully written at page 0x12000\n");
+        Log_debug1(LogMod_NVS, "Successfully written at page 0x%x", 0x12000);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot write at page 0x12000\n");
+        Log_error1(LogMod_NVS, "Cannot write at page 0x%x", 0x12000);
     }
 
     // Write variableB at page 0x6000
@@ -265,13 +307,17 @@ void *mainThread(void *arg0)
     buffer[1] = 0xff;
     buffer[2] = 0xff;
     buffer[3] = 0xff;
-    rwStatus = NVS_write(nvsHandle, 0x4000, (void *) buffer, sizeof(buffer),
-                           NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY);
+    Supervisor_grace(&mainClient, NVS_ERASE_GRACE_MS);
+    Energy_begin(EnergyOp_NVS_ERASE);
+    Prof_SCOPE(ProfSite_NVS_WRITE,
+            rwStatus = NVS_write(nvsHandle, 0x4000, (void *) buffer,
+                    sizeof(buffer), NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY));
+    Energy_end(EnergyOp_NVS_ERASE);
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Successfully written at page 0x6000\n");
+        Log_debug1(LogMod_NVS, "Successfully written at page 0x%x", 0x6000);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot write at page 0x6000\n");
+        Log_error1(LogMod_NVS, "Cannot write at page 0x%x", 0x6000);
     }
 
     // Write variableC at page 0x16000
@@ -279,13 +325,17 @@ void *mainThread(void *arg0)
     buffer[1] = (variableC & 0xFF00) >> 8;
     buffer[2] = 0xff;
     buffer[3] = 0xff;
-    rwStatus = NVS_write(nvsHandle, 0x14000, (void *) buffer, sizeof(buffer),
-                           NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY);
+    Supervisor_grace(&mainClient, NVS_ERASE_GRACE_MS);
+    Energy_begin(EnergyOp_NVS_ERASE);
+    Prof_SCOPE(ProfSite_NVS_WRITE,
+            rwStatus = NVS_write(nvsHandle, 0x14000, (void *) buffer,
+                    sizeof(buffer), NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY));
+    Energy_end(EnergyOp_NVS_ERASE);
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Successfully written at page 0x16000\n");
+        Log_debug1(LogMod_NVS, "Successfully written at page 0x%x", 0x16000);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot write at page 0x16000\n");
+        Log_error1(LogMod_NVS, "Cannot write at page 0x%x", 0x16000);
     }
 
     // Write variableD at page 0x19000
@@ -294,17 +344,59 @@ void *mainThread(void *arg0)
     buffer[1] = (variableDtemp & 0xFF00) >> 8;
     buffer[2] = 0xff;
     buffer[3] = 0xff;
-    rwStatus = NVS_write(nvsHandle, 0x17000, (void *) buffer, sizeof(buffer),
-                           NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY);
+    Supervisor_grace(&mainClient, NVS_ERASE_GRACE_MS);
+    Energy_begin(EnergyOp_NVS_ERASE);
+    Prof_SCOPE(ProfSite_NVS_WRITE,
+            rwStatus = NVS_write(nvsHandle, 0x17000, (void *) buffer,
+                    sizeof(buffer), NVS_WRITE_ERASE | NVS_WRITE_POST_VERIFY));
+    Energy_end(EnergyOp_NVS_ERASE);
     if (rwStatus == NVS_SOK) {
-        Display_printf(displayHandle, 0, 0, "Successfully written at page 0x19000\n");
+        Log_debug1(LogMod_NVS, "Successfully written at page 0x%x", 0x19000);
     }
     else {
-        Display_printf(displayHandle, 0, 0, "Cannot write at page 0x19000\n");
+        Log_error1(LogMod_NVS, "Cannot write at page 0x%x", 0x19000);
     }
 
-    Display_printf(displayHandle, 0, 0, "Reset the device.");
+    Supervisor_checkIn(&mainClient);
+    Log_info0(LogMod_APP, "Reset the device.");
+
+    /* Every thread has run its startup path by now */
+    StackCheck_print(displayHandle);
+    CpuLoad_print(displayHandle);
+    Supervisor_print(displayHandle);
+    Prof_print(displayHandle);
+    Energy_print(displayHandle);
+    Sampler_stop();
+    Sampler_print(displayHandle);
     Display_printf(displayHandle, 0, 0, FOOTER);
 
+    /*
+     * Serve tools/remotecmd.py on the same UART from now on. The external
+     * flash is only available to compressed dumps, as region 1.
+     */
+    nvsRegions[0] = nvsHandle;
+    FlashPolicy_begin();
+    Energy_begin(EnergyOp_SPI_WAKE);
+    nvsRegions[1] = NVS_open(Board_NVSEXTERNAL, &nvsParams);
+    Energy_end(EnergyOp_SPI_WAKE);
+    FlashPolicy_end();
+
+    /* Every driver is open now, see HEAPSIZE */
+    Memory_getStats(NULL, &heapStats);
+    Log_info2(LogMod_APP, "Heap: %u of %u bytes used",
+            heapStats.totalSize - heapStats.totalFreeSize,
+            heapStats.totalSize);
+
+    if (!RemoteCmd_run(Board_UART0, nvsRegions,
+            (nvsRegions[1] != NULL) ? 2 : 1, &mainClient)) {
+        Log_error0(LogMod_APP, "Remote commands are not available.");
+    }
+    else {
+        Log_error0(LogMod_APP, "Remote commands stopped.");
+    }
+
+    /* Nothing checks in from here on, stop the watchdog from waiting on it */
+    Supervisor_unregister(&mainClient);
+
     return (NULL);
 }
@@ -0,0 +1,1092 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== UartDmaCC26XX.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/devices/cc13x0/driverlib/ioc.h>
+#include <ti/devices/cc13x0/driverlib/uart.h>
+#include <ti/devices/cc13x0/driverlib/udma.h>
+#include <ti/devices/cc13x0/inc/hw_memmap.h>
+#include <ti/devices/cc13x0/inc/hw_types.h>
+#include <ti/devices/cc13x0/inc/hw_uart.h>
+#include <ti/devices/cc13x0/inc/hw_udma.h>
+
+#include <ti/drivers/Power.h>
+#include <ti/drivers/power/PowerCC26XX.h>
+#include <ti/drivers/pin/PINCC26XX.h>
+#include <ti/drivers/dpl/SwiP.h>
+
+#include "Atomic.h"
+#include "Prof.h"
+#include "UartDmaCC26XX.h"
+
+/* Bits on the wire per byte: start bit, 8 data bits and one stop bit */
+#define BITS_PER_BYTE       10
+
+/* Depth of the UART transmit FIFO in bytes */
+#define TX_FIFO_DEPTH       32
+
+/* Mode and transfer size fields of a uDMA control word */
+#define DMA_MODE_MASK       0x00000007
+#define DMA_XFERSIZE(ctl)   ((((ctl) >> 4) & 0x3FF) + 1)
+
+/* Receive interrupts, only enabled while the uDMA has buffer space */
+#define UART_INT_RX_DMA     (UART_INT_RT | UART_INT_OE)
+
+/* All UART interrupt sources */
+#define UART_INT_ALL        (UART_INT_OE | UART_INT_BE | UART_INT_PE | \
+                             UART_INT_FE | UART_INT_RT | UART_INT_TX | \
+                             UART_INT_RX | UART_INT_CTS)
+
+static UartDmaCC26XX_TxSlot *UartDmaCC26XX_claim(UartDmaCC26XX_Handle handle);
+static void UartDmaCC26XX_hwiFxn(uintptr_t arg);
+static void UartDmaCC26XX_initHw(UartDmaCC26XX_Handle handle);
+static bool UartDmaCC26XX_openPins(UartDmaCC26XX_Handle handle);
+static int UartDmaCC26XX_postNotifyFxn(unsigned int eventType,
+                                       uintptr_t eventArg,
+                                       uintptr_t clientArg);
+static void UartDmaCC26XX_publish(UartDmaCC26XX_Handle handle,
+                                  UartDmaCC26XX_TxSlot *slot);
+static void UartDmaCC26XX_rxArm(UartDmaCC26XX_Handle handle);
+static void UartDmaCC26XX_rxFlow(UartDmaCC26XX_Handle handle);
+static void UartDmaCC26XX_rxKick(UartDmaCC26XX_Handle handle);
+static void UartDmaCC26XX_rxService(UartDmaCC26XX_Handle handle, bool idle);
+static void UartDmaCC26XX_drainFxn(uintptr_t arg);
+static void UartDmaCC26XX_txDmaNext(UartDmaCC26XX_Handle handle);
+static void UartDmaCC26XX_txIdleFxn(uintptr_t arg);
+static void UartDmaCC26XX_txRelease(UartDmaCC26XX_Handle handle,
+                                    UartDmaCC26XX_TxSlot *slot);
+static void UartDmaCC26XX_txStart(UartDmaCC26XX_Handle handle);
+
+/*
+ *  ======== UartDmaCC26XX_Params_init ========
+ */
+void UartDmaCC26XX_Params_init(UartDmaCC26XX_Params *params)
+{
+    params->baudRate       = 115200;
+    params->overflowPolicy = UartDmaCC26XX_OVERFLOW_DROP;
+    params->blockTimeout   = SemaphoreP_WAIT_FOREVER;
+}
+
+/*
+ *  ======== UartDmaCC26XX_open ========
+ */
+UartDmaCC26XX_Handle UartDmaCC26XX_open(uint_least8_t index,
+                                        UartDmaCC26XX_Params *params)
+{
+    UartDmaCC26XX_Handle         handle;
+    UartDmaCC26XX_Object        *object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs;
+    UartDmaCC26XX_Params         defaultParams;
+    HwiP_Params                  hwiParams;
+    ClockP_Params                clockParams;
+    uintptr_t                    key;
+    uint16_t                     i;
+
+    if (index >= UartDmaCC26XX_count) {
+        return (NULL);
+    }
+
+    handle  = &UartDmaCC26XX_config[index];
+    object  = handle->object;
+    hwAttrs = handle->hwAttrs;
+
+    key = HwiP_disable();
+    if (object->isOpen) {
+        HwiP_restore(key);
+        return (NULL);
+    }
+    object->isOpen = true;
+    HwiP_restore(key);
+
+    if (params == NULL) {
+        UartDmaCC26XX_Params_init(&defaultParams);
+        params = &defaultParams;
+    }
+    object->params = *params;
+
+    /* An empty queue expects position i in slot i */
+    for (i = 0; i < hwAttrs->txSlotCount; i++) {
+        hwAttrs->txSlots[i].seq = i;
+    }
+    object->txEnqPos     = 0;
+    object->txDeqPos     = 0;
+    object->txActive     = NULL;
+    object->txRemaining  = 0;
+    object->txWaiters    = 0;
+    object->txConstraint = false;
+    object->rxRunning    = false;
+    object->rxHold       = false;
+    object->rtsAsserted  = false;
+    memset(&object->stats, 0, sizeof(object->stats));
+
+    /*
+     * Once the last uDMA transfer has completed, up to a full FIFO is still
+     * on its way out. Standby is held off for that long.
+     */
+    object->txDrainTicks = (TX_FIFO_DEPTH * BITS_PER_BYTE * 1000000) /
+        (object->params.baudRate * ClockP_tickPeriod) + 1;
+
+    Power_setDependency(hwAttrs->powerMngrId);
+
+    if (!UartDmaCC26XX_openPins(handle)) {
+        Power_releaseDependency(hwAttrs->powerMngrId);
+        object->isOpen = false;
+        return (NULL);
+    }
+
+    object->udmaHandle = UDMACC26XX_open();
+    if (object->udmaHandle == NULL) {
+        PIN_close(object->pinHandle);
+        Power_releaseDependency(hwAttrs->powerMngrId);
+        object->isOpen = false;
+        return (NULL);
+    }
+
+    HwiP_Params_init(&hwiParams);
+    hwiParams.arg      = (uintptr_t)handle;
+    hwiParams.priority = hwAttrs->intPriority;
+    HwiP_construct(&(object->hwi), hwAttrs->intNum, UartDmaCC26XX_hwiFxn,
+                   &hwiParams);
+
+    WorkQueue_Item_init(&(object->drainWork), UartDmaCC26XX_drainFxn,
+                        (uintptr_t)handle);
+
+    ClockP_Params_init(&clockParams);
+    clockParams.arg = (uintptr_t)handle;
+    ClockP_construct(&(object->txIdleClock), UartDmaCC26XX_txIdleFxn,
+                     object->txDrainTicks, &clockParams);
+
+    SemaphoreP_constructBinary(&(object->txSpaceSem), 0);
+    SemaphoreP_constructBinary(&(object->rxSem), 0);
+
+    /* The UART loses its configuration in standby */
+    Power_registerNotify(&object->postNotify, PowerCC26XX_AWAKE_STANDBY,
+                         UartDmaCC26XX_postNotifyFxn, (uintptr_t)handle);
+
+    UartDmaCC26XX_initHw(handle);
+
+    return (handle);
+}
+
+/*
+ *  ======== UartDmaCC26XX_getHandle ========
+ */
+UartDmaCC26XX_Handle UartDmaCC26XX_getHandle(uint_least8_t index)
+{
+    if (index >= UartDmaCC26XX_count ||
+        !UartDmaCC26XX_config[index].object->isOpen) {
+        return (NULL);
+    }
+
+    return (&UartDmaCC26XX_config[index]);
+}
+
+/*
+ *  ======== UartDmaCC26XX_close ========
+ */
+void UartDmaCC26XX_close(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    uintptr_t                    key;
+    uint32_t                     waited;
+
+    UartDmaCC26XX_rxStop(handle);
+
+    /* Let everything that was committed go out */
+    for (waited = 0; waited < UartDmaCC26XX_CLOSE_TIMEOUT_MS; waited++) {
+        if (object->txActive == NULL &&
+                object->txDeqPos == object->txEnqPos &&
+                !UARTBusy(hwAttrs->baseAddr)) {
+            break;
+        }
+        ClockP_usleep(1000);
+    }
+
+    /*
+     * Slots still queued are reserved but never committed, or held off by
+     * CTS. Drop them, along with a transfer in flight.
+     */
+    key = HwiP_disable();
+    if (object->txActive != NULL) {
+        UARTDMADisable(hwAttrs->baseAddr, UART_DMA_TX);
+        UDMACC26XX_channelDisable(object->udmaHandle,
+                                  hwAttrs->txChannelBitMask);
+        object->txActive    = NULL;
+        object->txRemaining = 0;
+    }
+    object->stats.txDropped += object->txEnqPos - object->txDeqPos;
+    object->txDeqPos = object->txEnqPos;
+    HwiP_restore(key);
+
+    ClockP_stop(&(object->txIdleClock));
+    if (object->txConstraint) {
+        Power_releaseConstraint(PowerCC26XX_SB_DISALLOW);
+        object->txConstraint = false;
+    }
+
+    UARTIntDisable(hwAttrs->baseAddr, UART_INT_ALL);
+    UARTDMADisable(hwAttrs->baseAddr, UART_DMA_TX | UART_DMA_RX);
+    UARTDisable(hwAttrs->baseAddr);
+
+    Power_unregisterNotify(&object->postNotify);
+
+    HwiP_destruct(&(object->hwi));
+    ClockP_destruct(&(object->txIdleClock));
+    SemaphoreP_destruct(&(object->txSpaceSem));
+    SemaphoreP_destruct(&(object->rxSem));
+
+    UDMACC26XX_close(object->udmaHandle);
+    PIN_close(object->pinHandle);
+
+    Power_releaseDependency(hwAttrs->powerMngrId);
+
+    object->isOpen = false;
+}
+
+/*
+ *  ======== UartDmaCC26XX_reserve ========
+ */
+UartDmaCC26XX_TxSlot *UartDmaCC26XX_reserve(UartDmaCC26XX_Handle handle,
+                                            uint8_t **data)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    UartDmaCC26XX_TxSlot        *slot;
+
+    slot = UartDmaCC26XX_claim(handle);
+
+    if (slot == NULL &&
+        object->params.overflowPolicy == UartDmaCC26XX_OVERFLOW_BLOCK &&
+        !HwiP_inISR() && !SwiP_inISR()) {
+
+        Atomic_add32(&object->stats.txBlocked, 1);
+        Atomic_add32(&object->txWaiters, 1);
+
+        /* Every released slot posts the semaphore while there are waiters */
+        while ((slot = UartDmaCC26XX_claim(handle)) == NULL) {
+            if (SemaphoreP_pend(&(object->txSpaceSem),
+                    object->params.blockTimeout) != SemaphoreP_OK) {
+                break;
+            }
+        }
+
+        Atomic_add32(&object->txWaiters, (uint32_t)-1);
+    }
+
+    if (slot == NULL) {
+        Atomic_add32(&object->stats.txDropped, 1);
+        return (NULL);
+    }
+
+    *data = hwAttrs->txSlotBuf +
+        (size_t)(slot - hwAttrs->txSlots) * hwAttrs->txSlotSize;
+
+    return (slot);
+}
+
+/*
+ *  ======== UartDmaCC26XX_tryReserve ========
+ */
+UartDmaCC26XX_TxSlot *UartDmaCC26XX_tryReserve(UartDmaCC26XX_Handle handle,
+                                               uint8_t **data)
+{
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    UartDmaCC26XX_TxSlot        *slot;
+
+    slot = UartDmaCC26XX_claim(handle);
+    if (slot != NULL) {
+        *data = hwAttrs->txSlotBuf +
+            (size_t)(slot - hwAttrs->txSlots) * hwAttrs->txSlotSize;
+    }
+
+    return (slot);
+}
+
+/*
+ *  ======== UartDmaCC26XX_commit ========
+ */
+void UartDmaCC26XX_commit(UartDmaCC26XX_Handle handle,
+                          UartDmaCC26XX_TxSlot *slot, size_t len)
+{
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+
+    if (len > hwAttrs->txSlotSize) {
+        len = hwAttrs->txSlotSize;
+    }
+
+    slot->buf     = hwAttrs->txSlotBuf +
+        (size_t)(slot - hwAttrs->txSlots) * hwAttrs->txSlotSize;
+    slot->len     = len;
+    slot->doneFxn = NULL;
+    slot->arg     = NULL;
+
+    UartDmaCC26XX_publish(handle, slot);
+}
+
+/*
+ *  ======== UartDmaCC26XX_submit ========
+ */
+bool UartDmaCC26XX_submit(UartDmaCC26XX_Handle handle, const void *buf,
+                          size_t len, UartDmaCC26XX_TxDoneFxn doneFxn,
+                          void *arg)
+{
+    UartDmaCC26XX_TxSlot *slot;
+    uint8_t              *data;
+
+    slot = UartDmaCC26XX_reserve(handle, &data);
+    if (slot == NULL) {
+        return (false);
+    }
+
+    slot->buf     = (const uint8_t *)buf;
+    slot->len     = len;
+    slot->doneFxn = doneFxn;
+    slot->arg     = arg;
+
+    UartDmaCC26XX_publish(handle, slot);
+
+    return (true);
+}
+
+/*
+ *  ======== UartDmaCC26XX_trySubmit ========
+ */
+bool UartDmaCC26XX_trySubmit(UartDmaCC26XX_Handle handle, const void *buf,
+                             size_t len, UartDmaCC26XX_TxDoneFxn doneFxn,
+                             void *arg)
+{
+    UartDmaCC26XX_TxSlot *slot;
+
+    slot = UartDmaCC26XX_claim(handle);
+    if (slot == NULL) {
+        return (false);
+    }
+
+    slot->buf     = (const uint8_t *)buf;
+    slot->len     = len;
+    slot->doneFxn = doneFxn;
+    slot->arg     = arg;
+
+    UartDmaCC26XX_publish(handle, slot);
+
+    return (true);
+}
+
+/*
+ *  ======== UartDmaCC26XX_write ========
+ */
+size_t UartDmaCC26XX_write(UartDmaCC26XX_Handle handle, const void *buf,
+                           size_t len)
+{
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    UartDmaCC26XX_TxSlot        *slot;
+    const uint8_t               *src = (const uint8_t *)buf;
+    uint8_t                     *data;
+    size_t                       count;
+    size_t                       written = 0;
+
+    while (written < len) {
+        slot = UartDmaCC26XX_reserve(handle, &data);
+        if (slot == NULL) {
+            break;
+        }
+
+        count = len - written;
+        if (count > hwAttrs->txSlotSize) {
+            count = hwAttrs->txSlotSize;
+        }
+
+        memcpy(data, src + written, count);
+        UartDmaCC26XX_commit(handle, slot, count);
+
+        written += count;
+    }
+
+    return (written);
+}
+
+/*
+ *  ======== UartDmaCC26XX_slotSize ========
+ */
+size_t UartDmaCC26XX_slotSize(UartDmaCC26XX_Handle handle)
+{
+    return (handle->hwAttrs->txSlotSize);
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxStart ========
+ */
+bool UartDmaCC26XX_rxStart(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    uintptr_t                    key;
+
+    if (hwAttrs->rxBufSize == 0) {
+        return (false);
+    }
+
+    key = HwiP_disable();
+
+    if (!object->rxRunning) {
+        object->rxHead     = 0;
+        object->rxTail     = 0;
+        object->rxDmaPos   = 0;
+        object->rxArmedEnd = 0;
+        object->rxRunning  = true;
+
+        /* The UART cannot receive in standby */
+        Power_setConstraint(PowerCC26XX_SB_DISALLOW);
+
+        /* Only full FIFO bursts are moved, the idle flush takes the rest */
+        HWREG(UDMA0_BASE + UDMA_O_SETBURST) = hwAttrs->rxChannelBitMask;
+
+        UARTRxErrorClear(hwAttrs->baseAddr);
+        UARTDMAEnable(hwAttrs->baseAddr, UART_DMA_RX);
+        UartDmaCC26XX_rxArm(handle);
+        UartDmaCC26XX_rxFlow(handle);
+    }
+
+    HwiP_restore(key);
+
+    return (true);
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxStop ========
+ */
+void UartDmaCC26XX_rxStop(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    uintptr_t                    key;
+
+    key = HwiP_disable();
+
+    if (object->rxRunning) {
+        object->rxRunning = false;
+
+        UARTIntDisable(hwAttrs->baseAddr, UART_INT_RX_DMA);
+        UARTDMADisable(hwAttrs->baseAddr, UART_DMA_RX);
+        UDMACC26XX_channelDisable(object->udmaHandle,
+                                  hwAttrs->rxChannelBitMask);
+        UDMACC26XX_clearInterrupt(object->udmaHandle,
+                                  hwAttrs->rxChannelBitMask);
+
+        UartDmaCC26XX_rxFlow(handle);
+        Power_releaseConstraint(PowerCC26XX_SB_DISALLOW);
+
+        /* Let a waiting reader see that reception has stopped */
+        SemaphoreP_post(&(object->rxSem));
+    }
+
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxIsRunning ========
+ */
+bool UartDmaCC26XX_rxIsRunning(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object *object = handle->object;
+
+    return (object->rxRunning);
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxAcquire ========
+ */
+size_t UartDmaCC26XX_rxAcquire(UartDmaCC26XX_Handle handle,
+                               const uint8_t **data, uint32_t timeout)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    uint32_t                     head;
+    uint32_t                     offset;
+    size_t                       count;
+
+    for (;;) {
+        head = object->rxHead;
+        if (head != object->rxTail || !object->rxRunning) {
+            break;
+        }
+        if (SemaphoreP_pend(&(object->rxSem), timeout) != SemaphoreP_OK) {
+            return (0);
+        }
+    }
+
+    /* Read the data only after the head that covers it, as in SpscRing.h */
+    Atomic_dmb();
+
+    offset = object->rxTail & (hwAttrs->rxBufSize - 1);
+    count  = head - object->rxTail;
+    if (count > hwAttrs->rxBufSize - offset) {
+        count = hwAttrs->rxBufSize - offset;
+    }
+
+    *data = hwAttrs->rxBuf + offset;
+
+    return (count);
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxRelease ========
+ */
+void UartDmaCC26XX_rxRelease(UartDmaCC26XX_Handle handle, size_t count)
+{
+    UartDmaCC26XX_Object *object = handle->object;
+    uintptr_t             key;
+
+    key = HwiP_disable();
+
+    object->rxTail += count;
+    if (object->rxRunning) {
+        UartDmaCC26XX_rxArm(handle);
+        UartDmaCC26XX_rxFlow(handle);
+    }
+
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxHold ========
+ */
+void UartDmaCC26XX_rxHold(UartDmaCC26XX_Handle handle, bool hold)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    handle->object->rxHold = hold;
+    UartDmaCC26XX_rxFlow(handle);
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== UartDmaCC26XX_getStats ========
+ */
+void UartDmaCC26XX_getStats(UartDmaCC26XX_Handle handle,
+                            UartDmaCC26XX_Stats *stats)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    *stats = handle->object->stats;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== UartDmaCC26XX_claim ========
+ *  Claim the slot at the enqueue position.
+ *
+ *  Slot i of an N slot queue holds sequence number p when it is free for
+ *  the producer that claims position p, and p + 1 once that producer has
+ *  committed it. The consumer sets it to p + N when it is done with it.
+ */
+static UartDmaCC26XX_TxSlot *UartDmaCC26XX_claim(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    UartDmaCC26XX_TxSlot        *slot;
+    uint32_t                     mask = hwAttrs->txSlotCount - 1;
+    uint32_t                     pos;
+    int32_t                      diff;
+
+    pos = object->txEnqPos;
+
+    for (;;) {
+        slot = &hwAttrs->txSlots[pos & mask];
+        diff = (int32_t)(slot->seq - pos);
+
+        if (diff == 0) {
+            if (Atomic_cas32(&object->txEnqPos, pos, pos + 1)) {
+                slot->pos = pos;
+                Atomic_max32(&object->stats.txHighWater,
+                             pos + 1 - object->txDeqPos);
+                return (slot);
+            }
+        }
+        else if (diff < 0) {
+            /* The consumer has not released this slot yet: queue is full */
+            return (NULL);
+        }
+
+        pos = object->txEnqPos;
+    }
+}
+
+/*
+ *  ======== UartDmaCC26XX_publish ========
+ */
+static void UartDmaCC26XX_publish(UartDmaCC26XX_Handle handle,
+                                  UartDmaCC26XX_TxSlot *slot)
+{
+    /* Slot contents must be visible before the sequence number */
+    Atomic_dmb();
+    slot->seq = slot->pos + 1;
+
+    WorkQueue_post(&(handle->object->drainWork));
+}
+
+/*
+ *  ======== UartDmaCC26XX_txStart ========
+ *  Start the next committed slot if the uDMA is idle. Called from the UART
+ *  Hwi or with Hwis disabled.
+ */
+static void UartDmaCC26XX_txStart(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    UartDmaCC26XX_TxSlot        *slot;
+    uint32_t                     mask = hwAttrs->txSlotCount - 1;
+
+    if (object->txActive != NULL) {
+        return;
+    }
+
+    for (;;) {
+        slot = &hwAttrs->txSlots[object->txDeqPos & mask];
+
+        if (slot->seq != object->txDeqPos + 1) {
+            /* Next slot in order is free or still being filled */
+            return;
+        }
+        if (slot->len != 0) {
+            break;
+        }
+
+        UartDmaCC26XX_txRelease(handle, slot);
+    }
+
+    object->txActive    = slot;
+    object->txPtr       = slot->buf;
+    object->txRemaining = slot->len;
+
+    ClockP_stop(&(object->txIdleClock));
+    if (!object->txConstraint) {
+        Power_setConstraint(PowerCC26XX_SB_DISALLOW);
+        object->txConstraint = true;
+    }
+
+    UartDmaCC26XX_txDmaNext(handle);
+}
+
+/*
+ *  ======== UartDmaCC26XX_txDmaNext ========
+ */
+static void UartDmaCC26XX_txDmaNext(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    volatile tDMAControlTable   *entry = hwAttrs->dmaTxControlTableEntry;
+    size_t                       count;
+
+    count = object->txRemaining;
+    if (count > UartDmaCC26XX_MAX_DMA_TRANSFER) {
+        count = UartDmaCC26XX_MAX_DMA_TRANSFER;
+    }
+
+    entry->ui32Control = UDMA_MODE_BASIC | UDMA_SIZE_8 | UDMA_SRC_INC_8 |
+                         UDMA_DST_INC_NONE | UDMA_ARB_8 |
+                         UDMACC26XX_SET_TRANSFER_SIZE(count);
+    entry->pvSrcEndAddr = (void *)(object->txPtr + count - 1);
+    entry->pvDstEndAddr = (void *)(hwAttrs->baseAddr + UART_O_DR);
+
+    object->txPtr       += count;
+    object->txRemaining -= count;
+    object->stats.txBytes += count;
+
+    UDMACC26XX_channelEnable(object->udmaHandle, hwAttrs->txChannelBitMask);
+}
+
+/*
+ *  ======== UartDmaCC26XX_txRelease ========
+ */
+static void UartDmaCC26XX_txRelease(UartDmaCC26XX_Handle handle,
+                                    UartDmaCC26XX_TxSlot *slot)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+
+    if (slot->doneFxn != NULL) {
+        slot->doneFxn(handle, slot->arg);
+    }
+
+    Atomic_dmb();
+    slot->seq = slot->pos + hwAttrs->txSlotCount;
+    object->txDeqPos++;
+
+    if (object->txWaiters != 0) {
+        SemaphoreP_post(&(object->txSpaceSem));
+    }
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxArm ========
+ *  Give every fully released half of the receive buffer to the uDMA. Called
+ *  from the UART Hwi or with Hwis disabled.
+ *
+ *  Buffer positions are free running byte counts. rxDmaPos is the start of
+ *  the half the uDMA is filling and rxArmedEnd the end of the last half
+ *  handed to it, so rxDmaPos == rxArmedEnd means the uDMA has stopped.
+ */
+static void UartDmaCC26XX_rxArm(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    volatile tDMAControlTable   *entry;
+    uint32_t                     half = hwAttrs->rxBufSize / 2;
+    bool                         stopped;
+
+    /* The previous contents of the next half must have been released */
+    while (object->rxArmedEnd - object->rxTail <= half) {
+        stopped = (object->rxArmedEnd == object->rxDmaPos);
+
+        entry = (object->rxArmedEnd & half) ?
+            hwAttrs->dmaRxAltControlTableEntry :
+            hwAttrs->dmaRxControlTableEntry;
+
+        entry->pvSrcEndAddr = (void *)(hwAttrs->baseAddr + UART_O_DR);
+        entry->pvDstEndAddr = (void *)(hwAttrs->rxBuf +
+            (object->rxArmedEnd & (hwAttrs->rxBufSize - 1)) + half - 1);
+        entry->ui32Control  = UDMA_MODE_PINGPONG | UDMA_SIZE_8 |
+                              UDMA_SRC_INC_NONE | UDMA_DST_INC_8 |
+                              UDMA_ARB_16 |
+                              UDMACC26XX_SET_TRANSFER_SIZE(half);
+
+        object->rxArmedEnd += half;
+
+        if (stopped) {
+            UartDmaCC26XX_rxKick(handle);
+        }
+    }
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxKick ========
+ *  (Re)start the receive channel on the half at rxDmaPos.
+ */
+static void UartDmaCC26XX_rxKick(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+
+    if (object->rxDmaPos & (hwAttrs->rxBufSize / 2)) {
+        HWREG(UDMA0_BASE + UDMA_O_SETCHNLPRIALT) = hwAttrs->rxChannelBitMask;
+    }
+    else {
+        HWREG(UDMA0_BASE + UDMA_O_CLEARCHNLPRIALT) = hwAttrs->rxChannelBitMask;
+    }
+
+    /* Bytes that did not fit while the uDMA was stopped are gone */
+    if (UARTRxErrorGet(hwAttrs->baseAddr) & UART_RXERROR_OVERRUN) {
+        object->stats.rxOverruns++;
+        UARTRxErrorClear(hwAttrs->baseAddr);
+    }
+
+    UDMACC26XX_channelEnable(object->udmaHandle, hwAttrs->rxChannelBitMask);
+    UARTIntClear(hwAttrs->baseAddr, UART_INT_RX_DMA);
+    UARTIntEnable(hwAttrs->baseAddr, UART_INT_RX_DMA);
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxFlow ========
+ *  Drive RTS (active low) from the amount of unread data. Called from the
+ *  UART Hwi or with Hwis disabled.
+ */
+static void UartDmaCC26XX_rxFlow(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    uint32_t                     unread;
+    bool                         ready;
+
+    if (hwAttrs->rtsPin == PIN_UNASSIGNED) {
+        return;
+    }
+
+    unread = object->rxHead - object->rxTail;
+
+    if (!object->rxRunning || object->rxHold ||
+        unread >= hwAttrs->rxBufSize / 2) {
+        ready = false;
+    }
+    else if (unread <= hwAttrs->rxBufSize / 4) {
+        ready = true;
+    }
+    else {
+        /* Between the watermarks: keep the current state */
+        return;
+    }
+
+    if (ready != object->rtsAsserted) {
+        object->rtsAsserted = ready;
+        if (!ready) {
+            object->stats.rxThrottled++;
+        }
+        PIN_setOutputValue(object->pinHandle, hwAttrs->rtsPin, !ready);
+    }
+}
+
+/*
+ *  ======== UartDmaCC26XX_rxService ========
+ *  Account for completed halves and, on a receive timeout, for the bytes
+ *  received so far. Called from the UART Hwi.
+ */
+static void UartDmaCC26XX_rxService(UartDmaCC26XX_Handle handle, bool idle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    volatile tDMAControlTable   *entry;
+    uint32_t                     half = hwAttrs->rxBufSize / 2;
+    uint32_t                     mask = hwAttrs->rxChannelBitMask;
+    uint32_t                     head;
+
+    if (idle) {
+        /*
+         * Fewer bytes than a burst are left in the FIFO. Let the uDMA take
+         * them on single requests, then go back to bursts.
+         */
+        HWREG(UDMA0_BASE + UDMA_O_CLEARBURST) = mask;
+        while (!(HWREG(hwAttrs->baseAddr + UART_O_FR) & UART_FR_RXFE) &&
+               (HWREG(UDMA0_BASE + UDMA_O_SETCHANNELEN) & mask)) {
+            ;
+        }
+        HWREG(UDMA0_BASE + UDMA_O_SETBURST) = mask;
+    }
+
+    /* A finished control table entry has its mode reset to stop */
+    head = object->rxHead;
+    while (object->rxDmaPos != object->rxArmedEnd) {
+        entry = (object->rxDmaPos & half) ?
+            hwAttrs->dmaRxAltControlTableEntry :
+            hwAttrs->dmaRxControlTableEntry;
+
+        if ((entry->ui32Control & DMA_MODE_MASK) != UDMA_MODE_STOP) {
+            if (idle) {
+                head = object->rxDmaPos + half -
+                    DMA_XFERSIZE(entry->ui32Control);
+            }
+            break;
+        }
+
+        object->rxDmaPos += half;
+        head = object->rxDmaPos;
+    }
+
+    if (object->rxDmaPos == object->rxArmedEnd) {
+        /* Out of buffer: the FIFO fills up until the reader catches up */
+        object->stats.rxStalls++;
+        UARTIntDisable(hwAttrs->baseAddr, UART_INT_RX_DMA);
+    }
+    else if (!(HWREG(UDMA0_BASE + UDMA_O_SETCHANNELEN) & mask)) {
+        /* The next half was armed just after the uDMA gave up on it */
+        UartDmaCC26XX_rxKick(handle);
+    }
+
+    if (head != object->rxHead) {
+        object->stats.rxBytes += head - object->rxHead;
+        object->rxHead = head;
+        UartDmaCC26XX_rxFlow(handle);
+        SemaphoreP_post(&(object->rxSem));
+    }
+}
+
+/*
+ *  ======== UartDmaCC26XX_hwiFxn ========
+ */
+static void UartDmaCC26XX_hwiFxn(uintptr_t arg)
+{
+    UartDmaCC26XX_Handle         handle = (UartDmaCC26XX_Handle)arg;
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    UartDmaCC26XX_TxSlot        *slot;
+    uint32_t                     status;
+    bool                         rxDone;
+    Prof_BEGIN(start);
+
+    status = UARTIntStatus(hwAttrs->baseAddr, true);
+    UARTIntClear(hwAttrs->baseAddr, status);
+
+    if (UDMACC26XX_channelDone(object->udmaHandle,
+                               hwAttrs->txChannelBitMask)) {
+        UDMACC26XX_clearInterrupt(object->udmaHandle,
+                                  hwAttrs->txChannelBitMask);
+
+        if (object->txRemaining != 0) {
+            UartDmaCC26XX_txDmaNext(handle);
+        }
+        else if (object->txActive != NULL) {
+            slot = object->txActive;
+            object->txActive = NULL;
+            object->stats.txMessages++;
+
+            UartDmaCC26XX_txRelease(handle, slot);
+            UartDmaCC26XX_txStart(handle);
+
+            if (object->txActive == NULL) {
+                /* Queue drained, give the FIFO time to empty */
+                ClockP_start(&(object->txIdleClock));
+            }
+        }
+    }
+
+    if (object->rxRunning) {
+        rxDone = UDMACC26XX_channelDone(object->udmaHandle,
+                                        hwAttrs->rxChannelBitMask);
+        if (rxDone) {
+            UDMACC26XX_clearInterrupt(object->udmaHandle,
+                                      hwAttrs->rxChannelBitMask);
+        }
+
+        if (rxDone || (status & UART_INT_RX_DMA)) {
+            object->stats.rxInterrupts++;
+            if (status & UART_INT_RT) {
+                object->stats.rxIdle++;
+            }
+            if (status & UART_INT_OE) {
+                object->stats.rxOverruns++;
+            }
+
+            UartDmaCC26XX_rxService(handle, (status & UART_INT_RT) != 0);
+        }
+    }
+
+    Prof_END(ProfSite_UART_HWI, start);
+}
+
+/*
+ *  ======== UartDmaCC26XX_drainFxn ========
+ *  Low priority drain, posted by every commit and run by the WorkQueue.
+ */
+static void UartDmaCC26XX_drainFxn(uintptr_t arg)
+{
+    uintptr_t key;
+    Prof_BEGIN(start);
+
+    key = HwiP_disable();
+    UartDmaCC26XX_txStart((UartDmaCC26XX_Handle)arg);
+    HwiP_restore(key);
+
+    Prof_END(ProfSite_UART_DRAIN, start);
+}
+
+/*
+ *  ======== UartDmaCC26XX_txIdleFxn ========
+ *  Allow standby again once the transmitter has gone quiet.
+ */
+static void UartDmaCC26XX_txIdleFxn(uintptr_t arg)
+{
+    UartDmaCC26XX_Handle  handle = (UartDmaCC26XX_Handle)arg;
+    UartDmaCC26XX_Object *object = handle->object;
+    uintptr_t             key;
+
+    key = HwiP_disable();
+
+    if (object->txActive == NULL && object->txConstraint) {
+        if (UARTBusy(handle->hwAttrs->baseAddr)) {
+            ClockP_start(&(object->txIdleClock));
+        }
+        else {
+            Power_releaseConstraint(PowerCC26XX_SB_DISALLOW);
+            object->txConstraint = false;
+        }
+    }
+
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== UartDmaCC26XX_postNotifyFxn ========
+ */
+static int UartDmaCC26XX_postNotifyFxn(unsigned int eventType,
+                                       uintptr_t eventArg,
+                                       uintptr_t clientArg)
+{
+    UartDmaCC26XX_initHw((UartDmaCC26XX_Handle)clientArg);
+
+    return (Power_NOTIFYDONE);
+}
+
+/*
+ *  ======== UartDmaCC26XX_initHw ========
+ */
+static void UartDmaCC26XX_initHw(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    ClockP_FreqHz                freq;
+
+    UARTDisable(hwAttrs->baseAddr);
+
+    ClockP_getCpuFreq(&freq);
+    UARTConfigSetExpClk(hwAttrs->baseAddr, freq.lo,
+                        handle->object->params.baudRate,
+                        UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE |
+                        UART_CONFIG_PAR_NONE);
+
+    /* A half full receive FIFO is one UDMA_ARB_16 burst */
+    UARTFIFOLevelSet(hwAttrs->baseAddr, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+    UARTIntClear(hwAttrs->baseAddr, UART_INT_ALL);
+    UARTDMAEnable(hwAttrs->baseAddr, UART_DMA_TX);
+
+    /* RTS is a GPIO driven from the receive buffer, CTS is left to the UART */
+    if (hwAttrs->ctsPin != PIN_UNASSIGNED) {
+        HWREG(hwAttrs->baseAddr + UART_O_CTL) |= UART_CTL_CTSEN;
+    }
+
+    UARTEnable(hwAttrs->baseAddr);
+}
+
+/*
+ *  ======== UartDmaCC26XX_openPins ========
+ */
+static bool UartDmaCC26XX_openPins(UartDmaCC26XX_Handle handle)
+{
+    UartDmaCC26XX_Object        *object = handle->object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs = handle->hwAttrs;
+    PIN_Config                   pinTable[5];
+    uint32_t                     i = 0;
+
+    pinTable[i++] = hwAttrs->rxPin | PIN_INPUT_EN;
+    pinTable[i++] = hwAttrs->txPin | PIN_INPUT_DIS | PIN_PUSHPULL |
+                    PIN_GPIO_OUTPUT_EN | PIN_GPIO_HIGH;
+    if (hwAttrs->ctsPin != PIN_UNASSIGNED) {
+        pinTable[i++] = hwAttrs->ctsPin | PIN_INPUT_EN;
+    }
+    if (hwAttrs->rtsPin != PIN_UNASSIGNED) {
+        /* Deasserted until reception is started */
+        pinTable[i++] = hwAttrs->rtsPin | PIN_INPUT_DIS | PIN_PUSHPULL |
+                        PIN_GPIO_OUTPUT_EN | PIN_GPIO_HIGH;
+    }
+    pinTable[i] = PIN_TERMINATE;
+
+    object->pinHandle = PIN_open(&object->pinState, pinTable);
+    if (object->pinHandle == NULL) {
+        return (false);
+    }
+
+    PINCC26XX_setMux(object->pinHandle, hwAttrs->rxPin,
+                     IOC_PORT_MCU_UART0_RX);
+    PINCC26XX_setMux(object->pinHandle, hwAttrs->txPin,
+                     IOC_PORT_MCU_UART0_TX);
+    if (hwAttrs->ctsPin != PIN_UNASSIGNED) {
+        PINCC26XX_setMux(object->pinHandle, hwAttrs->ctsPin,
+                         IOC_PORT_MCU_UART0_CTS);
+    }
+
+    return (true);
+}
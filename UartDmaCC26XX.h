@@ -0,0 +1,441 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       UartDmaCC26XX.h
+ *
+ *  @brief      uDMA driven UART driver for CC26XX/CC13XX devices.
+ *
+ *  The stock UARTCC26XX driver moves every byte through the UART interrupt
+ *  and blocks the writer until the last byte has left the FIFO. This driver
+ *  instead queues complete messages and lets the uDMA move them into the
+ *  UART, so a writer only pays for filling a buffer.
+ *
+ *  # Transmit queue #
+ *  Transmission is organized as a queue of fixed size slots. Any number of
+ *  producers (Tasks, Swis or Hwis) may reserve a slot, fill it and commit it
+ *  without taking a lock: slots are claimed with a compare-and-swap on the
+ *  enqueue position and handed over with a per-slot sequence number. A
+ *  WorkQueue item, run by the shared low priority worker Swi, drains
+ *  committed slots in order and programs one uDMA transfer per slot; the
+ *  commits of a burst post it once. WorkQueue_init() must have been called
+ *  before the first UartDmaCC26XX_open(). Completion of a transfer starts
+ *  the next one directly from the UART interrupt.
+ *
+ *  When the queue is full the behavior depends on
+ *  UartDmaCC26XX_Params.overflowPolicy. Dropped messages are counted and can
+ *  be read back with UartDmaCC26XX_getStats().
+ *
+ *  # Receive #
+ *  Reception is optional and started with UartDmaCC26XX_rxStart(). The uDMA
+ *  runs in ping-pong mode and fills the two halves of the board supplied
+ *  receive buffer, so the CPU is interrupted once per half instead of once
+ *  per FIFO threshold. Bytes that are still in the FIFO when the line goes
+ *  idle are flushed by the UART receive timeout, which makes a frame
+ *  available to the reader as soon as the sender pauses.
+ *
+ *  Received data is not copied out of the buffer. The reader gets a pointer
+ *  into it with UartDmaCC26XX_rxAcquire() and hands the bytes back with
+ *  UartDmaCC26XX_rxRelease(). A half is only given back to the uDMA once it
+ *  has been released completely; while the reader is behind the uDMA stops
+ *  and the UART FIFO absorbs up to 32 more bytes before an overrun is
+ *  counted.
+ *
+ *  @code
+ *  const uint8_t *data;
+ *  size_t count;
+ *
+ *  UartDmaCC26XX_rxStart(handle);
+ *  while (1) {
+ *      count = UartDmaCC26XX_rxAcquire(handle, &data, SemaphoreP_WAIT_FOREVER);
+ *      parse(data, count);
+ *      UartDmaCC26XX_rxRelease(handle, count);
+ *  }
+ *  @endcode
+ *
+ *  # Flow control #
+ *  Flow control is used when the board assigns @p ctsPin and @p rtsPin.
+ *  CTS is handled by the UART itself: the transmitter pauses between bytes
+ *  while CTS is deasserted, so the transmit queue simply drains later.
+ *
+ *  RTS is driven by the driver from the fill level of the receive buffer
+ *  rather than from the UART FIFO. It is deasserted once half of the buffer
+ *  holds unread data and asserted again when the reader is down to a
+ *  quarter, so the sender is stopped while the uDMA still has a full half
+ *  to write into. Code that is about to stall the CPU for a long time, for
+ *  example with a flash erase, can hold RTS deasserted around it with
+ *  UartDmaCC26XX_rxHold().
+ *
+ *  @code
+ *  UartDmaCC26XX_Params params;
+ *  UartDmaCC26XX_Handle handle;
+ *  UartDmaCC26XX_TxSlot *slot;
+ *  uint8_t *data;
+ *
+ *  UartDmaCC26XX_Params_init(&params);
+ *  handle = UartDmaCC26XX_open(Board_UART0, &params);
+ *
+ *  slot = UartDmaCC26XX_reserve(handle, &data);
+ *  if (slot != NULL) {
+ *      data[0] = 'A';
+ *      UartDmaCC26XX_commit(handle, slot, 1);
+ *  }
+ *  @endcode
+ *
+ *  The driver takes over the UART peripheral. It must not be opened at the
+ *  same time as the UART driver instance that maps to the same peripheral.
+ *
+ *  ============================================================================
+ */
+#ifndef __UARTDMACC26XX_H__
+#define __UARTDMACC26XX_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/Power.h>
+#include <ti/drivers/PIN.h>
+#include <ti/drivers/dma/UDMACC26XX.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "WorkQueue.h"
+
+/*! Largest number of bytes the uDMA moves in a single transfer */
+#define UartDmaCC26XX_MAX_DMA_TRANSFER    1024
+
+/*! Longest wait of UartDmaCC26XX_close() for the transmit queue to drain */
+#ifndef UartDmaCC26XX_CLOSE_TIMEOUT_MS
+#define UartDmaCC26XX_CLOSE_TIMEOUT_MS    500
+#endif
+
+/*!
+ *  @brief  What a producer does when no transmit slot is free
+ */
+typedef enum UartDmaCC26XX_OverflowPolicy {
+    /*! Return immediately and count the message as dropped */
+    UartDmaCC26XX_OVERFLOW_DROP = 0,
+    /*!
+     *  Wait up to UartDmaCC26XX_Params.blockTimeout for a slot. Callers in
+     *  Hwi or Swi context never wait and fall back to dropping.
+     */
+    UartDmaCC26XX_OVERFLOW_BLOCK
+} UartDmaCC26XX_OverflowPolicy;
+
+/*!
+ *  @brief  A UartDmaCC26XX_Handle is returned by UartDmaCC26XX_open()
+ */
+typedef const struct UartDmaCC26XX_Config *UartDmaCC26XX_Handle;
+
+/*!
+ *  @brief  Called from Hwi context once a submitted buffer has been sent
+ */
+typedef void (*UartDmaCC26XX_TxDoneFxn)(UartDmaCC26XX_Handle handle,
+                                        void *arg);
+
+/*!
+ *  @brief  Transmit queue entry
+ *
+ *  The board file allocates an array of these per UART. The fields are
+ *  private to the driver.
+ */
+typedef struct UartDmaCC26XX_TxSlot {
+    volatile uint32_t        seq;
+    uint32_t                 pos;
+    const uint8_t           *buf;
+    size_t                   len;
+    UartDmaCC26XX_TxDoneFxn  doneFxn;
+    void                    *arg;
+} UartDmaCC26XX_TxSlot;
+
+/*!
+ *  @brief  Parameters passed to UartDmaCC26XX_open()
+ */
+typedef struct UartDmaCC26XX_Params {
+    uint32_t                     baudRate;       /*!< Baud rate */
+    UartDmaCC26XX_OverflowPolicy overflowPolicy; /*!< Full queue behavior */
+    uint32_t                     blockTimeout;   /*!< Wait for a slot, in
+                                                      system clock ticks */
+} UartDmaCC26XX_Params;
+
+/*!
+ *  @brief  Transfer counters, see UartDmaCC26XX_getStats()
+ */
+typedef struct UartDmaCC26XX_Stats {
+    uint32_t txBytes;      /*!< Bytes handed to the uDMA */
+    uint32_t txMessages;   /*!< Slots transmitted */
+    uint32_t txDropped;    /*!< Messages lost to a full queue or close */
+    uint32_t txBlocked;    /*!< Producers that had to wait for a slot */
+    uint32_t txHighWater;  /*!< Largest number of slots in use */
+    uint32_t rxBytes;      /*!< Bytes received */
+    uint32_t rxIdle;       /*!< Receive timeouts (idle line) */
+    uint32_t rxInterrupts; /*!< Interrupts taken for reception */
+    uint32_t rxStalls;     /*!< Times the uDMA ran out of released buffer */
+    uint32_t rxOverruns;   /*!< Receive FIFO overruns */
+    uint32_t rxThrottled;  /*!< Times RTS was deasserted */
+} UartDmaCC26XX_Stats;
+
+/*!
+ *  @brief  UartDmaCC26XX hardware attributes
+ *
+ *  The transmit queue storage is provided by the board file:
+ *  @p txSlots holds @p txSlotCount entries and @p txSlotBuf holds
+ *  @p txSlotCount * @p txSlotSize bytes. @p txSlotCount must be a power of
+ *  two.
+ *
+ *  The receive buffer @p rxBuf is split into two halves that are filled by
+ *  the primary and alternate control table entries of the receive channel.
+ *  @p rxBufSize must be a power of two and at most twice
+ *  UartDmaCC26XX_MAX_DMA_TRANSFER. It may be 0 for transmit only instances.
+ */
+typedef struct UartDmaCC26XX_HWAttrs {
+    uint32_t                  baseAddr;         /*!< UART peripheral base */
+    int                       powerMngrId;      /*!< UART power resource */
+    int                       intNum;           /*!< UART interrupt */
+    uint8_t                   intPriority;      /*!< Hwi priority */
+    uint8_t                   txPin;            /*!< UART TX pin */
+    uint8_t                   rxPin;            /*!< UART RX pin */
+    uint8_t                   ctsPin;           /*!< UART CTS pin or
+                                                     PIN_UNASSIGNED */
+    uint8_t                   rtsPin;           /*!< UART RTS pin or
+                                                     PIN_UNASSIGNED */
+    uint32_t                  txChannelBitMask; /*!< uDMA TX channel mask */
+    volatile tDMAControlTable *dmaTxControlTableEntry;
+    UartDmaCC26XX_TxSlot     *txSlots;          /*!< Queue entries */
+    uint8_t                  *txSlotBuf;        /*!< Queue data storage */
+    uint16_t                  txSlotCount;      /*!< Entries, power of two */
+    uint16_t                  txSlotSize;       /*!< Bytes per entry */
+    uint32_t                  rxChannelBitMask; /*!< uDMA RX channel mask */
+    volatile tDMAControlTable *dmaRxControlTableEntry;
+    volatile tDMAControlTable *dmaRxAltControlTableEntry;
+    uint8_t                  *rxBuf;            /*!< Receive buffer */
+    uint16_t                  rxBufSize;        /*!< Bytes, power of two */
+} UartDmaCC26XX_HWAttrs;
+
+/*!
+ *  @brief  UartDmaCC26XX object
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct UartDmaCC26XX_Object {
+    HwiP_Struct              hwi;
+    WorkQueue_Item           drainWork;
+    ClockP_Struct            txIdleClock;
+    SemaphoreP_Struct        txSpaceSem;
+    SemaphoreP_Struct        rxSem;
+    PIN_State                pinState;
+    PIN_Handle               pinHandle;
+    UDMACC26XX_Handle        udmaHandle;
+    Power_NotifyObj          postNotify;
+    UartDmaCC26XX_Params     params;
+
+    volatile uint32_t        txEnqPos;
+    uint32_t                 txDeqPos;
+    UartDmaCC26XX_TxSlot    *txActive;
+    const uint8_t           *txPtr;
+    size_t                   txRemaining;
+    uint32_t                 txDrainTicks;
+    volatile uint32_t        txWaiters;
+    bool                     txConstraint;
+
+    volatile uint32_t        rxHead;
+    volatile uint32_t        rxTail;
+    uint32_t                 rxDmaPos;
+    uint32_t                 rxArmedEnd;
+    bool                     rxRunning;
+    bool                     rxHold;
+    bool                     rtsAsserted;
+
+    bool                     isOpen;
+
+    UartDmaCC26XX_Stats      stats;
+} UartDmaCC26XX_Object;
+
+/*!
+ *  @brief  UartDmaCC26XX global configuration
+ */
+typedef struct UartDmaCC26XX_Config {
+    UartDmaCC26XX_Object        *object;
+    UartDmaCC26XX_HWAttrs const *hwAttrs;
+} UartDmaCC26XX_Config;
+
+extern const UartDmaCC26XX_Config UartDmaCC26XX_config[];
+extern const uint_least8_t UartDmaCC26XX_count;
+
+/*!
+ *  @brief  Initialize a UartDmaCC26XX_Params structure to its defaults
+ *
+ *  Defaults are 115200 baud and UartDmaCC26XX_OVERFLOW_DROP.
+ */
+extern void UartDmaCC26XX_Params_init(UartDmaCC26XX_Params *params);
+
+/*!
+ *  @brief  Open a UART instance and take ownership of its peripheral
+ *
+ *  @return A handle on success or NULL on error or if already open.
+ */
+extern UartDmaCC26XX_Handle UartDmaCC26XX_open(uint_least8_t index,
+                                               UartDmaCC26XX_Params *params);
+
+/*!
+ *  @brief  Get the handle of an instance that is already open
+ *
+ *  Lets several users share one UART, for example a display and a logger.
+ *
+ *  @return The handle, or NULL if the instance is not open.
+ */
+extern UartDmaCC26XX_Handle UartDmaCC26XX_getHandle(uint_least8_t index);
+
+/*!
+ *  @brief  Wait for queued data to drain and close the instance
+ *
+ *  Waits at most UartDmaCC26XX_CLOSE_TIMEOUT_MS. Slots that have not gone
+ *  out by then, such as slots reserved but never committed or held off by
+ *  CTS, are dropped and counted in UartDmaCC26XX_Stats.txDropped.
+ */
+extern void UartDmaCC26XX_close(UartDmaCC26XX_Handle handle);
+
+/*!
+ *  @brief  Claim a transmit slot
+ *
+ *  @param  handle  UART handle
+ *  @param  data    Receives a pointer to the txSlotSize bytes of the slot
+ *
+ *  @return The slot, or NULL if the queue is full. Every reserved slot must
+ *          be handed back with UartDmaCC26XX_commit(), otherwise the queue
+ *          stalls behind it.
+ */
+extern UartDmaCC26XX_TxSlot *UartDmaCC26XX_reserve(UartDmaCC26XX_Handle handle,
+                                                   uint8_t **data);
+
+/*!
+ *  @brief  Claim a transmit slot if one is free, from any context
+ *
+ *  Like UartDmaCC26XX_reserve(), but never blocks and does not count a full
+ *  queue in txDropped, for callers that retry or count their own losses.
+ */
+extern UartDmaCC26XX_TxSlot *UartDmaCC26XX_tryReserve(
+    UartDmaCC26XX_Handle handle, uint8_t **data);
+
+/*!
+ *  @brief  Queue a reserved slot for transmission
+ *
+ *  @param  len  Number of bytes written to the slot data; 0 releases the
+ *               slot without sending anything.
+ */
+extern void UartDmaCC26XX_commit(UartDmaCC26XX_Handle handle,
+                                 UartDmaCC26XX_TxSlot *slot, size_t len);
+
+/*!
+ *  @brief  Queue a caller owned buffer for transmission without copying it
+ *
+ *  @p buf must stay valid until @p doneFxn is called. Buffers larger than
+ *  UartDmaCC26XX_MAX_DMA_TRANSFER are split into several transfers.
+ *
+ *  @return true if the buffer was queued.
+ */
+extern bool UartDmaCC26XX_submit(UartDmaCC26XX_Handle handle, const void *buf,
+                                 size_t len, UartDmaCC26XX_TxDoneFxn doneFxn,
+                                 void *arg);
+
+/*!
+ *  @brief  Queue a caller owned buffer if a slot is free, from any context
+ *
+ *  Like UartDmaCC26XX_submit(), but never blocks and does not count a full
+ *  queue in txDropped.
+ *
+ *  @return true if the buffer was queued.
+ */
+extern bool UartDmaCC26XX_trySubmit(UartDmaCC26XX_Handle handle,
+                                    const void *buf, size_t len,
+                                    UartDmaCC26XX_TxDoneFxn doneFxn,
+                                    void *arg);
+
+/*!
+ *  @brief  Copy @p len bytes into as many slots as needed and queue them
+ *
+ *  @return Number of bytes queued.
+ */
+extern size_t UartDmaCC26XX_write(UartDmaCC26XX_Handle handle, const void *buf,
+                                  size_t len);
+
+/*!
+ *  @brief  Size in bytes of each transmit slot
+ */
+extern size_t UartDmaCC26XX_slotSize(UartDmaCC26XX_Handle handle);
+
+/*!
+ *  @brief  Start receiving into the board supplied receive buffer
+ *
+ *  Standby is disallowed while reception runs.
+ *
+ *  @return false if the instance has no receive buffer.
+ */
+extern bool UartDmaCC26XX_rxStart(UartDmaCC26XX_Handle handle);
+
+/*!
+ *  @brief  Stop receiving and discard unread data
+ */
+extern void UartDmaCC26XX_rxStop(UartDmaCC26XX_Handle handle);
+
+/*!
+ *  @brief  Tell a timeout of UartDmaCC26XX_rxAcquire() from a stop
+ *
+ *  @return true while reception runs.
+ */
+extern bool UartDmaCC26XX_rxIsRunning(UartDmaCC26XX_Handle handle);
+
+/*!
+ *  @brief  Wait for received data
+ *
+ *  Only one reader may use an instance at a time.
+ *
+ *  @param  handle   UART handle
+ *  @param  data     Receives a pointer to the oldest unreleased byte
+ *  @param  timeout  Wait in system clock ticks, 0 to poll
+ *
+ *  @return Number of contiguous bytes at @p data, 0 on timeout. More data
+ *          may follow at the start of the buffer once these are released.
+ */
+extern size_t UartDmaCC26XX_rxAcquire(UartDmaCC26XX_Handle handle,
+                                      const uint8_t **data, uint32_t timeout);
+
+/*!
+ *  @brief  Hand @p count bytes obtained with UartDmaCC26XX_rxAcquire() back
+ *          to the driver
+ */
+extern void UartDmaCC26XX_rxRelease(UartDmaCC26XX_Handle handle, size_t count);
+
+/*!
+ *  @brief  Keep RTS deasserted regardless of the receive buffer level
+ *
+ *  The uDMA keeps receiving whatever the sender had in flight. Has no
+ *  effect without flow control.
+ *
+ *  @param  hold  true to stop the sender, false to return to the buffer
+ *                watermarks
+ */
+extern void UartDmaCC26XX_rxHold(UartDmaCC26XX_Handle handle, bool hold);
+
+/*!
+ *  @brief  Copy the transfer counters into @p stats
+ */
+extern void UartDmaCC26XX_getStats(UartDmaCC26XX_Handle handle,
+                                   UartDmaCC26XX_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UARTDMACC26XX_H__ */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== WorkQueue.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SwiP.h>
+
+#include "Atomic.h"
+#include "WorkQueue.h"
+
+static SwiP_Struct     WorkQueue_swi;
+static bool            WorkQueue_initialized;
+
+/* Protected by HwiP_disable() */
+static WorkQueue_Item *WorkQueue_head;
+static WorkQueue_Item *WorkQueue_tail;
+static bool            WorkQueue_running;
+static uint32_t        WorkQueue_posts;
+static uint32_t        WorkQueue_coalesced;
+
+/* Written by the worker only */
+static uint32_t        WorkQueue_runs;
+static uint32_t        WorkQueue_items;
+static uint32_t        WorkQueue_maxBatch;
+
+static void WorkQueue_swiFxn(uintptr_t arg0, uintptr_t arg1);
+
+/*
+ *  ======== WorkQueue_init ========
+ */
+void WorkQueue_init(void)
+{
+    SwiP_Params swiParams;
+
+    if (WorkQueue_initialized) {
+        return;
+    }
+
+    SwiP_Params_init(&swiParams);
+    swiParams.priority = WorkQueue_SWI_PRIORITY;
+    SwiP_construct(&WorkQueue_swi, WorkQueue_swiFxn, &swiParams);
+
+    WorkQueue_initialized = true;
+}
+
+/*
+ *  ======== WorkQueue_Item_init ========
+ */
+void WorkQueue_Item_init(WorkQueue_Item *item, WorkQueue_Fxn fxn,
+                         uintptr_t arg)
+{
+    item->next   = NULL;
+    item->fxn    = fxn;
+    item->arg    = arg;
+    item->queued = false;
+}
+
+/*
+ *  ======== WorkQueue_post ========
+ */
+bool WorkQueue_post(WorkQueue_Item *item)
+{
+    uintptr_t key;
+    bool      wake;
+
+    key = HwiP_disable();
+
+    WorkQueue_posts++;
+    if (item->queued) {
+        WorkQueue_coalesced++;
+        HwiP_restore(key);
+        return (false);
+    }
+
+    item->queued = true;
+    item->next   = NULL;
+    if (WorkQueue_tail == NULL) {
+        WorkQueue_head = item;
+    }
+    else {
+        WorkQueue_tail->next = item;
+    }
+    WorkQueue_tail = item;
+
+    /* A running worker picks the item up before it returns */
+    wake = (WorkQueue_head == item) && !WorkQueue_running;
+
+    HwiP_restore(key);
+
+    if (wake) {
+        SwiP_post(&WorkQueue_swi);
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== WorkQueue_getStats ========
+ */
+void WorkQueue_getStats(WorkQueue_Stats *stats)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    stats->posts     = WorkQueue_posts;
+    stats->coalesced = WorkQueue_coalesced;
+    stats->runs      = WorkQueue_runs;
+    stats->items     = WorkQueue_items;
+    stats->maxBatch  = WorkQueue_maxBatch;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== WorkQueue_swiFxn ========
+ *  Takes the whole queue at once and runs it with interrupts enabled,
+ *  until the queue stays empty.
+ */
+static void WorkQueue_swiFxn(uintptr_t arg0, uintptr_t arg1)
+{
+    WorkQueue_Item *item;
+    WorkQueue_Item *next;
+    uintptr_t       key;
+    uint32_t        batch = 0;
+
+    WorkQueue_runs++;
+
+    for (;;) {
+        key = HwiP_disable();
+        item = WorkQueue_head;
+        WorkQueue_head = NULL;
+        WorkQueue_tail = NULL;
+        /* Cleared together with the last check, so no post is missed */
+        WorkQueue_running = (item != NULL);
+        HwiP_restore(key);
+
+        if (item == NULL) {
+            break;
+        }
+
+        while (item != NULL) {
+            /* Detached items are not touched by posts until unqueued */
+            next = item->next;
+            Atomic_dmb();
+            item->queued = false;
+
+            item->fxn(item->arg);
+            batch++;
+            item = next;
+        }
+    }
+
+    WorkQueue_items += batch;
+    if (batch > WorkQueue_maxBatch) {
+        WorkQueue_maxBatch = batch;
+    }
+}
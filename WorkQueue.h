@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       WorkQueue.h
+ *
+ *  @brief      Deferred work run in batches by a single Swi.
+ *
+ *  Interrupts post small work items instead of each owning a Swi. Items
+ *  are static descriptors chained through their own @p next field, so a
+ *  post takes a few instructions with interrupts disabled and allocates
+ *  nothing. The worker Swi is posted only when the queue goes from empty
+ *  to non-empty and runs every queued item before it returns, including
+ *  those posted while it runs, so a burst of interrupts costs one Swi
+ *  dispatch instead of one per event.
+ *
+ *  Posting an item that is already queued does nothing but count: repeated
+ *  requests for the same work, such as "drain the log" after every record,
+ *  collapse into one call. An item is taken off the queue just before its
+ *  function is called, so a post from within the function, or from an
+ *  interrupt during it, runs the function again.
+ *
+ *  Items run in the order they were first posted. WorkQueue_post() may be
+ *  called from Task, Swi and Hwi context; the functions run in Swi context
+ *  at WorkQueue_SWI_PRIORITY and must not block.
+ *
+ *  @code
+ *  #include "WorkQueue.h"
+ *
+ *  static WorkQueue_Item flushWork;
+ *
+ *  WorkQueue_init();
+ *  WorkQueue_Item_init(&flushWork, flushFxn, 0);
+ *
+ *  // From any context
+ *  WorkQueue_post(&flushWork);
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __WORKQUEUE_H__
+#define __WORKQUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*! Priority of the worker Swi, the lowest by default like the drivers' */
+#ifndef WorkQueue_SWI_PRIORITY
+#define WorkQueue_SWI_PRIORITY  0
+#endif
+
+/*!
+ *  @brief  Work function, called in Swi context
+ */
+typedef void (*WorkQueue_Fxn)(uintptr_t arg);
+
+/*!
+ *  @brief  A work item
+ *
+ *  The application must not access any member variables of this structure!
+ */
+typedef struct WorkQueue_Item {
+    struct WorkQueue_Item *next;
+    WorkQueue_Fxn          fxn;
+    uintptr_t              arg;
+    volatile bool          queued;
+} WorkQueue_Item;
+
+/*!
+ *  @brief  Counters
+ */
+typedef struct WorkQueue_Stats {
+    uint32_t posts;      /*!< Calls of WorkQueue_post() */
+    uint32_t coalesced;  /*!< Posts of items that were already queued */
+    uint32_t runs;       /*!< Swi dispatches of the worker */
+    uint32_t items;      /*!< Work functions called */
+    uint32_t maxBatch;   /*!< Most functions called by one dispatch */
+} WorkQueue_Stats;
+
+/*!
+ *  @brief  Construct the worker Swi
+ *
+ *  Must be called once before the first post, from main() or a task.
+ *  Further calls do nothing.
+ */
+extern void WorkQueue_init(void);
+
+/*!
+ *  @brief  Initialize an item that is not queued
+ */
+extern void WorkQueue_Item_init(WorkQueue_Item *item, WorkQueue_Fxn fxn,
+                                uintptr_t arg);
+
+/*!
+ *  @brief  Queue an item, from any context
+ *
+ *  @return false if the item was already queued.
+ */
+extern bool WorkQueue_post(WorkQueue_Item *item);
+
+/*!
+ *  @brief  Read the counters
+ */
+extern void WorkQueue_getStats(WorkQueue_Stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WORKQUEUE_H__ */
@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== XoscHf.c ========
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ti/devices/cc13x0/driverlib/aon_rtc.h>
+#include <ti/devices/cc13x0/driverlib/osc.h>
+#include <ti/drivers/Power.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+#include <ti/drivers/power/PowerCC26XX.h>
+
+#include "Energy.h"
+#include "XoscHf.h"
+
+/* State of the start ahead of an announced command */
+typedef enum XoscHf_Ahead {
+    XoscHf_Ahead_NONE,    /* No command announced */
+    XoscHf_Ahead_ARMED,   /* The clock starts the crystal */
+    XoscHf_Ahead_HELD     /* Started, the clock releases it */
+} XoscHf_Ahead;
+
+static ClockP_Struct     XoscHf_clock;
+static SemaphoreP_Struct XoscHf_sem;
+static Power_NotifyObj   XoscHf_notify;
+
+/* Protected by HwiP_disable() */
+static XoscHf_Ahead      XoscHf_ahead;
+static uint32_t          XoscHf_holds;
+static bool              XoscHf_timing;
+static uint32_t          XoscHf_startTime;
+static uint32_t          XoscHf_startupUs = XoscHf_STARTUP_US;
+static XoscHf_Stats      XoscHf_stats;
+
+static void XoscHf_clockFxn(uintptr_t arg);
+static void XoscHf_drop(void);
+static void XoscHf_hold(void);
+static int XoscHf_notifyFxn(unsigned int eventType, uintptr_t eventArg,
+                            uintptr_t clientArg);
+
+/*
+ *  ======== XoscHf_now ========
+ *  RTC in 1/65536 s.
+ */
+static inline uint32_t XoscHf_now(void)
+{
+    return (AONRTCCurrentCompareValueGet());
+}
+
+/*
+ *  ======== XoscHf_ready ========
+ */
+static inline bool XoscHf_ready(void)
+{
+    return (OSCClockSourceGet(OSC_SRC_CLK_HF) == OSC_XOSC_HF);
+}
+
+/*
+ *  ======== XoscHf_ticks ========
+ *  ClockP ticks of at least @p us, and at least one.
+ */
+static inline uint32_t XoscHf_ticks(uint32_t us)
+{
+    return ((us + ClockP_tickPeriod - 1) / ClockP_tickPeriod + 1);
+}
+
+/*
+ *  ======== XoscHf_init ========
+ */
+void XoscHf_init(void)
+{
+    ClockP_Params clockParams;
+
+    SemaphoreP_constructBinary(&XoscHf_sem, 0);
+
+    ClockP_Params_init(&clockParams);
+    ClockP_construct(&XoscHf_clock, XoscHf_clockFxn, 1, &clockParams);
+
+    Power_registerNotify(&XoscHf_notify,
+                         PowerCC26XX_ENTERING_STANDBY |
+                         PowerCC26XX_AWAKE_STANDBY |
+                         PowerCC26XX_XOSC_HF_SWITCHED,
+                         XoscHf_notifyFxn, 0);
+
+    XoscHf_stats.startupUs = XoscHf_startupUs;
+}
+
+/*
+ *  ======== XoscHf_schedule ========
+ */
+void XoscHf_schedule(uint32_t delayUs)
+{
+    uint32_t  lead;
+    uintptr_t key;
+
+    key = HwiP_disable();
+
+    lead = XoscHf_startupUs + XoscHf_MARGIN_US;
+    ClockP_stop(&XoscHf_clock);
+
+    if (XoscHf_ahead == XoscHf_Ahead_HELD) {
+        ClockP_setTimeout(&XoscHf_clock,
+                XoscHf_ticks(delayUs + XoscHf_HOLD_MS * 1000));
+    }
+    else if (delayUs <= lead) {
+        XoscHf_hold();
+        XoscHf_ahead = XoscHf_Ahead_HELD;
+        XoscHf_stats.predicted++;
+        ClockP_setTimeout(&XoscHf_clock,
+                XoscHf_ticks(delayUs + XoscHf_HOLD_MS * 1000));
+    }
+    else {
+        XoscHf_ahead = XoscHf_Ahead_ARMED;
+        ClockP_setTimeout(&XoscHf_clock, XoscHf_ticks(delayUs - lead));
+    }
+    ClockP_start(&XoscHf_clock);
+
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== XoscHf_acquire ========
+ */
+bool XoscHf_acquire(void)
+{
+    uint32_t  start = XoscHf_now();
+    uint32_t  latency;
+    uintptr_t key;
+    bool      ready;
+
+    key = HwiP_disable();
+
+    XoscHf_stats.acquires++;
+    if (XoscHf_ahead == XoscHf_Ahead_HELD) {
+        /* The command takes over the crystal started for it */
+        ClockP_stop(&XoscHf_clock);
+    }
+    else {
+        if (XoscHf_ahead == XoscHf_Ahead_ARMED) {
+            ClockP_stop(&XoscHf_clock);
+        }
+        XoscHf_hold();
+    }
+    XoscHf_ahead = XoscHf_Ahead_NONE;
+    ready = XoscHf_ready();
+
+    HwiP_restore(key);
+
+    if (ready) {
+        return (true);
+    }
+
+    /* Posted on every switch, so checked again after each */
+    do {
+        if (SemaphoreP_pend(&XoscHf_sem,
+                XoscHf_ticks(XoscHf_TIMEOUT_MS * 1000)) != SemaphoreP_OK) {
+            break;
+        }
+        ready = XoscHf_ready();
+    } while (!ready);
+
+    latency = (uint32_t)((uint64_t)(XoscHf_now() - start) * 1000000 /
+            Energy_TICKS_PER_SEC);
+
+    key = HwiP_disable();
+    XoscHf_stats.late++;
+    XoscHf_stats.latencyTotalUs += latency;
+    if (latency > XoscHf_stats.latencyMaxUs) {
+        XoscHf_stats.latencyMaxUs = latency;
+    }
+    HwiP_restore(key);
+
+    return (ready);
+}
+
+/*
+ *  ======== XoscHf_release ========
+ */
+void XoscHf_release(void)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    XoscHf_drop();
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== XoscHf_getStats ========
+ */
+void XoscHf_getStats(XoscHf_Stats *stats)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    *stats = XoscHf_stats;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== XoscHf_resetStats ========
+ */
+void XoscHf_resetStats(void)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+    memset(&XoscHf_stats, 0, sizeof(XoscHf_stats));
+    XoscHf_stats.startupUs = XoscHf_startupUs;
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== XoscHf_clockFxn ========
+ *  Starts the crystal ahead of the announced command, or releases it if
+ *  the command has not come.
+ */
+static void XoscHf_clockFxn(uintptr_t arg)
+{
+    uintptr_t key;
+
+    key = HwiP_disable();
+
+    if (XoscHf_ahead == XoscHf_Ahead_ARMED) {
+        XoscHf_hold();
+        XoscHf_ahead = XoscHf_Ahead_HELD;
+        XoscHf_stats.predicted++;
+        ClockP_setTimeout(&XoscHf_clock, XoscHf_ticks(XoscHf_startupUs +
+                XoscHf_MARGIN_US + XoscHf_HOLD_MS * 1000));
+        ClockP_start(&XoscHf_clock);
+    }
+    else if (XoscHf_ahead == XoscHf_Ahead_HELD) {
+        XoscHf_stats.unused++;
+        XoscHf_ahead = XoscHf_Ahead_NONE;
+        XoscHf_drop();
+    }
+
+    HwiP_restore(key);
+}
+
+/*
+ *  ======== XoscHf_hold ========
+ *  Must be called with interrupts disabled.
+ */
+static void XoscHf_hold(void)
+{
+    if (XoscHf_holds++ > 0) {
+        return;
+    }
+
+    Power_setDependency(PowerCC26XX_XOSC_HF);
+    Energy_begin(EnergyOp_XOSC_HF);
+
+    /* Already running if the RF driver holds it */
+    if (!XoscHf_ready()) {
+        XoscHf_timing    = true;
+        XoscHf_startTime = XoscHf_now();
+    }
+}
+
+/*
+ *  ======== XoscHf_drop ========
+ *  Must be called with interrupts disabled.
+ */
+static void XoscHf_drop(void)
+{
+    if (--XoscHf_holds > 0) {
+        return;
+    }
+
+    XoscHf_timing = false;
+    Energy_end(EnergyOp_XOSC_HF);
+    Power_releaseDependency(PowerCC26XX_XOSC_HF);
+}
+
+/*
+ *  ======== XoscHf_notifyFxn ========
+ *  Learns the startup time. Standby stops the crystal, which the Power
+ *  driver restarts on wakeup while it is held.
+ */
+static int XoscHf_notifyFxn(unsigned int eventType, uintptr_t eventArg,
+                            uintptr_t clientArg)
+{
+    uint32_t  sample;
+    uintptr_t key;
+
+    key = HwiP_disable();
+
+    if (XoscHf_holds == 0) {
+        /* Not ours */
+    }
+    else if (eventType == PowerCC26XX_ENTERING_STANDBY) {
+        XoscHf_timing = false;
+        Energy_end(EnergyOp_XOSC_HF);
+    }
+    else if (eventType == PowerCC26XX_AWAKE_STANDBY) {
+        XoscHf_timing    = true;
+        XoscHf_startTime = XoscHf_now();
+        Energy_begin(EnergyOp_XOSC_HF);
+    }
+    else if (XoscHf_timing) {
+        XoscHf_timing = false;
+        sample = (uint32_t)((uint64_t)(XoscHf_now() - XoscHf_startTime) *
+                1000000 / Energy_TICKS_PER_SEC);
+
+        /* Longer at once, shorter by an eighth of the difference */
+        if (sample > XoscHf_startupUs) {
+            XoscHf_startupUs = sample;
+        }
+        else {
+            XoscHf_startupUs -= (XoscHf_startupUs - sample) / 8;
+        }
+
+        XoscHf_stats.starts++;
+        XoscHf_stats.startupUs = XoscHf_startupUs;
+        if (sample > XoscHf_stats.startupMaxUs) {
+            XoscHf_stats.startupMaxUs = sample;
+        }
+    }
+
+    HwiP_restore(key);
+
+    if (eventType == PowerCC26XX_XOSC_HF_SWITCHED) {
+        SemaphoreP_post(&XoscHf_sem);
+    }
+
+    return (Power_NOTIFYDONE);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       XoscHf.h
+ *
+ *  @brief      Starts the 24 MHz crystal ahead of radio commands.
+ *
+ *  The RF driver no longer keeps the XOSC_HF dependency through standby
+ *  (xoscHfAlwaysNeeded in the board file), so the crystal only runs while
+ *  a radio command needs it. A command is bracketed by XoscHf_acquire()
+ *  and XoscHf_release(); the first blocks until the crystal clocks the
+ *  device. To keep that from delaying the command, the application calls
+ *  XoscHf_schedule() as soon as it knows when the next command is due, and
+ *  the crystal is started the learned startup time plus XoscHf_MARGIN_US
+ *  ahead of it. A crystal started for a command that has not come within
+ *  XoscHf_HOLD_MS of its time is released again.
+ *
+ *  The startup time is measured from each start, including the restarts
+ *  of the Power driver after standby, to the PowerCC26XX_XOSC_HF_SWITCHED
+ *  notification. Longer startups are learned at once and shorter ones
+ *  slowly, so the lead errs on the early side.
+ *
+ *  The crystal's running time is tagged as EnergyOp_XOSC_HF, without the
+ *  time in standby, when the Power driver stops it.
+ *
+ *  @code
+ *  XoscHf_init();
+ *
+ *  // The next packet goes out in 500 ms
+ *  XoscHf_schedule(500000);
+ *
+ *  // ... 500 ms later
+ *  XoscHf_acquire();
+ *  RF_runCmd(rfHandle, (RF_Op *)&txCmd, RF_PriorityNormal, NULL, 0);
+ *  XoscHf_release();
+ *  @endcode
+ *
+ *  ============================================================================
+ */
+#ifndef __XOSCHF_H__
+#define __XOSCHF_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*! Startup time assumed until one has been measured, in us */
+#ifndef XoscHf_STARTUP_US
+#define XoscHf_STARTUP_US   1000
+#endif
+
+/*! Added to the learned startup time, in us */
+#ifndef XoscHf_MARGIN_US
+#define XoscHf_MARGIN_US    200
+#endif
+
+/*! How long a started crystal waits for its command, in ms */
+#ifndef XoscHf_HOLD_MS
+#define XoscHf_HOLD_MS      5
+#endif
+
+/*! Longest wait of XoscHf_acquire(), in ms */
+#ifndef XoscHf_TIMEOUT_MS
+#define XoscHf_TIMEOUT_MS   10
+#endif
+
+/*!
+ *  @brief  Counters, since XoscHf_init() or XoscHf_resetStats()
+ */
+typedef struct XoscHf_Stats {
+    uint32_t startupUs;      /*!< Learned startup time */
+    uint32_t startupMaxUs;   /*!< Longest startup measured */
+    uint32_t starts;         /*!< Startups measured */
+    uint32_t predicted;      /*!< Starts ahead of a command */
+    uint32_t unused;         /*!< Of those, released without a command */
+    uint32_t acquires;       /*!< Calls of XoscHf_acquire() */
+    uint32_t late;           /*!< Of those, waits for the crystal */
+    uint32_t latencyMaxUs;   /*!< Longest wait */
+    uint32_t latencyTotalUs; /*!< All waits */
+} XoscHf_Stats;
+
+/*!
+ *  @brief  Construct the clock and register for the Power notifications
+ *
+ *  Must be called once, from main() before BIOS_start().
+ */
+extern void XoscHf_init(void);
+
+/*!
+ *  @brief  Announce a radio command due in @p delayUs, from any context
+ *
+ *  Replaces an earlier announcement. Does nothing while a crystal started
+ *  for a command waits for it, except extending the wait.
+ */
+extern void XoscHf_schedule(uint32_t delayUs);
+
+/*!
+ *  @brief  Hold the crystal for a radio command, from a thread
+ *
+ *  Takes over the crystal of the announced command, or starts it.
+ *
+ *  @return false if the crystal did not start within XoscHf_TIMEOUT_MS;
+ *          it is held all the same and must be released.
+ */
+extern bool XoscHf_acquire(void);
+
+/*!
+ *  @brief  Release the crystal held by XoscHf_acquire()
+ *
+ *  The crystal stops once no command holds it, unless the RF driver
+ *  does.
+ */
+extern void XoscHf_release(void);
+
+/*!
+ *  @brief  Read the counters
+ */
+extern void XoscHf_getStats(XoscHf_Stats *stats);
+
+/*!
+ *  @brief  Clear the counters, keeping the learned startup time
+ */
+extern void XoscHf_resetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __XOSCHF_H__ */
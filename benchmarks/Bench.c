@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== Bench.c ========
+ */
+
+#include <stddef.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/NVS.h>
+
+#include "Bench.h"
+#include "Log.h"
+
+/* In the order they run; LOG_BENCHMARK first, before other output */
+static const Bench_Entry Bench_table[] = {
+#if (LOG_BENCHMARK)
+    {"log",      LogBench_run},
+#endif
+#if (LCD_BENCHMARK)
+    {"lcd",      LcdBench_run},
+#endif
+#if (FMT_BENCHMARK)
+    {"fmt",      FmtBench_run},
+#endif
+#if (MUX_BENCHMARK)
+    {"mux",      MuxBench_run},
+#endif
+#if (POOL_BENCHMARK)
+    {"pool",     PoolBench_run},
+#endif
+#if (WORKQ_BENCHMARK)
+    {"workq",    WorkqBench_run},
+#endif
+#if (CORO_BENCHMARK)
+    {"coro",     CoroBench_run},
+#endif
+#if (EVENT_BENCHMARK)
+    {"event",    EventBench_run},
+#endif
+#if (SAMPLER_BENCHMARK)
+    {"sampler",  SamplerBench_run},
+#endif
+#if (XOSC_BENCHMARK)
+    {"xosc",     XoscBench_run},
+#endif
+#if (BUTTON_EVENTS)
+    {"button",   ButtonBench_run},
+#endif
+#if (SENSOR_PIPELINE)
+    {"sensor",   SensorBench_run},
+#endif
+#if (POWER_BENCHMARK)
+    {"power",    PowerBench_run},
+#endif
+    {NULL, NULL}
+};
+
+/*
+ *  ======== Bench_runAll ========
+ */
+void Bench_runAll(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    const Bench_Entry *entry;
+
+    for (entry = Bench_table; entry->fxn != NULL; entry++) {
+        Log_info1(LogMod_APP, "Running %s", entry->name);
+        entry->fxn(displayHandle, nvsHandle);
+    }
+}
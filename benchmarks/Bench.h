@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+/** ============================================================================
+ *  @file       Bench.h
+ *
+ *  @brief      Startup demos and benchmarks of mainThread.
+ *
+ *  Each demo or benchmark lives in its own file in this directory and
+ *  compiles to nothing unless the build sets its flag below to 1. The
+ *  enabled ones are listed in the table of Bench.c, which mainThread runs
+ *  in order with Bench_runAll() once the NVS region is open and before the
+ *  NVS example itself. Results are printed on the display.
+ *
+ *  To add one, write a @c Xxx_run() function with the signature of
+ *  #Bench_Fxn in a new file guarded by its flag, declare it here and add
+ *  it to the table.
+ *
+ *  ============================================================================
+ */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ti/display/Display.h>
+#include <ti/drivers/NVS.h>
+
+/*
+ * Set to 1 to compare the cost of Display_printf and Log_print on startup.
+ * Results are printed as text before the rest of the output.
+ */
+#ifndef LOG_BENCHMARK
+#define LOG_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to print the SPI traffic and time of typical Sharp LCD updates
+ * on startup. Needs a board built with BOARD_DISPLAY_USE_LCD=1.
+ */
+#ifndef LCD_BENCHMARK
+#define LCD_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to compare the cycles of SystemP_snprintf and the Fmt
+ * formatters on startup.
+ */
+#ifndef FMT_BENCHMARK
+#define FMT_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to print the cycles of Display_printf on startup with one and
+ * more active DisplayMux sinks. Needs a board built with
+ * BOARD_DISPLAY_USE_LCD=1.
+ */
+#ifndef MUX_BENCHMARK
+#define MUX_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to compare BlockPool and HeapMem on startup under the same
+ * random sequence of allocations and releases.
+ */
+#ifndef POOL_BENCHMARK
+#define POOL_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to print the button edges with the time of the PIN callback and
+ * the wake latency of the task receiving them.
+ */
+#ifndef BUTTON_EVENTS
+#define BUTTON_EVENTS 0
+#endif
+
+/*
+ * Set to 1 to run the ADC through the acquire, process and store pipeline
+ * for SENSOR_SECONDS on startup, printing its statistics every second.
+ * Stores a summary of every SENSOR_SAMPLES samples in the NVS region.
+ */
+#ifndef SENSOR_PIPELINE
+#define SENSOR_PIPELINE 0
+#endif
+
+/*
+ * Set to 1 to compare one Swi per event with the WorkQueue under a storm
+ * of timer interrupts on startup, printing the Swi runs per second and the
+ * CPU load of each.
+ */
+#ifndef WORKQ_BENCHMARK
+#define WORKQ_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to compare the cycles of a switch between two coroutines and
+ * between two threads on startup, and the RAM each of them needs.
+ */
+#ifndef CORO_BENCHMARK
+#define CORO_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to compare a thread polling flags with one waiting on an
+ * EventGroup on startup, printing the wakeups per second and the reaction
+ * latency of each.
+ */
+#ifndef EVENT_BENCHMARK
+#define EVENT_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to measure the CPU time taken by the program counter Sampler at
+ * 1 kHz and 10 kHz on startup. Needs Sampler_ENABLE=1; leave SAMPLER_RATE_HZ
+ * of main_tirtos.c at 0.
+ */
+#ifndef SAMPLER_BENCHMARK
+#define SAMPLER_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to log a record a second for a minute, written at once and then
+ * batched through FlashPolicy, and print the average current and wakeups
+ * per hour of each with the estimates of Energy.
+ */
+#ifndef POWER_BENCHMARK
+#define POWER_BENCHMARK 0
+#endif
+
+/*
+ * Set to 1 to time a simulated radio command a second with the 24 MHz
+ * crystal always held, started on demand and started ahead by XoscHf, and
+ * print the average current and the wait for the crystal of each.
+ */
+#ifndef XOSC_BENCHMARK
+#define XOSC_BENCHMARK 0
+#endif
+
+/*! Calls averaged by the cycle count benchmarks */
+#define Bench_CALLS         16
+
+/*!
+ *  @brief  A demo or benchmark
+ *
+ *  @param  displayHandle  Display to print the results on
+ *  @param  nvsHandle      Open internal NVS region, for those that log to it
+ */
+typedef void (*Bench_Fxn)(Display_Handle displayHandle, NVS_Handle nvsHandle);
+
+/*!
+ *  @brief  Entry of the table in Bench.c
+ */
+typedef struct Bench_Entry {
+    const char *name;
+    Bench_Fxn   fxn;
+} Bench_Entry;
+
+/*!
+ *  @brief  Run the enabled demos and benchmarks in table order
+ *
+ *  Demos that start a thread, such as BUTTON_EVENTS, return at once and
+ *  keep running.
+ */
+extern void Bench_runAll(Display_Handle displayHandle, NVS_Handle nvsHandle);
+
+extern void ButtonBench_run(Display_Handle displayHandle,
+                            NVS_Handle nvsHandle);
+extern void CoroBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle);
+extern void EventBench_run(Display_Handle displayHandle,
+                           NVS_Handle nvsHandle);
+extern void FmtBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle);
+extern void LcdBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle);
+extern void LogBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle);
+extern void MuxBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle);
+extern void PoolBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle);
+extern void PowerBench_run(Display_Handle displayHandle,
+                           NVS_Handle nvsHandle);
+extern void SamplerBench_run(Display_Handle displayHandle,
+                             NVS_Handle nvsHandle);
+extern void SensorBench_run(Display_Handle displayHandle,
+                            NVS_Handle nvsHandle);
+extern void WorkqBench_run(Display_Handle displayHandle,
+                           NVS_Handle nvsHandle);
+extern void XoscBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H__ */
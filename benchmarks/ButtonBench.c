@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== ButtonBench.c ========
+ */
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Bench.h"
+#include "Board.h"
+#include "ButtonEvents.h"
+#include "Log.h"
+#include "StaticThread.h"
+
+#if (BUTTON_EVENTS)
+
+static StaticThread_Struct buttonThreadStruct;
+static StaticThread_STACK(buttonThreadStack, 768);
+
+/*
+ *  ======== buttonThread ========
+ */
+static void *buttonThread(void *arg0)
+{
+    Display_Handle     displayHandle = (Display_Handle)arg0;
+    ButtonEvents_Event events[4];
+    ButtonEvents_Stats stats;
+    uint32_t           count;
+    uint32_t           i;
+
+    for (;;) {
+        count = ButtonEvents_wait(events, 4, SemaphoreP_WAIT_FOREVER);
+        for (i = 0; i < count; i++) {
+            Display_printf(displayHandle, 0, 0, "Button %u %s",
+                    (events[i].pin == Board_PIN_BUTTON0) ? 0 : 1,
+                    events[i].pressed ? "pressed" : "released");
+        }
+
+        ButtonEvents_getStats(&stats);
+        Display_printf(displayHandle, 0, 0,
+                "  callback %u (max %u), wake %u (max %u) cycles, %u dropped",
+                stats.callbackTotal / stats.events, stats.callbackMax,
+                stats.wakeTotal / stats.received, stats.wakeMax,
+                stats.dropped);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== ButtonBench_run ========
+ */
+void ButtonBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    StaticThread_Config config = {
+        "button", buttonThread, (void *)displayHandle, 2, buttonThreadStack,
+        sizeof(buttonThreadStack)
+    };
+
+    if (!ButtonEvents_open() ||
+        !StaticThread_construct(&buttonThreadStruct, &config)) {
+        Log_error0(LogMod_APP, "Button events are not available.");
+    }
+}
+
+#endif /* BUTTON_EVENTS */
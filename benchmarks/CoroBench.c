@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== CoroBench.c ========
+ */
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Bench.h"
+#include "Coro.h"
+#include "Dwt.h"
+#include "Log.h"
+#include "StaticThread.h"
+
+#if (CORO_BENCHMARK)
+
+#define CORO_ROUNDS         1000
+#define CORO_HANDLERS       10
+#define CORO_STACK_SIZE     512
+
+typedef struct CoroPing {
+    Coro_Sem  *in;
+    Coro_Sem  *out;
+    uint32_t   round;
+} CoroPing;
+
+static Coro_Sched          coroSched;
+static Coro_Struct         coroObjects[2];
+static Coro_Sem            coroSems[2];
+static CoroPing            coroPings[2] = {
+    {&coroSems[0], &coroSems[1], 0},
+    {&coroSems[1], &coroSems[0], 0},
+};
+
+static SemaphoreP_Struct   coroThreadSems[2];
+static StaticThread_Struct coroThreadStruct;
+static StaticThread_STACK(coroThreadStack, CORO_STACK_SIZE);
+
+/*
+ *  ======== coroPingFxn ========
+ *  Hands the turn to the other coroutine CORO_ROUNDS times. The first one
+ *  starts with a count on its input.
+ */
+static int coroPingFxn(Coro_Struct *coro, void *arg)
+{
+    CoroPing *ping = (CoroPing *)arg;
+
+    Coro_BEGIN(coro);
+    for (ping->round = 0; ping->round < CORO_ROUNDS; ping->round++) {
+        Coro_PEND(coro, ping->in, SemaphoreP_WAIT_FOREVER);
+        Coro_Sem_post(ping->out);
+    }
+    Coro_END(coro);
+}
+
+/*
+ *  ======== coroThread ========
+ *  The thread counterpart of coroPingFxn, at a higher priority than
+ *  mainThread so that every post switches.
+ */
+static void *coroThread(void *arg0)
+{
+    uint32_t round;
+
+    for (round = 0; round < CORO_ROUNDS; round++) {
+        SemaphoreP_pend(&coroThreadSems[1], SemaphoreP_WAIT_FOREVER);
+        SemaphoreP_post(&coroThreadSems[0]);
+    }
+
+    return (NULL);
+}
+
+/*
+ *  ======== CoroBench_run ========
+ */
+void CoroBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    StaticThread_Config config = {
+        "coro", coroThread, NULL, 2, coroThreadStack,
+        sizeof(coroThreadStack)
+    };
+    uint32_t coroCycles;
+    uint32_t threadCycles;
+    uint32_t start;
+    uint32_t round;
+
+    Dwt_enable();
+
+    /* Two switches per round: a pend and a post each */
+    Coro_Sched_construct(&coroSched);
+    Coro_Sem_construct(&coroSems[0], 1);
+    Coro_Sem_construct(&coroSems[1], 0);
+    Coro_construct(&coroObjects[0], &coroSched, coroPingFxn, &coroPings[0]);
+    Coro_construct(&coroObjects[1], &coroSched, coroPingFxn, &coroPings[1]);
+
+    start = Dwt_cycles();
+    Coro_run(&coroSched);
+    coroCycles = Dwt_cycles() - start;
+
+    SemaphoreP_constructBinary(&coroThreadSems[0], 0);
+    SemaphoreP_constructBinary(&coroThreadSems[1], 0);
+    if (!StaticThread_construct(&coroThreadStruct, &config)) {
+        Log_error0(LogMod_APP, "StaticThread_construct() failed.");
+        return;
+    }
+
+    start = Dwt_cycles();
+    for (round = 0; round < CORO_ROUNDS; round++) {
+        SemaphoreP_post(&coroThreadSems[1]);
+        SemaphoreP_pend(&coroThreadSems[0], SemaphoreP_WAIT_FOREVER);
+    }
+    threadCycles = Dwt_cycles() - start;
+
+    StaticThread_join(&coroThreadStruct);
+    SemaphoreP_destruct(&coroThreadSems[0]);
+    SemaphoreP_destruct(&coroThreadSems[1]);
+
+    Display_printf(displayHandle, 0, 0,
+            "Coroutine switch: %u cycles, %u bytes each",
+            coroCycles / (2 * CORO_ROUNDS), sizeof(Coro_Struct));
+    Display_printf(displayHandle, 0, 0,
+            "Thread switch: %u cycles, %u bytes each with a %u byte stack",
+            threadCycles / (2 * CORO_ROUNDS),
+            sizeof(StaticThread_Struct) + CORO_STACK_SIZE, CORO_STACK_SIZE);
+    Display_printf(displayHandle, 0, 0,
+            "%u handlers: %u bytes as coroutines, %u as threads",
+            CORO_HANDLERS,
+            CORO_HANDLERS * sizeof(Coro_Struct) + sizeof(Coro_Sched),
+            CORO_HANDLERS * (sizeof(StaticThread_Struct) + CORO_STACK_SIZE));
+}
+
+#endif /* CORO_BENCHMARK */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== EventBench.c ========
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+
+#include "Bench.h"
+#include "Dwt.h"
+#include "EventGroup.h"
+
+#if (EVENT_BENCHMARK)
+
+#define EVENT_SECONDS       2
+#define EVENT_PERIOD_US     7000
+#define EVENT_POLL_US       5000
+
+/* Conditions the thread waits for, set in turn by the clock */
+#define EVENT_SAMPLE        0x01
+#define EVENT_FLUSH         0x02
+#define EVENT_RADIO         0x04
+#define EVENT_ALL           (EVENT_SAMPLE | EVENT_FLUSH | EVENT_RADIO)
+
+static ClockP_Struct     eventClock;
+static EventGroup_Struct eventGroup;
+static volatile bool     eventPolled;
+static volatile uint32_t eventFlags;
+static volatile uint32_t eventSetCycles;
+static uint32_t          eventNext;
+
+/*
+ *  ======== eventClockFxn ========
+ */
+static void eventClockFxn(uintptr_t arg)
+{
+    uint32_t bit = 1U << (eventNext++ % 3);
+
+    eventSetCycles = Dwt_cycles();
+    if (eventPolled) {
+        /* A Swi, so the task cannot interrupt the update */
+        eventFlags |= bit;
+    }
+    else {
+        EventGroup_set(&eventGroup, bit);
+    }
+}
+
+/*
+ *  ======== eventRun ========
+ *  Handles the conditions for EVENT_SECONDS, by polling them every
+ *  EVENT_POLL_US or by waiting on the group.
+ */
+static void eventRun(Display_Handle displayHandle, bool polled,
+                     uint32_t cyclesPerUs)
+{
+    uintptr_t key;
+    uint32_t  end;
+    uint32_t  bits;
+    uint32_t  latency;
+    uint32_t  latencyMax = 0;
+    uint32_t  latencyTotal = 0;
+    uint32_t  handled = 0;
+    uint32_t  wakeups = 0;
+
+    eventPolled = polled;
+    eventFlags  = 0;
+    ClockP_start(&eventClock);
+
+    end = ClockP_getSystemTicks() + EVENT_SECONDS * 1000000 /
+            ClockP_tickPeriod;
+    while ((int32_t)(ClockP_getSystemTicks() - end) < 0) {
+        if (polled) {
+            key = HwiP_disable();
+            bits = eventFlags;
+            eventFlags = 0;
+            HwiP_restore(key);
+            if (bits == 0) {
+                ClockP_usleep(EVENT_POLL_US);
+                wakeups++;
+                continue;
+            }
+        }
+        else {
+            bits = EventGroup_waitAny(&eventGroup, EVENT_ALL,
+                    2 * EVENT_PERIOD_US / ClockP_tickPeriod);
+            wakeups++;
+            if (bits == 0) {
+                continue;
+            }
+        }
+
+        latency = Dwt_cycles() - eventSetCycles;
+        if (latency > latencyMax) {
+            latencyMax = latency;
+        }
+        latencyTotal += latency;
+        handled++;
+    }
+
+    ClockP_stop(&eventClock);
+
+    Display_printf(displayHandle, 0, 0,
+            "%s: %u wakeups/s, %u events, latency %u us (max %u)",
+            polled ? "Polling" : "EventGroup", wakeups / EVENT_SECONDS,
+            handled, latencyTotal / handled / cyclesPerUs,
+            latencyMax / cyclesPerUs);
+}
+
+/*
+ *  ======== EventBench_run ========
+ */
+void EventBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    ClockP_Params clockParams;
+    ClockP_FreqHz freq;
+    uint32_t      period = EVENT_PERIOD_US / ClockP_tickPeriod;
+
+    Dwt_enable();
+    ClockP_getCpuFreq(&freq);
+
+    EventGroup_construct(&eventGroup);
+    ClockP_Params_init(&clockParams);
+    clockParams.period = period;
+    ClockP_construct(&eventClock, eventClockFxn, period, &clockParams);
+
+    eventRun(displayHandle, true, freq.lo / 1000000);
+    eventRun(displayHandle, false, freq.lo / 1000000);
+
+    ClockP_destruct(&eventClock);
+    EventGroup_destruct(&eventGroup);
+}
+
+#endif /* EVENT_BENCHMARK */
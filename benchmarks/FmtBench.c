@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== FmtBench.c ========
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/SystemP.h>
+
+#include "Bench.h"
+#include "Dwt.h"
+#include "Fmt.h"
+
+#if (FMT_BENCHMARK)
+
+/* The 16-bit values printed by mainThread */
+static const uint16_t fmtUnsigned = 64532;
+static const int16_t  fmtSigned = -6453;
+
+/*
+ *  ======== fmtPrintf ========
+ */
+static int fmtPrintf(char *dst, size_t size, const char *fmt, ...)
+{
+    va_list va;
+    int     len;
+
+    va_start(va, fmt);
+    len = Fmt_vsnprintf(dst, size, fmt, va);
+    va_end(va);
+
+    return (len);
+}
+
+/*
+ *  ======== FmtBench_run ========
+ *  Average cycles of Bench_CALLS conversions of the values printed by
+ *  mainThread, through SystemP_snprintf and through Fmt.
+ */
+void FmtBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    static const char *names[] = {"%u", "%d", "0x%x", "message"};
+    uint32_t printfCycles[4] = {0};
+    uint32_t fmtCycles[4] = {0};
+    char     text[48];
+    uint32_t start;
+    int      i;
+
+    Dwt_enable();
+
+    for (i = 0; i < Bench_CALLS; i++) {
+        start = Dwt_cycles();
+        SystemP_snprintf(text, sizeof(text), "%u", fmtUnsigned + i);
+        printfCycles[0] += Dwt_cycles() - start;
+
+        start = Dwt_cycles();
+        Fmt_u32(text, fmtUnsigned + i);
+        fmtCycles[0] += Dwt_cycles() - start;
+
+        start = Dwt_cycles();
+        SystemP_snprintf(text, sizeof(text), "%d", fmtSigned - i);
+        printfCycles[1] += Dwt_cycles() - start;
+
+        start = Dwt_cycles();
+        Fmt_i32(text, fmtSigned - i);
+        fmtCycles[1] += Dwt_cycles() - start;
+
+        start = Dwt_cycles();
+        SystemP_snprintf(text, sizeof(text), "0x%x", 0x12000 + i);
+        printfCycles[2] += Dwt_cycles() - start;
+
+        start = Dwt_cycles();
+        text[0] = '0';
+        text[1] = 'x';
+        Fmt_hex32(&text[2], 0x12000 + i);
+        fmtCycles[2] += Dwt_cycles() - start;
+
+        start = Dwt_cycles();
+        SystemP_snprintf(text, sizeof(text), "Reading value from page 0x%x",
+                0x12000 + i);
+        printfCycles[3] += Dwt_cycles() - start;
+
+        start = Dwt_cycles();
+        fmtPrintf(text, sizeof(text), "Reading value from page 0x%x",
+                0x12000 + i);
+        fmtCycles[3] += Dwt_cycles() - start;
+    }
+
+    for (i = 0; i < 4; i++) {
+        Display_printf(displayHandle, 0, 0, "%s: SystemP %u, Fmt %u cycles",
+                names[i], printfCycles[i] / Bench_CALLS,
+                fmtCycles[i] / Bench_CALLS);
+    }
+}
+
+#endif /* FMT_BENCHMARK */
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== LcdBench.c ========
+ */
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+
+#include "Bench.h"
+#include "DisplayMux.h"
+#include "DisplaySharpDma.h"
+#include "Dwt.h"
+
+#if (LCD_BENCHMARK)
+
+/*
+ *  ======== lcdReport ========
+ *  Print the traffic since @p before, averaged over @p calls.
+ */
+static void lcdReport(Display_Handle displayHandle, Display_Handle lcdHandle,
+                      const char *name, DisplaySharpDma_Stats *before,
+                      uint32_t cycles, uint32_t calls)
+{
+    DisplaySharpDma_Stats after;
+
+    Display_control(lcdHandle, DisplaySharpDma_CMD_GET_STATS, &after);
+    Display_printf(displayHandle, 0, 0, "%s: %u rows, %u bytes, %u cycles",
+            name, (after.rows - before->rows) / calls,
+            (after.bytes - before->bytes) / calls, cycles / calls);
+    *before = after;
+}
+
+/*
+ *  ======== LcdBench_run ========
+ *  Time Display_printf() on the LCD, which returns once the SPI transfer
+ *  of the update is done, for a screen full of text.
+ */
+void LcdBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    Display_Handle        lcdHandle;
+    DisplaySharpDma_Stats stats;
+    uint32_t              cycles;
+    uint32_t              start;
+    int                   i;
+
+    /* The LCD may be a sink of the display that is already open */
+    lcdHandle = DisplayMux_getSink(displayHandle, Display_Type_LCD);
+    if (lcdHandle == NULL) {
+        lcdHandle = Display_open(Display_Type_LCD, NULL);
+    }
+    if (lcdHandle == NULL) {
+        Display_printf(displayHandle, 0, 0, "LCD benchmark: no LCD");
+        return;
+    }
+
+    Dwt_enable();
+
+    for (i = 0; i < 12; i++) {
+        Display_printf(lcdHandle, i, 0, "Line %d: 0x%x", i, 0x12000 + i);
+    }
+    Display_control(lcdHandle, DisplaySharpDma_CMD_GET_STATS, &stats);
+
+    /* Every row, as sent by a driver without dirty tracking */
+    Display_control(lcdHandle, DisplaySharpDma_CMD_INVALIDATE, NULL);
+    start = Dwt_cycles();
+    Display_printf(lcdHandle, 0, 0, "Line %d: 0x%x", 0, 0x12000);
+    cycles = Dwt_cycles() - start;
+    lcdReport(displayHandle, lcdHandle, "Full", &stats, cycles, 1);
+
+    /* A value that did not change */
+    cycles = 0;
+    for (i = 0; i < Bench_CALLS; i++) {
+        start = Dwt_cycles();
+        Display_printf(lcdHandle, 5, 0, "Line %d: 0x%x", 5, 0x12005);
+        cycles += Dwt_cycles() - start;
+    }
+    lcdReport(displayHandle, lcdHandle, "Same", &stats, cycles,
+            Bench_CALLS);
+
+    /* A counter on one line */
+    cycles = 0;
+    for (i = 0; i < Bench_CALLS; i++) {
+        start = Dwt_cycles();
+        Display_printf(lcdHandle, 5, 0, "Count: %d", i);
+        cycles += Dwt_cycles() - start;
+    }
+    lcdReport(displayHandle, lcdHandle, "Counter", &stats, cycles,
+            Bench_CALLS);
+
+    /* Two values, five lines apart */
+    cycles = 0;
+    for (i = 0; i < Bench_CALLS; i++) {
+        start = Dwt_cycles();
+        Display_printf(lcdHandle, 3, 0, "A: %d", i);
+        Display_printf(lcdHandle, 8, 0, "B: %d", i * 7);
+        cycles += Dwt_cycles() - start;
+    }
+    lcdReport(displayHandle, lcdHandle, "Two values", &stats, cycles,
+            Bench_CALLS);
+
+    start = Dwt_cycles();
+    Display_clear(lcdHandle);
+    cycles = Dwt_cycles() - start;
+    lcdReport(displayHandle, lcdHandle, "Clear", &stats, cycles, 1);
+
+    if (lcdHandle != DisplayMux_getSink(displayHandle, Display_Type_LCD)) {
+        Display_close(lcdHandle);
+    }
+}
+
+#endif /* LCD_BENCHMARK */
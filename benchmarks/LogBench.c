@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== LogBench.c ========
+ */
+
+#include <stdint.h>
+
+#include <unistd.h>
+
+#include <ti/display/Display.h>
+
+#include "Bench.h"
+#include "DisplayMux.h"
+#include "DisplayUartDma.h"
+#include "Dwt.h"
+#include "Log.h"
+
+#if (LOG_BENCHMARK)
+
+/*
+ *  ======== LogBench_run ========
+ *  Time Bench_CALLS calls of each API on the same message. Each call
+ *  finds an empty UART queue so that no message is dropped.
+ */
+void LogBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    Display_Handle       uartHandle;
+    DisplayUartDma_Stats before;
+    DisplayUartDma_Stats after;
+    uint32_t displayCycles = 0;
+    uint32_t logCycles = 0;
+    uint32_t displayBytes;
+    uint32_t logBytes;
+    uint32_t start;
+    int i;
+
+    Dwt_enable();
+
+    uartHandle = DisplayMux_getSink(displayHandle, Display_Type_UART);
+    Display_control(uartHandle, DisplayUartDma_CMD_GET_STATS, &before);
+    for (i = 0; i < Bench_CALLS; i++) {
+        start = Dwt_cycles();
+        Display_printf(displayHandle, 0, 0, "Reading value from page 0x%x",
+                0x12000);
+        displayCycles += Dwt_cycles() - start;
+        usleep(20000);
+    }
+    Display_control(uartHandle, DisplayUartDma_CMD_GET_STATS, &after);
+    displayBytes = after.uart.txBytes - before.uart.txBytes;
+
+    before = after;
+    for (i = 0; i < Bench_CALLS; i++) {
+        start = Dwt_cycles();
+        Log_print1("Reading value from page 0x%x", 0x12000);
+        logCycles += Dwt_cycles() - start;
+        usleep(20000);
+    }
+    Display_control(uartHandle, DisplayUartDma_CMD_GET_STATS, &after);
+    logBytes = after.uart.txBytes - before.uart.txBytes;
+
+    Display_printf(displayHandle, 0, 0, "Display_printf: %u cycles, %u bytes",
+            displayCycles / Bench_CALLS, displayBytes / Bench_CALLS);
+    Display_printf(displayHandle, 0, 0, "Log_print1: %u cycles, %u bytes",
+            logCycles / Bench_CALLS, logBytes / Bench_CALLS);
+}
+
+#endif /* LOG_BENCHMARK */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== MuxBench.c ========
+ */
+
+#include <stdint.h>
+
+#include <unistd.h>
+
+#include <ti/display/Display.h>
+
+#include "Bench.h"
+#include "DisplayMux.h"
+#include "Dwt.h"
+
+#if (MUX_BENCHMARK)
+
+/* A 16-bit value printed by mainThread */
+static const int16_t muxValue = -6453;
+
+/*
+ *  ======== MuxBench_run ========
+ *  Cycles of Display_printf through the mux with the first 1..n sinks
+ *  active, compared with formatting the message once per sink.
+ */
+void MuxBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    DisplayMux_Stats stats;
+    Display_Handle   sinks[2];
+    uint32_t         active;
+    uint32_t         cycles;
+    uint32_t         start;
+    uint32_t         n;
+    int              i;
+
+    if (Display_control(displayHandle, DisplayMux_CMD_GET_STATS, &stats) !=
+            DISPLAY_STATUS_SUCCESS) {
+        Display_printf(displayHandle, 0, 0, "Mux benchmark: no DisplayMux");
+        return;
+    }
+
+    Dwt_enable();
+
+    for (n = 1; n <= stats.sinkCount; n++) {
+        active = (1U << n) - 1;
+        Display_control(displayHandle, DisplayMux_CMD_SET_ACTIVE, &active);
+
+        cycles = 0;
+        for (i = 0; i < Bench_CALLS; i++) {
+            start = Dwt_cycles();
+            Display_printf(displayHandle, 1, 0, "Page 0x%x: %d", 0x12000,
+                    muxValue - i);
+            cycles += Dwt_cycles() - start;
+            usleep(20000);
+        }
+
+        active = ~0U;
+        Display_control(displayHandle, DisplayMux_CMD_SET_ACTIVE, &active);
+        Display_printf(displayHandle, 0, 0, "Mux, %u sinks: %u cycles", n,
+                cycles / Bench_CALLS);
+    }
+
+    /* Both sinks formatting the message themselves, as without the mux */
+    sinks[0] = DisplayMux_getSink(displayHandle, Display_Type_UART);
+    sinks[1] = DisplayMux_getSink(displayHandle, Display_Type_LCD);
+    if ((sinks[0] != NULL) && (sinks[1] != NULL)) {
+        cycles = 0;
+        for (i = 0; i < Bench_CALLS; i++) {
+            start = Dwt_cycles();
+            Display_printf(sinks[0], 1, 0, "Page 0x%x: %d", 0x12000,
+                    muxValue - i);
+            Display_printf(sinks[1], 1, 0, "Page 0x%x: %d", 0x12000,
+                    muxValue - i);
+            cycles += Dwt_cycles() - start;
+            usleep(20000);
+        }
+        Display_printf(displayHandle, 0, 0, "Direct, 2 sinks: %u cycles",
+                cycles / Bench_CALLS);
+    }
+}
+
+#endif /* MUX_BENCHMARK */
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== PoolBench.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <xdc/std.h>
+#include <xdc/runtime/Error.h>
+#include <xdc/runtime/Memory.h>
+#include <ti/display/Display.h>
+#include <ti/sysbios/heaps/HeapMem.h>
+
+#include "Bench.h"
+#include "BlockPool.h"
+#include "Dwt.h"
+
+#if (POOL_BENCHMARK)
+
+#define POOL_OPS            20000
+#define POOL_SLOTS          24
+#define POOL_HEAP_SIZE      2048
+
+/* 2 KB each, for BlockPool and for HeapMem */
+static BlockPool_STORAGE(poolBlocks16, 16, 16);
+static BlockPool_STORAGE(poolBlocks32, 32, 20);
+static BlockPool_STORAGE(poolBlocks64, 64, 6);
+static BlockPool_STORAGE(poolBlocks128, 128, 6);
+
+static const BlockPool_Class poolClasses[] = {
+    {16,  16, poolBlocks16},
+    {32,  20, poolBlocks32},
+    {64,  6,  poolBlocks64},
+    {128, 6,  poolBlocks128},
+};
+
+static BlockPool_Object poolObject;
+static HeapMem_Struct   poolHeapStruct;
+static uint64_t         poolHeapBuf[POOL_HEAP_SIZE / 8];
+
+/*
+ *  ======== poolRandom ========
+ */
+static uint32_t poolRandom(uint32_t *seed)
+{
+    *seed = *seed * 1664525 + 1013904223;
+
+    return (*seed >> 8);
+}
+
+/*
+ *  ======== poolRun ========
+ *  POOL_OPS random operations on POOL_SLOTS pointers: a full slot is
+ *  released, an empty one gets a new allocation, three in four of them
+ *  messages of up to 32 bytes and the rest records of up to 128 bytes.
+ *  Both allocators see the same sequence.
+ */
+static void poolRun(Display_Handle displayHandle, bool heap)
+{
+    HeapMem_Handle heapHandle = HeapMem_handle(&poolHeapStruct);
+    Memory_Stats   heapStats;
+    BlockPool_Stats stats;
+    Error_Block    eb;
+    void          *ptrs[POOL_SLOTS] = {NULL};
+    uint16_t       sizes[POOL_SLOTS];
+    uint32_t       seed = 1;
+    uint32_t       allocCycles = 0;
+    uint32_t       freeCycles = 0;
+    uint32_t       allocMax = 0;
+    uint32_t       freeMax = 0;
+    uint32_t       allocs = 0;
+    uint32_t       frees = 0;
+    uint32_t       failures = 0;
+    uint32_t       fragmented = 0;
+    uint32_t       cycles;
+    uint32_t       start;
+    uint32_t       r;
+    size_t         size;
+    int            slot;
+    int            i;
+
+    for (i = 0; i < POOL_OPS; i++) {
+        r    = poolRandom(&seed);
+        slot = r % POOL_SLOTS;
+
+        if (ptrs[slot] != NULL) {
+            start = Dwt_cycles();
+            if (heap) {
+                HeapMem_free(heapHandle, ptrs[slot], sizes[slot]);
+            }
+            else {
+                BlockPool_free(&poolObject, ptrs[slot]);
+            }
+            cycles = Dwt_cycles() - start;
+
+            freeCycles += cycles;
+            if (cycles > freeMax) {
+                freeMax = cycles;
+            }
+            frees++;
+            ptrs[slot] = NULL;
+            continue;
+        }
+
+        r    = poolRandom(&seed);
+        size = (r & 3) ? 4 + (r >> 2) % 29 : 33 + (r >> 2) % 96;
+        Error_init(&eb);
+
+        start = Dwt_cycles();
+        if (heap) {
+            ptrs[slot] = HeapMem_alloc(heapHandle, size, 8, &eb);
+        }
+        else {
+            ptrs[slot] = BlockPool_alloc(&poolObject, size);
+        }
+        cycles = Dwt_cycles() - start;
+
+        if (ptrs[slot] == NULL) {
+            failures++;
+            if (heap) {
+                /* Enough memory in total, but not in one piece */
+                HeapMem_getStats(heapHandle, &heapStats);
+                if (heapStats.totalFreeSize >= size) {
+                    fragmented++;
+                }
+            }
+            continue;
+        }
+
+        allocCycles += cycles;
+        if (cycles > allocMax) {
+            allocMax = cycles;
+        }
+        allocs++;
+        sizes[slot] = size;
+    }
+
+    Display_printf(displayHandle, 0, 0,
+            "%s: alloc %u (max %u), free %u (max %u) cycles",
+            heap ? "HeapMem" : "BlockPool", allocCycles / allocs, allocMax,
+            freeCycles / frees, freeMax);
+
+    if (heap) {
+        HeapMem_getStats(heapHandle, &heapStats);
+        Display_printf(displayHandle, 0, 0,
+                "  %u failures, %u fragmented, largest free %u of %u",
+                failures, fragmented, heapStats.largestFreeSize,
+                heapStats.totalFreeSize);
+    }
+    else {
+        BlockPool_getStats(&poolObject, &stats);
+        Display_printf(displayHandle, 0, 0, "  %u failures", stats.failures);
+        for (i = 0; i < stats.classCount; i++) {
+            Display_printf(displayHandle, 0, 0,
+                    "  %u bytes: min free %u of %u, %u fallbacks",
+                    stats.classes[i].blockSize, stats.classes[i].minFree,
+                    stats.classes[i].blockCount, stats.classes[i].fallbacks);
+        }
+    }
+
+    for (i = 0; i < POOL_SLOTS; i++) {
+        if (ptrs[i] == NULL) {
+            continue;
+        }
+        if (heap) {
+            HeapMem_free(heapHandle, ptrs[i], sizes[i]);
+        }
+        else {
+            BlockPool_free(&poolObject, ptrs[i]);
+        }
+    }
+}
+
+/*
+ *  ======== PoolBench_run ========
+ */
+void PoolBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    HeapMem_Params heapParams;
+
+    HeapMem_Params_init(&heapParams);
+    heapParams.buf  = poolHeapBuf;
+    heapParams.size = sizeof(poolHeapBuf);
+    HeapMem_construct(&poolHeapStruct, &heapParams);
+
+    if (!BlockPool_construct(&poolObject, poolClasses,
+            sizeof(poolClasses) / sizeof(poolClasses[0]))) {
+        Display_printf(displayHandle, 0, 0, "BlockPool_construct() failed");
+        return;
+    }
+
+    Dwt_enable();
+
+    poolRun(displayHandle, false);
+    poolRun(displayHandle, true);
+
+    HeapMem_destruct(&poolHeapStruct);
+}
+
+#endif /* POOL_BENCHMARK */
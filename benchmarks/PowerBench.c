@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== PowerBench.c ========
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/NVS.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/HwiP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Bench.h"
+#include "Energy.h"
+#include "FlashPolicy.h"
+#include "Log.h"
+#include "StaticThread.h"
+
+#if (POWER_BENCHMARK)
+
+#define POWER_SECONDS       60
+#define POWER_PERIOD_MS     1000
+#define POWER_BATCH         32
+#define POWER_LATENCY_MS    30000
+
+/* Power log, offsets 0xa000 to 0xdfff, after the sensor log */
+#define POWER_LOG_BASE      0xA000
+#define POWER_LOG_SIZE      0x4000
+
+typedef struct PowerRecord {
+    uint32_t seq;
+    uint32_t timestamp;
+    uint32_t wakeups;
+    uint32_t standby;
+} PowerRecord;
+
+static NVS_Handle        powerNvs;
+static uint32_t          powerSectorSize;
+static uint32_t          powerLogPos;
+static uint32_t          powerWrites;
+static ClockP_Struct     powerClock;
+static SemaphoreP_Struct powerTick;
+static SemaphoreP_Struct powerFlushed;
+static FlashPolicy_Job   powerJob;
+
+/* Only this benchmark defers flash work, so it owns the worker's stack */
+static StaticThread_STACK(powerFlashStack, FlashPolicy_STACK_SIZE);
+
+/* Filled by mainThread, written by the job; swapped under HwiP_disable() */
+static PowerRecord       powerBufs[2][POWER_BATCH];
+static unsigned int      powerActive;
+static unsigned int      powerCount;
+static volatile uint32_t powerPending;
+
+/*
+ *  ======== powerClockFxn ========
+ */
+static void powerClockFxn(uintptr_t arg)
+{
+    SemaphoreP_post(&powerTick);
+}
+
+/*
+ *  ======== powerWrite ========
+ *  Appends to the log, erasing each sector when it is entered, in one
+ *  NVS_write() per sector.
+ */
+static bool powerWrite(const void *buffer, size_t length)
+{
+    const uint8_t *src = buffer;
+    uint_fast16_t  flags;
+    int_fast16_t   status;
+    size_t         chunk;
+
+    while (length > 0) {
+        flags = NVS_WRITE_POST_VERIFY;
+        if ((powerLogPos % powerSectorSize) == 0) {
+            flags |= NVS_WRITE_ERASE;
+        }
+        chunk = powerSectorSize - powerLogPos % powerSectorSize;
+        if (chunk > length) {
+            chunk = length;
+        }
+
+        Energy_begin(EnergyOp_NVS_LOG);
+        status = NVS_write(powerNvs, POWER_LOG_BASE + powerLogPos,
+                (void *)src, chunk, flags);
+        Energy_end(EnergyOp_NVS_LOG);
+        if (status != NVS_STATUS_SUCCESS) {
+            Log_error1(LogMod_NVS, "Cannot log at offset 0x%x",
+                    POWER_LOG_BASE + powerLogPos);
+            return (false);
+        }
+
+        powerWrites++;
+        src += chunk;
+        length -= chunk;
+        powerLogPos = (powerLogPos + chunk) % POWER_LOG_SIZE;
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== powerJobFxn ========
+ *  Writes the records buffered since the previous run, in the FlashPolicy
+ *  worker.
+ */
+static void powerJobFxn(uintptr_t arg)
+{
+    PowerRecord *records;
+    unsigned int count;
+    uintptr_t    key;
+
+    key = HwiP_disable();
+    records = powerBufs[powerActive];
+    count = powerCount;
+    powerActive ^= 1;
+    powerCount = 0;
+    HwiP_restore(key);
+
+    if (count > 0) {
+        powerWrite(records, count * sizeof(PowerRecord));
+    }
+
+    key = HwiP_disable();
+    powerPending -= count;
+    HwiP_restore(key);
+
+    SemaphoreP_post(&powerFlushed);
+}
+
+/*
+ *  ======== powerRun ========
+ *  Logs a record every POWER_PERIOD_MS for POWER_SECONDS, written at once
+ *  or batched, and prints what Energy estimates for it.
+ */
+static void powerRun(Display_Handle displayHandle, bool batched)
+{
+    Energy_States before;
+    Energy_States after;
+    PowerRecord   record;
+    uint64_t      charge;
+    uint64_t      ticks;
+    uint32_t      current;
+    uint32_t      seq;
+    uintptr_t     key;
+
+    powerWrites = 0;
+    Energy_getStates(&before);
+    charge = Energy_getCharge();
+    ClockP_start(&powerClock);
+
+    for (seq = 0; seq < POWER_SECONDS * 1000 / POWER_PERIOD_MS; seq++) {
+        SemaphoreP_pend(&powerTick, SemaphoreP_WAIT_FOREVER);
+
+        Energy_getStates(&after);
+        record.seq       = seq;
+        record.timestamp = ClockP_getSystemTicks();
+        record.wakeups   = after.wakeups;
+        record.standby   = (uint32_t)after.standby;
+
+        if (!batched) {
+            powerWrite(&record, sizeof(record));
+            continue;
+        }
+
+        key = HwiP_disable();
+        if (powerCount < POWER_BATCH) {
+            powerBufs[powerActive][powerCount++] = record;
+            powerPending++;
+        }
+        HwiP_restore(key);
+
+        /* A full buffer is written at once, else within the latency */
+        FlashPolicy_schedule(&powerJob,
+                (powerCount < POWER_BATCH) ? POWER_LATENCY_MS : 0);
+    }
+
+    ClockP_stop(&powerClock);
+
+    /* The last batch counts against this run */
+    while (powerPending != 0) {
+        FlashPolicy_schedule(&powerJob, 0);
+        SemaphoreP_pend(&powerFlushed, SemaphoreP_WAIT_FOREVER);
+    }
+
+    charge = Energy_getCharge() - charge;
+    Energy_getStates(&after);
+    ticks = after.total - before.total;
+    current = (uint32_t)(charge * Energy_TICKS_PER_SEC / ticks);
+
+    Display_printf(displayHandle, 0, 0,
+            "%s: %u.%03u uA, %u wakeups/h, %u writes",
+            batched ? "Batched" : "Direct", current / 1000, current % 1000,
+            (uint32_t)((uint64_t)(after.wakeups - before.wakeups) * 3600 *
+                    Energy_TICKS_PER_SEC / ticks), powerWrites);
+}
+
+/*
+ *  ======== PowerBench_run ========
+ */
+void PowerBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    ClockP_Params     clockParams;
+    NVS_Attrs         regionAttrs;
+    FlashPolicy_Stats stats;
+    uint32_t          period = POWER_PERIOD_MS * 1000 / ClockP_tickPeriod;
+
+    if (!FlashPolicy_start(powerFlashStack, sizeof(powerFlashStack))) {
+        Log_error0(LogMod_APP, "FlashPolicy_start() failed.");
+        return;
+    }
+
+    NVS_getAttrs(nvsHandle, &regionAttrs);
+    powerNvs = nvsHandle;
+    powerSectorSize = regionAttrs.sectorSize;
+    powerLogPos = 0;
+
+    SemaphoreP_constructBinary(&powerTick, 0);
+    SemaphoreP_constructBinary(&powerFlushed, 0);
+    FlashPolicy_Job_init(&powerJob, powerJobFxn, 0);
+    ClockP_Params_init(&clockParams);
+    clockParams.period = period;
+    ClockP_construct(&powerClock, powerClockFxn, period, &clockParams);
+
+    powerRun(displayHandle, false);
+    powerRun(displayHandle, true);
+
+    FlashPolicy_getStats(&stats);
+    Display_printf(displayHandle, 0, 0,
+            "FlashPolicy: %u schedules, %u coalesced, %u batches "
+            "(%u before standby), %u jobs", stats.schedules,
+            stats.coalesced, stats.batches, stats.early, stats.jobs);
+
+    ClockP_destruct(&powerClock);
+    SemaphoreP_destruct(&powerFlushed);
+    SemaphoreP_destruct(&powerTick);
+}
+
+#endif /* POWER_BENCHMARK */
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== SamplerBench.c ========
+ */
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+
+#include "Bench.h"
+#include "Log.h"
+#include "Sampler.h"
+
+#if (SAMPLER_BENCHMARK)
+
+#if !(Sampler_ENABLE)
+#error "SAMPLER_BENCHMARK needs Sampler_ENABLE=1"
+#endif
+
+static const uint32_t samplerRates[] = {1000, 10000};
+
+/*
+ *  ======== samplerIdle ========
+ *  Passes through an empty loop in one second, which is what the
+ *  samples leave to mainThread.
+ */
+static uint32_t samplerIdle(void)
+{
+    uint32_t end = ClockP_getSystemTicks() + 1000000 / ClockP_tickPeriod;
+    uint32_t count = 0;
+
+    while ((int32_t)(ClockP_getSystemTicks() - end) < 0) {
+        count++;
+    }
+
+    return (count);
+}
+
+/*
+ *  ======== SamplerBench_run ========
+ *  The share of the idle loop lost at each rate is the sampler's load.
+ */
+void SamplerBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    ClockP_FreqHz freq;
+    uint32_t      baseline;
+    uint32_t      idle;
+    uint32_t      lost;
+    uint32_t      load;
+    unsigned int  i;
+
+    ClockP_getCpuFreq(&freq);
+    baseline = samplerIdle();
+
+    for (i = 0; i < sizeof(samplerRates) / sizeof(samplerRates[0]); i++) {
+        Sampler_reset();
+        if (!Sampler_start(samplerRates[i])) {
+            Log_error0(LogMod_APP, "Sampler_start() failed.");
+            return;
+        }
+        idle = samplerIdle();
+        Sampler_stop();
+
+        lost = (idle < baseline) ? baseline - idle : 0;
+        load = (uint32_t)((uint64_t)lost * 10000 / baseline);
+        Display_printf(displayHandle, 0, 0,
+                "Sampler at %u Hz: %u samples, load %u.%02u%%, "
+                "%u cycles per sample", samplerRates[i], Sampler_samples,
+                load / 100, load % 100,
+                (uint32_t)((uint64_t)lost * freq.lo / baseline /
+                        samplerRates[i]));
+    }
+
+    Sampler_reset();
+}
+
+#endif /* SAMPLER_BENCHMARK */
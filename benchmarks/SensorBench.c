@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== SensorBench.c ========
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/ADC.h>
+#include <ti/drivers/NVS.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Bench.h"
+#include "Board.h"
+#include "Energy.h"
+#include "Log.h"
+#include "Pipeline.h"
+#include "Prof.h"
+
+#if (SENSOR_PIPELINE)
+
+#define SENSOR_SECONDS      10
+
+/* 200 Hz, one record every 80 ms */
+#define SENSOR_PERIOD_US    5000
+#define SENSOR_SAMPLES      16
+#define SENSOR_RECORDS      8
+
+/* Summary log, offsets 0x6000 to 0x9fff (pages 0x8000 to 0xb000) */
+#define SENSOR_LOG_BASE     0x6000
+#define SENSOR_LOG_SIZE     0x4000
+
+/* What the process stage leaves of a record, and the store stage writes */
+typedef struct SensorSummary {
+    uint32_t seq;
+    uint32_t timestamp;
+    uint16_t min;
+    uint16_t max;
+    uint32_t meanMicroVolts;
+} SensorSummary;
+
+static ADC_Handle        sensorAdc;
+static NVS_Handle        sensorNvs;
+static uint32_t          sensorSectorSize;
+static uint32_t          sensorLogPos;
+static ClockP_Struct     sensorClock;
+static SemaphoreP_Struct sensorTick;
+
+static Pipeline_Object   sensorPipelineObject;
+static uint8_t           sensorRecordBuf[SENSOR_RECORDS]
+                                        [SENSOR_SAMPLES * sizeof(uint16_t)];
+static StaticThread_STACK(sensorAcquireStack, 768);
+static StaticThread_STACK(sensorProcessStack, 768);
+static StaticThread_STACK(sensorStoreStack, 1024);
+
+static bool sensorAcquire(Pipeline_Record *record, void *arg);
+static bool sensorProcess(Pipeline_Record *record, void *arg);
+static bool sensorStore(Pipeline_Record *record, void *arg);
+
+/* Sampling has the highest priority, so flash writes cannot delay it */
+static const Pipeline_Stage sensorStages[] = {
+    {"acquire", sensorAcquire, NULL, 4, sensorAcquireStack,
+        sizeof(sensorAcquireStack), 4},
+    {"process", sensorProcess, NULL, 3, sensorProcessStack,
+        sizeof(sensorProcessStack), 4},
+    {"store",   sensorStore,   NULL, 2, sensorStoreStack,
+        sizeof(sensorStoreStack), 0},
+};
+
+static const Pipeline_Config sensorPipelineConfig = {
+    sensorStages,
+    sizeof(sensorStages) / sizeof(sensorStages[0]),
+    SENSOR_RECORDS,
+    sizeof(sensorRecordBuf[0]),
+    &sensorRecordBuf[0][0],
+};
+
+/*
+ *  ======== sensorTickFxn ========
+ *  Counting, so that a late acquisition stage catches up on missed ticks.
+ */
+static void sensorTickFxn(uintptr_t arg)
+{
+    SemaphoreP_post(&sensorTick);
+}
+
+/*
+ *  ======== sensorAcquire ========
+ *  Fills the record with SENSOR_SAMPLES raw ADC values.
+ */
+static bool sensorAcquire(Pipeline_Record *record, void *arg)
+{
+    uint16_t *samples = (uint16_t *)record->data;
+    int       i;
+
+    for (i = 0; i < SENSOR_SAMPLES; i++) {
+        SemaphoreP_pend(&sensorTick, SemaphoreP_WAIT_FOREVER);
+        if (ADC_convert(sensorAdc, &samples[i]) != ADC_STATUS_SUCCESS) {
+            return (false);
+        }
+    }
+    record->length = SENSOR_SAMPLES * sizeof(uint16_t);
+
+    return (true);
+}
+
+/*
+ *  ======== sensorProcess ========
+ *  Replaces the samples by their SensorSummary, in place.
+ */
+static bool sensorProcess(Pipeline_Record *record, void *arg)
+{
+    const uint16_t *samples = (const uint16_t *)record->data;
+    SensorSummary   summary;
+    uint32_t        sum = 0;
+    int             i;
+
+    summary.seq       = record->seq;
+    summary.timestamp = record->timestamp;
+    summary.min       = 0xffff;
+    summary.max       = 0;
+
+    for (i = 0; i < SENSOR_SAMPLES; i++) {
+        if (samples[i] < summary.min) {
+            summary.min = samples[i];
+        }
+        if (samples[i] > summary.max) {
+            summary.max = samples[i];
+        }
+        sum += samples[i];
+    }
+    summary.meanMicroVolts = ADC_convertToMicroVolts(sensorAdc,
+            (uint16_t)(sum / SENSOR_SAMPLES));
+
+    memcpy(record->data, &summary, sizeof(summary));
+    record->length = sizeof(summary);
+
+    return (true);
+}
+
+/*
+ *  ======== sensorStore ========
+ *  Appends the summary to the log, erasing each sector when it is entered.
+ */
+static bool sensorStore(Pipeline_Record *record, void *arg)
+{
+    uint_fast16_t flags = NVS_WRITE_POST_VERIFY;
+    int_fast16_t  status;
+
+    if ((sensorLogPos % sensorSectorSize) == 0) {
+        flags |= NVS_WRITE_ERASE;
+    }
+
+    Energy_begin(EnergyOp_NVS_LOG);
+    Prof_SCOPE(ProfSite_NVS_LOG,
+            status = NVS_write(sensorNvs, SENSOR_LOG_BASE + sensorLogPos,
+                    record->data, record->length, flags));
+    Energy_end(EnergyOp_NVS_LOG);
+    if (status != NVS_STATUS_SUCCESS) {
+        Log_error1(LogMod_NVS, "Cannot log at offset 0x%x",
+                SENSOR_LOG_BASE + sensorLogPos);
+        return (false);
+    }
+
+    sensorLogPos += sizeof(SensorSummary);
+    if (sensorLogPos >= SENSOR_LOG_SIZE) {
+        sensorLogPos = 0;
+    }
+
+    return (true);
+}
+
+/*
+ *  ======== sensorReport ========
+ *  Prints the rates since the previous report @p prev.
+ */
+static void sensorReport(Display_Handle displayHandle,
+                         const Pipeline_Stats *stats,
+                         const Pipeline_Stats *prev)
+{
+    uint32_t ticks = stats->ticks - prev->ticks;
+    uint32_t avg = 0;
+    int      i;
+
+    if (stats->latencyCount != 0) {
+        avg = stats->latencyTotal / stats->latencyCount;
+    }
+
+    Display_printf(displayHandle, 0, 0,
+            "Pipeline %u ms: latency %u/%u/%u us, %u overruns",
+            stats->ticks * ClockP_tickPeriod / 1000,
+            stats->latencyMin * ClockP_tickPeriod, avg * ClockP_tickPeriod,
+            stats->latencyMax * ClockP_tickPeriod, stats->overruns);
+
+    for (i = 0; i < stats->stageCount; i++) {
+        Display_printf(displayHandle, 0, 0,
+                "  %s: %u rec/s, %u%% busy, %u dropped, %u full",
+                sensorStages[i].name,
+                (stats->stages[i].records - prev->stages[i].records) *
+                    (1000000 / ClockP_tickPeriod) / ticks,
+                (stats->stages[i].busyTicks - prev->stages[i].busyTicks) *
+                    100 / ticks,
+                stats->stages[i].dropped, stats->stages[i].fullWaits);
+    }
+
+    for (i = 0; i + 1 < stats->stageCount; i++) {
+        Display_printf(displayHandle, 0, 0, "  queue %d: %u of %u, max %u",
+                i, stats->queues[i].count, stats->queues[i].depth,
+                stats->queues[i].highWater);
+    }
+    Display_printf(displayHandle, 0, 0, "  pool: %u free of %u, max used %u",
+            stats->pool.count, stats->pool.depth, stats->pool.highWater);
+}
+
+/*
+ *  ======== SensorBench_run ========
+ *  Runs the pipeline for SENSOR_SECONDS.
+ */
+void SensorBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    SemaphoreP_Params semParams;
+    ClockP_Params     clockParams;
+    NVS_Attrs         regionAttrs;
+    Pipeline_Stats    stats[2];
+    uint32_t          period;
+    int               i;
+
+    ADC_init();
+    sensorAdc = ADC_open(Board_ADC0, NULL);
+    if (sensorAdc == NULL) {
+        Log_error0(LogMod_APP, "ADC_open() failed.");
+        return;
+    }
+
+    NVS_getAttrs(nvsHandle, &regionAttrs);
+    sensorNvs        = nvsHandle;
+    sensorSectorSize = regionAttrs.sectorSize;
+    sensorLogPos     = 0;
+
+    SemaphoreP_Params_init(&semParams);
+    semParams.mode = SemaphoreP_Mode_COUNTING;
+    SemaphoreP_construct(&sensorTick, 0, &semParams);
+
+    period = SENSOR_PERIOD_US / ClockP_tickPeriod;
+    ClockP_Params_init(&clockParams);
+    clockParams.period    = period;
+    clockParams.startFlag = true;
+    ClockP_construct(&sensorClock, sensorTickFxn, period, &clockParams);
+
+    if (!Pipeline_start(&sensorPipelineObject, &sensorPipelineConfig)) {
+        Log_error0(LogMod_APP, "Pipeline_start() failed.");
+    }
+    else {
+        memset(&stats[0], 0, sizeof(stats[0]));
+        for (i = 1; i <= SENSOR_SECONDS; i++) {
+            sleep(1);
+            Pipeline_getStats(&sensorPipelineObject, &stats[i & 1]);
+            sensorReport(displayHandle, &stats[i & 1], &stats[(i - 1) & 1]);
+        }
+        Pipeline_stop(&sensorPipelineObject);
+    }
+
+    ClockP_stop(&sensorClock);
+    ClockP_destruct(&sensorClock);
+    SemaphoreP_destruct(&sensorTick);
+    ADC_close(sensorAdc);
+}
+
+#endif /* SENSOR_PIPELINE */
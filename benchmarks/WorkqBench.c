@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== WorkqBench.c ========
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/SwiP.h>
+#include <ti/drivers/timer/GPTimerCC26XX.h>
+
+#include "Bench.h"
+#include "Board.h"
+#include "Log.h"
+#include "WorkQueue.h"
+
+#if (WORKQ_BENCHMARK)
+
+#define WORKQ_RATE_HZ       10000
+
+/* Deferred work of the synthetic drivers */
+#define WORKQ_FLUSH         0
+#define WORKQ_SAMPLE        1
+#define WORKQ_DEBOUNCE      2
+#define WORKQ_EVENTS        3
+
+/* Each interrupt asks for a flush twice, as two log records would */
+static const uint8_t workqStorm[] = {
+    WORKQ_FLUSH, WORKQ_SAMPLE, WORKQ_FLUSH, WORKQ_DEBOUNCE
+};
+
+static SwiP_Struct       workqSwis[WORKQ_EVENTS];
+static WorkQueue_Item    workqItems[WORKQ_EVENTS];
+static volatile bool     workqBatched;
+static volatile uint32_t workqInterrupts;
+static volatile uint32_t workqSwiRuns;
+static volatile uint32_t workqCalls;
+
+/*
+ *  ======== workqWorkFxn ========
+ */
+static void workqWorkFxn(uintptr_t arg)
+{
+    workqCalls++;
+}
+
+/*
+ *  ======== workqSwiFxn ========
+ *  One Swi per event, as the drivers have.
+ */
+static void workqSwiFxn(uintptr_t arg0, uintptr_t arg1)
+{
+    workqSwiRuns++;
+    workqWorkFxn(arg0);
+}
+
+/*
+ *  ======== workqTimerFxn ========
+ */
+static void workqTimerFxn(GPTimerCC26XX_Handle handle,
+                          GPTimerCC26XX_IntMask interruptMask)
+{
+    unsigned int i;
+
+    for (i = 0; i < sizeof(workqStorm); i++) {
+        if (workqBatched) {
+            WorkQueue_post(&workqItems[workqStorm[i]]);
+        }
+        else {
+            SwiP_post(&workqSwis[workqStorm[i]]);
+        }
+    }
+    workqInterrupts++;
+}
+
+/*
+ *  ======== workqIdle ========
+ *  Passes through an empty loop in one second, which is what the
+ *  interrupts and Swis leave to mainThread.
+ */
+static uint32_t workqIdle(void)
+{
+    uint32_t end = ClockP_getSystemTicks() + 1000000 / ClockP_tickPeriod;
+    uint32_t count = 0;
+
+    while ((int32_t)(ClockP_getSystemTicks() - end) < 0) {
+        count++;
+    }
+
+    return (count);
+}
+
+/*
+ *  ======== workqRun ========
+ *  One second of the storm. The load is the share of the idle loop lost
+ *  against @p baseline.
+ */
+static void workqRun(Display_Handle displayHandle,
+                     GPTimerCC26XX_Handle timer, bool batched,
+                     uint32_t baseline)
+{
+    WorkQueue_Stats before;
+    WorkQueue_Stats after;
+    uint32_t        idle;
+    uint32_t        runs;
+    uint32_t        load;
+
+    workqBatched    = batched;
+    workqInterrupts = 0;
+    workqSwiRuns    = 0;
+    workqCalls      = 0;
+    WorkQueue_getStats(&before);
+
+    GPTimerCC26XX_start(timer);
+    idle = workqIdle();
+    GPTimerCC26XX_stop(timer);
+
+    WorkQueue_getStats(&after);
+    runs = batched ? after.runs - before.runs : workqSwiRuns;
+    load = (idle < baseline) ? (baseline - idle) * 1000 / baseline : 0;
+
+    Display_printf(displayHandle, 0, 0,
+            "%s: %u interrupts, %u Swi runs, %u calls, load %u.%u%%",
+            batched ? "WorkQueue" : "Swi per event", workqInterrupts, runs,
+            workqCalls, load / 10, load % 10);
+    if (batched) {
+        Display_printf(displayHandle, 0, 0,
+                "  %u posts, %u coalesced, max batch %u",
+                after.posts - before.posts,
+                after.coalesced - before.coalesced, after.maxBatch);
+    }
+}
+
+/*
+ *  ======== WorkqBench_run ========
+ */
+void WorkqBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    GPTimerCC26XX_Params timerParams;
+    GPTimerCC26XX_Handle timer;
+    SwiP_Params          swiParams;
+    ClockP_FreqHz        freq;
+    uint32_t             baseline;
+    int                  i;
+
+    for (i = 0; i < WORKQ_EVENTS; i++) {
+        SwiP_Params_init(&swiParams);
+        swiParams.arg0 = i;
+        SwiP_construct(&workqSwis[i], workqSwiFxn, &swiParams);
+        WorkQueue_Item_init(&workqItems[i], workqWorkFxn, i);
+    }
+
+    GPTimerCC26XX_Params_init(&timerParams);
+    timerParams.width = GPT_CONFIG_32BIT;
+    timerParams.mode  = GPT_MODE_PERIODIC_UP;
+    timer = GPTimerCC26XX_open(Board_GPTIMER0A, &timerParams);
+    if (timer == NULL) {
+        Log_error0(LogMod_APP, "GPTimerCC26XX_open() failed.");
+    }
+    else {
+        ClockP_getCpuFreq(&freq);
+        GPTimerCC26XX_setLoadValue(timer, freq.lo / WORKQ_RATE_HZ - 1);
+        GPTimerCC26XX_registerInterrupt(timer, workqTimerFxn,
+                GPT_INT_TIMEOUT);
+
+        baseline = workqIdle();
+        workqRun(displayHandle, timer, false, baseline);
+        workqRun(displayHandle, timer, true, baseline);
+
+        GPTimerCC26XX_close(timer);
+    }
+
+    for (i = 0; i < WORKQ_EVENTS; i++) {
+        SwiP_destruct(&workqSwis[i]);
+    }
+}
+
+#endif /* WORKQ_BENCHMARK */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019 Mahir Hasan
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Distributed under the MIT License, see the LICENSE file at the top of
+ * this repository.
+ */
+
+/*
+ *  ======== XoscBench.c ========
+ */
+
+#include <stdint.h>
+
+#include <ti/display/Display.h>
+#include <ti/drivers/dpl/ClockP.h>
+#include <ti/drivers/dpl/SemaphoreP.h>
+
+#include "Bench.h"
+#include "Energy.h"
+#include "XoscHf.h"
+
+#if (XOSC_BENCHMARK)
+
+#define XOSC_SECONDS        30
+#define XOSC_PERIOD_MS      1000
+
+/* Stands for a short packet sent or received */
+#define XOSC_COMMAND_US     2000
+
+typedef enum XoscMode {
+    XoscMode_ALWAYS,     /* Held throughout, as with xoscHfAlwaysNeeded */
+    XoscMode_DEMAND,     /* Started by the command */
+    XoscMode_PREDICTED   /* Started ahead of the command */
+} XoscMode;
+
+static const char *const xoscModeNames[] = {"Always", "Demand", "Predicted"};
+
+static ClockP_Struct     xoscClock;
+static SemaphoreP_Struct xoscTick;
+
+/*
+ *  ======== xoscClockFxn ========
+ */
+static void xoscClockFxn(uintptr_t arg)
+{
+    SemaphoreP_post(&xoscTick);
+}
+
+/*
+ *  ======== xoscRun ========
+ *  Runs a command every XOSC_PERIOD_MS for XOSC_SECONDS, and prints what
+ *  Energy estimates for it and how long the commands waited.
+ */
+static void xoscRun(Display_Handle displayHandle, XoscMode mode)
+{
+    Energy_States before;
+    Energy_States after;
+    XoscHf_Stats  stats;
+    uint64_t      charge;
+    uint64_t      ticks;
+    uint32_t      current;
+    uint32_t      next;
+    int32_t       left;
+    uint32_t      period = XOSC_PERIOD_MS * 1000 / ClockP_tickPeriod;
+    uint32_t      i;
+
+    if (mode == XoscMode_ALWAYS) {
+        XoscHf_acquire();
+    }
+    XoscHf_resetStats();
+    Energy_getStates(&before);
+    charge = Energy_getCharge();
+
+    next = ClockP_getSystemTicks() + period;
+    ClockP_start(&xoscClock);
+
+    for (i = 0; i < XOSC_SECONDS * 1000 / XOSC_PERIOD_MS; i++) {
+        SemaphoreP_pend(&xoscTick, SemaphoreP_WAIT_FOREVER);
+        next += period;
+
+        XoscHf_acquire();
+        ClockP_usleep(XOSC_COMMAND_US);
+        XoscHf_release();
+
+        if (mode == XoscMode_PREDICTED) {
+            left = (int32_t)(next - ClockP_getSystemTicks());
+            XoscHf_schedule((left > 0) ? (uint32_t)left * ClockP_tickPeriod :
+                    0);
+        }
+    }
+
+    ClockP_stop(&xoscClock);
+
+    charge = Energy_getCharge() - charge;
+    Energy_getStates(&after);
+    XoscHf_getStats(&stats);
+    if (mode == XoscMode_ALWAYS) {
+        XoscHf_release();
+    }
+
+    ticks = after.total - before.total;
+    current = (uint32_t)(charge * Energy_TICKS_PER_SEC / ticks);
+
+    Display_printf(displayHandle, 0, 0,
+            "%s: %u.%03u uA, %u wakeups, %u of %u commands waited, "
+            "%u us average, %u us max", xoscModeNames[mode],
+            current / 1000, current % 1000, after.wakeups - before.wakeups,
+            stats.late, stats.acquires,
+            stats.acquires ? stats.latencyTotalUs / stats.acquires : 0,
+            stats.latencyMaxUs);
+    Display_printf(displayHandle, 0, 0,
+            "  startup %u us (max %u), %u starts, %u ahead, %u unused",
+            stats.startupUs, stats.startupMaxUs, stats.starts,
+            stats.predicted, stats.unused);
+}
+
+/*
+ *  ======== XoscBench_run ========
+ */
+void XoscBench_run(Display_Handle displayHandle, NVS_Handle nvsHandle)
+{
+    ClockP_Params clockParams;
+    uint32_t      period = XOSC_PERIOD_MS * 1000 / ClockP_tickPeriod;
+
+    SemaphoreP_constructBinary(&xoscTick, 0);
+    ClockP_Params_init(&clockParams);
+    clockParams.period = period;
+    ClockP_construct(&xoscClock, xoscClockFxn, period, &clockParams);
+
+    /* The first startups teach XoscHf the startup time */
+    xoscRun(displayHandle, XoscMode_DEMAND);
+    xoscRun(displayHandle, XoscMode_PREDICTED);
+    xoscRun(displayHandle, XoscMode_ALWAYS);
+
+    ClockP_destruct(&xoscClock);
+    SemaphoreP_destruct(&xoscTick);
+}
+
+#endif /* XOSC_BENCHMARK */
@@ -36,59 +36,105 @@
  */
 #include <stdint.h>
 
-/* POSIX Header files */
-#include <pthread.h>
-
 /* RTOS header files */
 #include <ti/sysbios/BIOS.h>
 
 /* Example/Board Header files */
 #include "Board.h"
+#include "CpuLoad.h"
+#include "Energy.h"
+#include "Prof.h"
+#include "Sampler.h"
+#include "StackCheck.h"
+#include "StaticThread.h"
+#include "Supervisor.h"
+#include "WorkQueue.h"
+#include "XoscHf.h"
 
 extern void *mainThread(void *arg0);
 
-/* Stack size in bytes */
+/* Stack size in bytes, see StackCheck_print() for the recommended size */
+#ifndef THREADSTACKSIZE
 #define THREADSTACKSIZE    1024
+#endif
+
+/* Set to 1 to log the CPU load of every thread once a second */
+#ifndef CPULOAD_LOG
+#define CPULOAD_LOG        0
+#endif
+
+/*
+ * Set to a rate such as 1000 to sample the program counter, in a build with
+ * Sampler_ENABLE=1, see Sampler.h
+ */
+#ifndef SAMPLER_RATE_HZ
+#define SAMPLER_RATE_HZ    0
+#endif
+
+#if (SAMPLER_RATE_HZ) && !(Sampler_ENABLE)
+#error "SAMPLER_RATE_HZ needs Sampler_ENABLE=1"
+#endif
+
+static StaticThread_STACK(mainThreadStack, THREADSTACKSIZE);
+
+/*
+ * Threads started before the kernel. Objects and stacks are static, so their
+ * RAM shows in the map file and nothing is taken from the heap.
+ */
+static const StaticThread_Config threadConfig[] = {
+    {"main", mainThread, NULL, 1, mainThreadStack, sizeof(mainThreadStack)},
+};
+
+#define THREADCOUNT (sizeof(threadConfig) / sizeof(threadConfig[0]))
+
+static StaticThread_Struct threads[THREADCOUNT];
 
 /*
  *  ======== main ========
  */
 int main(void)
 {
-    pthread_t           thread;
-    pthread_attr_t      attrs;
-    struct sched_param  priParam;
-    int                 retc;
-    int                 detachState;
+    unsigned int i;
+
+    /* Before any profiled code can run */
+    Prof_init();
 
     /* Call driver init functions */
     Board_initGeneral();
 
-    /* Set priority and stack size attributes */
-    pthread_attr_init(&attrs);
-    priParam.sched_priority = 1;
+    /* Deferred work of the drivers, before any of them is opened */
+    WorkQueue_init();
 
-    detachState = PTHREAD_CREATE_DETACHED;
-    retc = pthread_attr_setdetachstate(&attrs, detachState);
-    if (retc != 0) {
-        /* pthread_attr_setdetachstate() failed */
-        while (1);
+    for (i = 0; i < THREADCOUNT; i++) {
+        if (!StaticThread_construct(&threads[i], &threadConfig[i])) {
+            /* StaticThread_construct() failed */
+            while (1);
+        }
     }
 
-    pthread_attr_setschedparam(&attrs, &priParam);
+    /* Keep the peaks in StackCheck_usage current for the debugger */
+    StackCheck_start(1000);
 
-    retc |= pthread_attr_setstacksize(&attrs, THREADSTACKSIZE);
-    if (retc != 0) {
-        /* pthread_attr_setstacksize() failed */
-        while (1);
-    }
+    /* Needs the kernel hooks listed in CpuLoad.h */
+    CpuLoad_start(1000, CPULOAD_LOG);
+
+    /* Needs the kernel hook listed in Energy.h */
+    Energy_start();
 
-    retc = pthread_create(&thread, &attrs, mainThread, NULL);
-    if (retc != 0) {
-        /* pthread_create() failed */
+    /* The crystal is started ahead of radio commands, see XoscHf.h */
+    XoscHf_init();
+
+    /* Well below the 1 s reload of the watchdog */
+    if (!Supervisor_start(250)) {
+        /* Supervisor_start() failed */
         while (1);
     }
 
+#if (SAMPLER_RATE_HZ)
+    /* Printed by mainThread once the example has run */
+    Sampler_start(SAMPLER_RATE_HZ);
+#endif
+
     BIOS_start();
 
     return (0);
@@ -0,0 +1,65 @@
+"""Consistent Overhead Byte Stuffing, matching Cobs.c on the device."""
+
+DELIMITER = 0
+
+
+def encode(data):
+    """Encode bytes; the result contains no zero byte and no delimiter."""
+    out = bytearray(1)
+    code_idx = 0
+    code = 1
+    for byte in data:
+        if byte == 0:
+            out[code_idx] = code
+            code_idx = len(out)
+            out.append(0)
+            code = 1
+        else:
+            out.append(byte)
+            code += 1
+            if code == 0xFF:
+                out[code_idx] = code
+                code_idx = len(out)
+                out.append(0)
+                code = 1
+    out[code_idx] = code
+    return bytes(out)
+
+
+def decode(data):
+    """Decode one packet without delimiters; returns None if malformed."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        block = data[i:i + code - 1]
+        if 0 in block:
+            return None
+        out += block
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def split_stream(chunks):
+    """Split a byte stream on delimiters.
+
+    Yields the bytes between delimiters, which are either COBS packets or
+    plain text that was interleaved with them. Empty pieces are skipped.
+    """
+    pending = bytearray()
+    for chunk in chunks:
+        pending += chunk
+        while True:
+            end = pending.find(DELIMITER)
+            if end < 0:
+                break
+            if end > 0:
+                yield bytes(pending[:end])
+            del pending[:end + 1]
+    if pending:
+        yield bytes(pending)
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Fetch a compressed dump of an NVS region, see FlashDump.h and RemoteCmd.h.
+
+    flashdump.py --port /dev/ttyACM0 -o internal.bin
+    flashdump.py --port /dev/ttyACM0 --region 1 -o external.bin
+    flashdump.py --port /dev/ttyACM0 --offset 0x10000 --length 0x1000 -o a.bin
+
+Region 0 is the internal flash region and region 1 the external SPI flash.
+The reassembled image is checked against the CRC computed by the device.
+
+Requires pyserial.
+"""
+
+import argparse
+import sys
+import time
+
+import remotecmd
+
+TOKEN_ERASED = 0x80
+TOKEN_MATCH = 0xC0
+MATCH_MIN = 4
+
+
+class Error(Exception):
+    pass
+
+
+def decompress(block):
+    """Decode one block produced by FlashDump_next()."""
+    out = bytearray()
+    i = 0
+    while i < len(block):
+        token = block[i]
+        i += 1
+        if token < TOKEN_ERASED:
+            count = token + 1
+            if i + count > len(block):
+                raise Error("literal past end of block")
+            out += block[i:i + count]
+            i += count
+        elif token == TOKEN_ERASED:
+            run = 0
+            shift = 0
+            while True:
+                if i >= len(block):
+                    raise Error("erased run past end of block")
+                byte = block[i]
+                i += 1
+                run |= (byte & 0x7F) << shift
+                shift += 7
+                if not byte & 0x80:
+                    break
+            out += b"\xff" * run
+        elif token >= TOKEN_MATCH:
+            if i + 2 > len(block):
+                raise Error("copy past end of block")
+            count = (token & 0x3F) + MATCH_MIN
+            distance = block[i] | block[i + 1] << 8
+            i += 2
+            if distance == 0 or distance > len(out):
+                raise Error("copy from before start of block")
+            # Copies may overlap their own output
+            for _ in range(count):
+                out.append(out[-distance])
+        else:
+            raise Error("unknown token 0x%02x" % token)
+    return bytes(out)
+
+
+def reassemble(blocks, offset):
+    """Join (offset, block) pairs that start at offset into one image."""
+    image = bytearray()
+    for block_offset, block in blocks:
+        if block_offset != offset + len(image):
+            raise Error("block at 0x%x missing" % (offset + len(image)))
+        image += decompress(block)
+    return bytes(image)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", required=True, help="serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--rx-buffer", type=remotecmd.number,
+                        default=remotecmd.RX_BUFFER,
+                        help="BOARD_UART_RX_BUF_SIZE of the device")
+    parser.add_argument("--region", type=int, default=0,
+                        help="0 internal, 1 external flash")
+    parser.add_argument("--offset", type=remotecmd.number, default=0)
+    parser.add_argument("--length", type=remotecmd.number, default=0,
+                        help="bytes to dump, 0 for the rest of the region")
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    with remotecmd.Client.open(args.port, args.baud,
+                               rx_buffer=args.rx_buffer) as client:
+        start = time.monotonic()
+        blocks, length, crc = client.dumpz(args.region, args.offset,
+                                           args.length)
+        seconds = time.monotonic() - start
+
+    wire = sum(len(block) for _, block in blocks)
+    image = reassemble(blocks, args.offset)
+    if len(image) != length:
+        raise Error("got %d bytes, device sent %d" % (len(image), length))
+    if remotecmd.crc16(image) != crc:
+        raise Error("CRC mismatch")
+
+    with open(args.output, "wb") as f:
+        f.write(image)
+
+    print("%d bytes in %.2f s, %d compressed (%.1f%%)" %
+          (len(image), seconds, wire, 100.0 * wire / max(1, len(image))))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Decode the binary log stream produced by Log.c.
+
+Format strings are read from the .log_fmt section of the application ELF
+file, which is never loaded onto the device. Text written through the
+Display driver is passed through unchanged.
+
+    logdecode.py app.out --port /dev/ttyACM0
+    logdecode.py app.out --file capture.bin
+
+Requires pyelftools, and pyserial when reading from a port.
+"""
+
+import argparse
+import re
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+import cobs
+
+FRAME_TYPE = 0x4C
+FMT_SECTION = ".log_fmt"
+
+SPEC = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|t)?([diuxXcspo%])")
+
+# Level and module prefix added by the leveled Log statements
+TAG = re.compile(r"^([EWID])\|LogMod_(\w+)\|")
+
+
+class Image:
+    """Format strings and flash contents of an ELF file."""
+
+    def __init__(self, path):
+        self.tokens = {}
+        self.segments = []
+        with open(path, "rb") as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                addr = section["sh_addr"]
+                if section.name == FMT_SECTION:
+                    self._load_tokens(addr, section.data())
+                elif section["sh_type"] == "SHT_PROGBITS" and addr:
+                    self.segments.append((addr, section.data()))
+
+    def _load_tokens(self, base, data):
+        offset = 0
+        while offset < len(data):
+            end = data.find(b"\0", offset)
+            if end < 0:
+                end = len(data)
+            if end > offset:
+                token = (base + offset) & 0xFFFF
+                if token in self.tokens:
+                    raise ValueError(".log_fmt is larger than 64 KB")
+                self.tokens[token] = data[offset:end].decode("ascii", "replace")
+            offset = end + 1
+
+    def string_at(self, addr):
+        for base, data in self.segments:
+            if base <= addr < base + len(data):
+                end = data.find(b"\0", addr - base)
+                return data[addr - base:end].decode("ascii", "replace")
+        return "<0x%08x>" % addr
+
+
+def varints(data):
+    value = 0
+    shift = 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            yield value
+            value = 0
+            shift = 0
+
+
+def render(image, fmt, args):
+    args = list(args)
+
+    def substitute(match):
+        flags, _, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if not args:
+            return "<missing>"
+        value = args.pop(0) & 0xFFFFFFFF
+        if conv in "di":
+            value -= (value & 0x80000000) << 1
+        elif conv == "c":
+            value = chr(value & 0xFF)
+        elif conv == "s":
+            value = image.string_at(value)
+        elif conv == "p":
+            conv = "x"
+            flags = "#" + flags
+        return ("%" + flags + conv) % value
+
+    return SPEC.sub(substitute, fmt)
+
+
+def decode_record(image, packet):
+    """Return the message of a log record packet, or None if it is not one."""
+    if len(packet) < 4 or packet[0] != FRAME_TYPE:
+        return None
+    token = packet[2] | (packet[3] << 8)
+    fmt = image.tokens.get(token)
+    if fmt is None:
+        return None
+    prefix = ""
+    tag = TAG.match(fmt)
+    if tag:
+        prefix = "%s/%s: " % tag.groups()
+        fmt = fmt[tag.end():]
+    return packet[1], prefix + render(image, fmt, varints(packet[4:]))
+
+
+def decode_stream(image, chunks, out):
+    last_seq = None
+    for piece in cobs.split_stream(chunks):
+        packet = cobs.decode(piece)
+        record = decode_record(image, packet) if packet else None
+        if record is None:
+            out.write(piece.decode("ascii", "replace"))
+            continue
+        seq, message = record
+        if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+            out.write("<%d records lost>\n" % ((seq - last_seq - 1) & 0xFF))
+        last_seq = seq
+        out.write(message + "\n")
+        out.flush()
+
+
+def read_port(port, baud):
+    import serial
+
+    with serial.Serial(port, baud, timeout=0.1) as ser:
+        while True:
+            yield ser.read(4096)
+
+
+def read_file(path):
+    with open(path, "rb") as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="application ELF file (.out)")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port to read from")
+    source.add_argument("--file", help="captured stream to decode")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    image = Image(args.elf)
+    if args.port:
+        chunks = read_port(args.port, args.baud)
+    else:
+        chunks = read_file(args.file)
+
+    try:
+        decode_stream(image, chunks, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Map the program counter samples of Sampler.c to functions of the ELF file.
+
+Reads the text printed by Sampler_print(), from a capture or from the
+output of logdecode.py:
+
+    logdecode.py app.out --port /dev/ttyACM0 | tee run.txt
+    pcsample.py app.out run.txt
+    pcsample.py app.out run.txt --folded > run.folded
+
+The default report lists the functions with the most samples. --folded
+writes one "function count" line per function, the input format of
+flamegraph.pl and speedscope. Only the last table of the input is used.
+
+Requires pyelftools.
+"""
+
+import argparse
+import bisect
+import re
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+BEGIN = re.compile(r"pc begin (\d+) samples (\d+) outside (\d+) lost")
+SAMPLE = re.compile(r"pc (0x[0-9a-fA-F]+) (\d+)")
+END = "pc end"
+
+
+class Symbols:
+    """Function symbols of an ELF file, looked up by address."""
+
+    def __init__(self, path):
+        funcs = {}
+        with open(path, "rb") as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                if not isinstance(section, SymbolTableSection):
+                    continue
+                for sym in section.iter_symbols():
+                    if sym["st_info"]["type"] != "STT_FUNC" or not sym.name:
+                        continue
+                    # Thumb functions have bit 0 set
+                    addr = sym["st_value"] & ~1
+                    funcs.setdefault(addr, (sym.name, sym["st_size"]))
+        self.addrs = sorted(funcs)
+        self.funcs = [funcs[addr] for addr in self.addrs]
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i >= 0:
+            name, size = self.funcs[i]
+            # Samples cover a granule, which may start before the function
+            if addr < self.addrs[i] + max(size, 1):
+                return name
+        return "<0x%08x>" % addr
+
+
+def parse(lines):
+    """Return the totals and address counts of the last complete table."""
+    table = None
+    current = None
+    for line in lines:
+        line = line.strip()
+        begin = BEGIN.search(line)
+        if begin:
+            current = ([int(n) for n in begin.groups()], [])
+            continue
+        if current is None:
+            continue
+        if line.endswith(END):
+            table = current
+            current = None
+            continue
+        sample = SAMPLE.search(line)
+        if sample:
+            current[1].append((int(sample.group(1), 16),
+                               int(sample.group(2))))
+    if table is None:
+        raise SystemExit("no complete 'pc begin' ... 'pc end' table found")
+    return table
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="application ELF file (.out)")
+    parser.add_argument("input", nargs="?", help="captured text, or stdin")
+    parser.add_argument("--folded", action="store_true",
+                        help="write folded stacks for flame graph tools")
+    parser.add_argument("--top", type=int, default=30,
+                        help="functions to list, 0 for all")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, errors="replace") as f:
+            (total, outside, lost), samples = parse(f)
+    else:
+        (total, outside, lost), samples = parse(sys.stdin)
+
+    symbols = Symbols(args.elf)
+    counts = {}
+    for addr, count in samples:
+        name = symbols.lookup(addr)
+        counts[name] = counts.get(name, 0) + count
+    if outside:
+        counts["<outside flash>"] = outside
+    if lost:
+        counts["<lost>"] = lost
+
+    ranked = sorted(counts.items(), key=lambda item: -item[1])
+    if args.folded:
+        for name, count in ranked:
+            print("%s %d" % (name, count))
+        return 0
+
+    print("%d samples" % total)
+    if args.top:
+        ranked = ranked[:args.top]
+    for name, count in ranked:
+        print("%6.2f%% %8d  %s" % (100.0 * count / max(1, total), count, name))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
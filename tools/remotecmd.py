@@ -0,0 +1,328 @@
+#!/usr/bin/env python3
+"""Client for the binary command protocol of RemoteCmd.c.
+
+    remotecmd.py --port /dev/ttyACM0 stats
+    remotecmd.py --port /dev/ttyACM0 read 0x10000 4
+    remotecmd.py --port /dev/ttyACM0 write 0x10000 f0ffffff --erase
+    remotecmd.py --port /dev/ttyACM0 erase 0x10000
+    remotecmd.py --port /dev/ttyACM0 dump 0 0x18000 -o region-{name}.bin
+
+--port may be given several times to run the same command on each device.
+Scripts can use the Client class directly:
+
+    with remotecmd.Client.open("/dev/ttyACM0") as dev:
+        value = dev.read(0x10000, 4)
+        dev.write_key(0x10000, b"\\xf0\\xff\\xff\\xff")
+
+Requires pyserial.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+import cobs
+
+REQUEST = 0x43
+RESPONSE = 0x52
+MAX_DATA = 256
+
+CMD_READ = 0x01
+CMD_WRITE = 0x02
+CMD_ERASE = 0x03
+CMD_STATS = 0x04
+CMD_DUMP = 0x05
+CMD_DUMPZ = 0x06
+
+WRITE_ERASE = 0x01
+
+STATUS_OK = 0x00
+STATUS_MORE = 0x01
+STATUS_NAMES = {
+    0x80: "unknown command",
+    0x81: "bad argument",
+    0x82: "NVS error",
+}
+
+# Order of the RemoteCmd_CMD_STATS results, see RemoteCmd_StatId
+STAT_NAMES = (
+    "frames",
+    "badFrames",
+    "splitFrames",
+    "rxBytes",
+    "rxInterrupts",
+    "rxOverruns",
+    "rxThrottled",
+    "txBytes",
+    "txDropped",
+)
+
+# Default receive buffer of the device, BOARD_UART_RX_BUF_SIZE
+RX_BUFFER = 1024
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE, matching Crc16.c."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021 if crc & 0x8000 else crc << 1) & 0xFFFF
+    return crc
+
+
+class Error(Exception):
+    pass
+
+
+class Client:
+    """Pipelined requests over a serial port or any stream with read/write.
+
+    Up to `window` requests are kept outstanding, limited further to half
+    of `rx_buffer`, the BOARD_UART_RX_BUF_SIZE of the device, so that a
+    device without flow control never has to buffer more than it can hold.
+    """
+
+    def __init__(self, stream, window=8, timeout=2.0, rx_buffer=RX_BUFFER):
+        self.stream = stream
+        self.window = window
+        self.timeout = timeout
+        self.max_inflight = rx_buffer // 2
+        self.seq = 0
+        self.pending = bytearray()
+
+    @classmethod
+    def open(cls, port, baud=115200, **kwargs):
+        import serial
+        return cls(serial.Serial(port, baud, timeout=0.05), **kwargs)
+
+    def close(self):
+        self.stream.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    # Transport
+
+    def _send(self, cmd, args):
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        packet = bytes([REQUEST, seq, cmd]) + args
+        packet += struct.pack("<H", crc16(packet))
+        frame = b"\0" + cobs.encode(packet) + b"\0"
+        self.stream.write(frame)
+        return seq, len(frame)
+
+    def _read_chunk(self):
+        waiting = getattr(self.stream, "in_waiting", 0)
+        return self.stream.read(max(1, waiting))
+
+    def _response(self):
+        """Next valid response; Log records and text are skipped."""
+        deadline = time.monotonic() + self.timeout
+        while True:
+            end = self.pending.find(cobs.DELIMITER)
+            if end >= 0:
+                piece = bytes(self.pending[:end])
+                del self.pending[:end + 1]
+                packet = cobs.decode(piece) if piece else None
+                if (packet and len(packet) >= 6 and packet[0] == RESPONSE and
+                        crc16(packet[:-2]) ==
+                        struct.unpack("<H", packet[-2:])[0]):
+                    return packet[1], packet[2], packet[3], packet[4:-2]
+                continue
+            if time.monotonic() > deadline:
+                raise Error("no response")
+            self.pending += self._read_chunk()
+
+    def _expect(self, seq, cmd):
+        rseq, rcmd, status, results = self._response()
+        if rseq != seq or rcmd != cmd:
+            raise Error("response %d/0x%02x out of order, expected %d/0x%02x"
+                        % (rseq, rcmd, seq, cmd))
+        if status not in (STATUS_OK, STATUS_MORE):
+            raise Error(STATUS_NAMES.get(status, "status 0x%02x" % status))
+        return status, results
+
+    def pipeline(self, requests):
+        """Send (cmd, args) requests and yield their results in order."""
+        requests = iter(requests)
+        inflight = []
+        inflight_bytes = 0
+        done = False
+        while True:
+            while not done and len(inflight) < self.window:
+                request = next(requests, None)
+                if request is None:
+                    done = True
+                    break
+                cmd, args = request
+                seq, size = self._send(cmd, args)
+                inflight.append((seq, cmd, size))
+                inflight_bytes += size
+                if inflight_bytes >= self.max_inflight:
+                    break
+            if not inflight:
+                return
+            seq, cmd, size = inflight.pop(0)
+            inflight_bytes -= size
+            yield self._expect(seq, cmd)[1]
+
+    # Commands
+
+    def read(self, offset, length):
+        chunks = [(CMD_READ, struct.pack("<IH", offset + i,
+                                         min(MAX_DATA, length - i)))
+                  for i in range(0, length, MAX_DATA)]
+        return b"".join(self.pipeline(chunks))
+
+    def write(self, offset, data):
+        """Program data that has already been erased."""
+        chunks = [(CMD_WRITE, struct.pack("<IB", offset + i, 0) +
+                   data[i:i + MAX_DATA])
+                  for i in range(0, len(data), MAX_DATA)]
+        for _ in self.pipeline(chunks):
+            pass
+
+    def write_key(self, offset, value, erase=True):
+        """Store one value, erasing its sector first by default."""
+        if len(value) > MAX_DATA:
+            raise Error("value longer than %d bytes" % MAX_DATA)
+        flags = WRITE_ERASE if erase else 0
+        list(self.pipeline([(CMD_WRITE, struct.pack("<IB", offset, flags) +
+                             value)]))
+
+    def erase(self, offset, length=1, sector_size=0x1000):
+        """Erase every sector overlapping [offset, offset + length)."""
+        first = offset - offset % sector_size
+        sectors = range(first, offset + length, sector_size)
+        for _ in self.pipeline((CMD_ERASE, struct.pack("<I", sector))
+                               for sector in sectors):
+            pass
+
+    def stats(self):
+        results = next(self.pipeline([(CMD_STATS, b"")]))
+        values = struct.unpack_from("<%dI" % results[0], results, 1)
+        names = STAT_NAMES + tuple("stat%d" % i for i in
+                                   range(len(STAT_NAMES), len(values)))
+        return dict(zip(names, values))
+
+    def dump(self, offset, length, progress=None):
+        seq, _ = self._send(CMD_DUMP, struct.pack("<II", offset, length))
+        data = bytearray()
+        while True:
+            status, results = self._expect(seq, CMD_DUMP)
+            if status == STATUS_OK:
+                break
+            chunk_offset = struct.unpack_from("<I", results)[0]
+            if chunk_offset != offset + len(data):
+                raise Error("dump chunk at 0x%x missing" %
+                            (offset + len(data)))
+            data += results[4:]
+            if progress:
+                progress(len(data), length)
+        return bytes(data)
+
+    def dumpz(self, region, offset, length=0):
+        """Compressed dump, see tools/flashdump.py.
+
+        Returns the (offset, block) pairs and the length and CRC-16 of the
+        data as reported by the device. A length of 0 dumps the rest of the
+        region.
+        """
+        seq, _ = self._send(CMD_DUMPZ, struct.pack("<BII", region, offset,
+                                                    length))
+        blocks = []
+        while True:
+            status, results = self._expect(seq, CMD_DUMPZ)
+            if status == STATUS_OK:
+                length, crc = struct.unpack("<IH", results)
+                return blocks, length, crc
+            blocks.append((struct.unpack_from("<I", results)[0],
+                           bytes(results[4:])))
+
+
+def number(text):
+    return int(text, 0)
+
+
+def run(client, args):
+    if args.command == "read":
+        return client.read(args.offset, args.length).hex()
+    if args.command == "write":
+        data = bytes.fromhex(args.data)
+        if args.erase:
+            client.write_key(args.offset, data)
+        else:
+            client.write(args.offset, data)
+        return "ok"
+    if args.command == "erase":
+        client.erase(args.offset, args.length)
+        return "ok"
+    if args.command == "stats":
+        return " ".join("%s=%d" % item for item in client.stats().items())
+    if args.command == "dump":
+        start = time.monotonic()
+        data = client.dump(args.offset, args.length)
+        seconds = time.monotonic() - start
+        name = os.path.basename(client.stream.port)
+        with open(args.output.format(name=name), "wb") as f:
+            f.write(data)
+        return "%d bytes in %.2f s" % (len(data), seconds)
+    raise Error("unknown command")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", action="append", required=True,
+                        help="serial port, may be repeated")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--window", type=int, default=8,
+                        help="requests kept outstanding")
+    parser.add_argument("--rx-buffer", type=number, default=RX_BUFFER,
+                        help="BOARD_UART_RX_BUF_SIZE of the device")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    cmd = commands.add_parser("read")
+    cmd.add_argument("offset", type=number)
+    cmd.add_argument("length", type=number)
+
+    cmd = commands.add_parser("write")
+    cmd.add_argument("offset", type=number)
+    cmd.add_argument("data", help="hex bytes")
+    cmd.add_argument("--erase", action="store_true",
+                     help="erase the sector first (single key only)")
+
+    cmd = commands.add_parser("erase")
+    cmd.add_argument("offset", type=number)
+    cmd.add_argument("length", type=number, nargs="?", default=1)
+
+    commands.add_parser("stats")
+
+    cmd = commands.add_parser("dump")
+    cmd.add_argument("offset", type=number)
+    cmd.add_argument("length", type=number)
+    cmd.add_argument("-o", "--output", default="dump-{name}.bin",
+                     help="file name, {name} is replaced by the port name")
+
+    args = parser.parse_args()
+
+    failed = False
+    for port in args.port:
+        try:
+            with Client.open(port, args.baud, window=args.window,
+                             rx_buffer=args.rx_buffer) as client:
+                print("%s: %s" % (port, run(client, args)))
+        except (Error, OSError) as e:
+            print("%s: %s" % (port, e), file=sys.stderr)
+            failed = True
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())